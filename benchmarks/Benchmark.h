@@ -0,0 +1,48 @@
+#pragma once
+
+#include <iomanip>
+#include <iostream>
+
+// A minimal timing harness for the benchmarks of the core library, which keeps them free of dependencies besides the standard library.
+namespace Benchmark
+{
+	// keeps the compiler from removing the computation of a result that is otherwise unused
+	template <class T>
+	void DoNotOptimize(const T& a_value) noexcept
+	{
+#if defined(_MSC_VER)
+		static const void* volatile sink;
+		sink = &a_value;
+#else
+		asm volatile("" : : "g"(&a_value) : "memory");
+#endif
+	}
+
+	// Calls a_function, which handles a_itemsPerCall items per call, until a_minDuration has passed,
+	// then prints and returns the mean time per item in nanoseconds.
+	template <class Function>
+	double Run(const std::string_view a_name, const std::size_t a_itemsPerCall, Function&& a_function, const std::chrono::milliseconds a_minDuration = 300ms)
+	{
+		using clock = std::chrono::steady_clock;
+		a_function();  // warms up the caches and the branch predictors
+
+		std::size_t numCalls = 0;
+		const auto start = clock::now();
+		auto elapsed = clock::duration::zero();
+		do {
+			a_function();
+			++numCalls;
+			elapsed = clock::now() - start;
+		} while (elapsed < a_minDuration);
+
+		const auto nanoseconds = std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(numCalls * a_itemsPerCall);
+		std::cout << "  " << std::left << std::setw(48) << a_name << std::right << std::fixed << std::setprecision(1) << std::setw(10) << nanoseconds << " ns\n";
+		return nanoseconds;
+	}
+
+	// prints how much faster a_new is than a_old
+	inline void PrintSpeedup(const double a_old, const double a_new)
+	{
+		std::cout << "  " << std::left << std::setw(48) << "speedup" << std::right << std::fixed << std::setprecision(2) << std::setw(10) << a_old / a_new << " x\n";
+	}
+}
\ No newline at end of file
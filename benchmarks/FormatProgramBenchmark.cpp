@@ -0,0 +1,99 @@
+/*
+Copyright (C) 2025 Jonathan Feenstra
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+See EXCEPTIONS for additional permissions.
+*/
+
+// Compares formatting topics with a compiled FormatProgram and a reused buffer against std::vformat,
+// which parsed the format string again and returned a new string for every topic and subtitle.
+
+#include "Benchmark.h"
+#include "FormatProgram.h"
+
+namespace
+{
+	// the default formats of the INI file, and one with format specs
+	constexpr std::array<std::string_view, 5> kFormats{
+		"{0} ({1} Level {3})",
+		"{0} ({1})",
+		"{0} (Bribe with {1})",
+		"{4}",
+		"{0} ({1} Level {3:.0f}/{5:.0f}: {2})",
+	};
+
+	// the formatting of the plugin before FormatProgram
+	std::string FormatWithVformat(const std::string& a_format, const FormatArguments& a_arguments)
+	{
+		// make_format_args only takes lvalues
+		auto mainText = a_arguments.mainText;
+		auto tagText = a_arguments.tagText;
+		auto resultText = a_arguments.resultText;
+		auto requiredSpeechLevel = a_arguments.requiredSpeechLevel;
+		auto predictedResponseText = a_arguments.predictedResponseText;
+		auto playerSpeechLevel = a_arguments.playerSpeechLevel;
+		return std::vformat(a_format, std::make_format_args(mainText, tagText, resultText, requiredSpeechLevel, predictedResponseText, playerSpeechLevel));
+	}
+}
+
+int main()
+{
+	// a dialogue list with dozens of tagged topics, as in menus of dialogue-heavy mod lists
+	std::vector<FormatArguments> topics;
+	for (std::uint32_t i = 0; i < 40; ++i) {
+		topics.push_back({ i % 2 ? "I think we both know I'll succeed here."sv : "You'd better tell me what I want to know."sv,
+			i % 3 ? "Persuade"sv : "Intimidate"sv,
+			i % 4 ? "Success"sv : "Failure"sv,
+			static_cast<float>(10 * (i % 10)),
+			"Fine, I'll tell you. The Thalmor have been watching you for a while."sv,
+			static_cast<float>(15 + i) });
+	}
+
+	for (const auto format : kFormats) {
+		const std::string formatString(format);
+		const FormatProgram program(format);
+		std::cout << "\"" << format << "\", " << topics.size() << " topics (time per topic):\n";
+
+		std::string buffer;
+		for (const auto& topic : topics) {
+			program.Format(buffer, topic);
+			if (buffer != FormatWithVformat(formatString, topic)) {
+				std::cerr << "Results differ: \"" << buffer << "\"\n";
+				return EXIT_FAILURE;
+			}
+		}
+
+		const auto vformatTime = Benchmark::Run("std::vformat", topics.size(), [&] {
+			for (const auto& topic : topics) {
+				Benchmark::DoNotOptimize(FormatWithVformat(formatString, topic));
+			}
+		});
+		const auto programTime = Benchmark::Run("FormatProgram::Format", topics.size(), [&] {
+			for (const auto& topic : topics) {
+				program.Format(buffer, topic);
+				Benchmark::DoNotOptimize(buffer);
+			}
+		});
+		Benchmark::PrintSpeedup(vformatTime, programTime);
+	}
+
+	// the cost that moved from every kShow/kUpdate to loading the settings
+	Benchmark::Run("compiling a FormatProgram", kFormats.size(), [&] {
+		for (const auto format : kFormats) {
+			Benchmark::DoNotOptimize(FormatProgram(format));
+		}
+	});
+	return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,106 @@
+/*
+Copyright (C) 2025 Jonathan Feenstra
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+See EXCEPTIONS for additional permissions.
+*/
+
+// Compares the kernels of StringUtil::LowerCaseContains that this CPU supports against the std::search it replaced,
+// by searching topic names for <BribeCost> as TopicIndex does for every topic of the game when the data is loaded.
+
+#include "Benchmark.h"
+#include "StringUtil.h"
+
+#include <random>
+
+namespace
+{
+	using StringUtil::ISA;
+
+	constexpr std::string_view kNeedle = "<bribecost>";
+
+	// the search of the plugin before the kernels
+	bool SearchLowerCase(const std::string_view a_hayStack, const std::string_view a_lowerCaseNeedle)
+	{
+		return std::search(a_hayStack.begin(), a_hayStack.end(), a_lowerCaseNeedle.begin(), a_lowerCaseNeedle.end(), [](const char a, const char b) {
+			return std::tolower(a) == b;
+		}) != a_hayStack.end();
+	}
+
+	// topic names of up to a_maxWords words, 2% of which are bribes
+	std::vector<std::string> MakeTopicNames(const std::uint32_t a_maxWords)
+	{
+		static constexpr std::array<std::string_view, 17> kWords{ "What", "can", "you", "tell", "me", "about", "the", "Dark", "Brotherhood", "Persuade", "I", "need", "to", "know", "where", "Whiterun", "is" };
+		std::mt19937 random(3);
+		std::vector<std::string> names;
+		for (std::uint32_t i = 0; i < 20'000; ++i) {
+			std::string name;
+			const auto numWords = 1 + random() % a_maxWords;
+			for (std::uint32_t word = 0; word < numWords; ++word) {
+				name += kWords[random() % kWords.size()];
+				name += ' ';
+			}
+			if (random() % 50 == 0) {
+				name += "(<BribeCost> gold)";
+			}
+			names.push_back(std::move(name));
+		}
+		return names;
+	}
+
+	void RunNames(const std::uint32_t a_maxWords)
+	{
+		const auto names = MakeTopicNames(a_maxWords);
+		std::size_t totalLength = 0;
+		for (const auto& name : names) {
+			totalLength += name.size();
+		}
+		std::cout << names.size() << " topic names of " << totalLength / names.size() << " characters on average (time per name):\n";
+
+		// all kernels must agree, or the comparison is meaningless
+		for (const auto& name : names) {
+			const auto expected = SearchLowerCase(name, kNeedle);
+			for (auto isa = ISA::kScalar; isa <= StringUtil::GetSupportedISA(); isa = static_cast<ISA>(static_cast<int>(isa) + 1)) {
+				if (StringUtil::LowerCaseContains(name, kNeedle, isa) != expected) {
+					std::cerr << "Results differ for \"" << name << "\"\n";
+					std::exit(EXIT_FAILURE);
+				}
+			}
+		}
+
+		const auto searchTime = Benchmark::Run("std::search with std::tolower", names.size(), [&] {
+			for (const auto& name : names) {
+				Benchmark::DoNotOptimize(SearchLowerCase(name, kNeedle));
+			}
+		});
+		constexpr std::array<std::string_view, 3> kISANames{ "LowerCaseContains, scalar", "LowerCaseContains, SSE2", "LowerCaseContains, AVX2" };
+		for (auto isa = ISA::kScalar; isa <= StringUtil::GetSupportedISA(); isa = static_cast<ISA>(static_cast<int>(isa) + 1)) {
+			const auto kernelTime = Benchmark::Run(kISANames[static_cast<std::size_t>(isa)], names.size(), [&] {
+				for (const auto& name : names) {
+					Benchmark::DoNotOptimize(StringUtil::LowerCaseContains(name, kNeedle, isa));
+				}
+			});
+			Benchmark::PrintSpeedup(searchTime, kernelTime);
+		}
+	}
+}
+
+int main()
+{
+	// the names of vanilla topics are mostly short, those of some mods are whole sentences
+	RunNames(8);
+	RunNames(24);
+	return EXIT_SUCCESS;
+}
\ No newline at end of file
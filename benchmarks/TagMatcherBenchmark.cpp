@@ -0,0 +1,219 @@
+/*
+Copyright (C) 2025 Jonathan Feenstra
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+See EXCEPTIONS for additional permissions.
+*/
+
+// Compares matching speech check tags with TagMatcher and the built-in English tag preset against the three std::regex_search calls
+// that matched them before, on synthetic dialogue lists where most topics are regular ones.
+
+#include "Benchmark.h"
+#include "TagMatcher.h"
+#include "TagPresets.h"
+
+#include <random>
+#include <regex>
+
+namespace
+{
+	// the default patterns of the [TagRegex] section before the built-in tags replaced them
+	constexpr std::array<std::string_view, 3> kPatterns{ " (\\(Persuade\\))$", " (\\(Intimidate\\))$", " (\\(\\d+ gold\\))$" };
+
+	// a_taggedPercent of the topics end with one of the three tags, the others are regular topics
+	std::vector<std::string> MakeTopics(const std::size_t a_count, const std::uint32_t a_taggedPercent)
+	{
+		static constexpr std::array<std::string_view, 16> kWords{ "What", "can", "you", "tell", "me", "about", "the", "Dark", "Brotherhood", "I", "need", "to", "know", "where", "Whiterun", "is" };
+		std::mt19937 random(1);
+		std::vector<std::string> topics;
+		topics.reserve(a_count);
+		for (std::size_t i = 0; i < a_count; ++i) {
+			std::string topic;
+			const auto numWords = 3 + random() % 12;
+			for (std::uint32_t word = 0; word < numWords; ++word) {
+				if (word > 0) {
+					topic += ' ';
+				}
+				topic += kWords[random() % kWords.size()];
+			}
+			if (random() % 100 < a_taggedPercent) {
+				switch (random() % 3) {
+				case 0:
+					topic += " (Persuade)";
+					break;
+				case 1:
+					topic += " (Intimidate)";
+					break;
+				default:
+					topic += " (" + std::to_string(10 + random() % 990) + " gold)";
+					break;
+				}
+			}
+			topics.push_back(std::move(topic));
+		}
+		return topics;
+	}
+
+	// The length of the matched tag times the number of patterns plus the index of the matching pattern, or the number of patterns.
+	// The groups differ, because the built-in tags exclude the parentheses that the old default patterns captured.
+	using MatchResult = std::size_t;
+
+	// the matching of the plugin before TagMatcher, which copied every topic text and searched the patterns one after another
+	class RegexTagMatcher final
+	{
+	public:
+		RegexTagMatcher()
+		{
+			for (std::size_t i = 0; i < kPatterns.size(); ++i) {
+				regexes[i] = std::regex(kPatterns[i].begin(), kPatterns[i].end());
+			}
+		}
+
+		MatchResult Match(const std::string_view a_text) const
+		{
+			// copies the text and the group, like the plugin did
+			const std::string text(a_text);
+			std::smatch match;
+			for (std::size_t i = 0; i < regexes.size(); ++i) {
+				if (std::regex_search(text, match, regexes[i])) {
+					const auto group = match.str(1);
+					Benchmark::DoNotOptimize(group);
+					return static_cast<std::size_t>(match.length()) * kPatterns.size() + i;
+				}
+			}
+			return kPatterns.size();
+		}
+
+	private:
+		std::array<std::regex, kPatterns.size()> regexes;
+	};
+
+	MatchResult GetFirstMatch(const TagMatcher::Matches& a_matches, const std::string_view a_text) noexcept
+	{
+		for (std::size_t i = 0; i < kPatterns.size(); ++i) {
+			if (a_matches[i].matched) {
+				Benchmark::DoNotOptimize(a_matches[i].Group(a_text));
+				return a_matches[i].Length() * kPatterns.size() + i;
+			}
+		}
+		return kPatterns.size();
+	}
+
+	MatchResult MatchWithTagMatcher(const TagMatcher& a_matcher, const std::string_view a_text) noexcept
+	{
+		return GetFirstMatch(a_matcher.MatchAll(a_text), a_text);
+	}
+
+	MatchResult MatchWithPreset(const TagPreset& a_preset, const std::string_view a_text) noexcept
+	{
+		return GetFirstMatch(a_preset.MatchAll(a_text), a_text);
+	}
+
+	void RunCorpus(const RegexTagMatcher& a_regexMatcher, const TagMatcher& a_tagMatcher, const std::size_t a_count, const std::uint32_t a_taggedPercent)
+	{
+		const auto topics = MakeTopics(a_count, a_taggedPercent);
+		std::cout << topics.size() << " topics, " << a_taggedPercent << "% tagged (time per topic):\n";
+
+		// all three must agree, or the comparison is meaningless
+		for (const auto& topic : topics) {
+			const auto expected = a_regexMatcher.Match(topic);
+			if (MatchWithTagMatcher(a_tagMatcher, topic) != expected || MatchWithPreset(TagPresets::GetEnglish(), topic) != expected) {
+				std::cerr << "Results differ for \"" << topic << "\"\n";
+				std::exit(EXIT_FAILURE);
+			}
+		}
+
+		const auto regexTime = Benchmark::Run("std::regex_search x3", topics.size(), [&] {
+			for (const auto& topic : topics) {
+				Benchmark::DoNotOptimize(a_regexMatcher.Match(topic));
+			}
+		});
+		const auto tagMatcherTime = Benchmark::Run("TagMatcher::MatchAll", topics.size(), [&] {
+			for (const auto& topic : topics) {
+				Benchmark::DoNotOptimize(MatchWithTagMatcher(a_tagMatcher, topic));
+			}
+		});
+		Benchmark::PrintSpeedup(regexTime, tagMatcherTime);
+		const auto presetTime = Benchmark::Run("TagPreset::MatchAll (English)", topics.size(), [&] {
+			for (const auto& topic : topics) {
+				Benchmark::DoNotOptimize(MatchWithPreset(TagPresets::GetEnglish(), topic));
+			}
+		});
+		Benchmark::PrintSpeedup(regexTime, presetTime);
+	}
+
+	// Every default pattern ends with $ and can't match an empty text, so MatchAll rejects most regular topics by their last character.
+	// A fourth pattern that matches an empty text turns that filter off without changing the matches of the others.
+	void RunLastCharacterFilter(const TagMatcher& a_tagMatcher)
+	{
+		const auto topics = MakeTopics(100'000, 10);
+		std::cout << "Last character filter, " << topics.size() << " topics, 10% tagged (time per topic):\n";
+
+		constexpr std::array<std::string_view, 4> unfilteredPatterns{ kPatterns[0], kPatterns[1], kPatterns[2], "x?$" };
+		TagMatcher unfilteredMatcher;
+		unfilteredMatcher.Compile(unfilteredPatterns);
+
+		const auto unfilteredTime = Benchmark::Run("TagMatcher::MatchAll without the filter", topics.size(), [&] {
+			for (const auto& topic : topics) {
+				Benchmark::DoNotOptimize(MatchWithTagMatcher(unfilteredMatcher, topic));
+			}
+		});
+		const auto filteredTime = Benchmark::Run("TagMatcher::MatchAll with the filter", topics.size(), [&] {
+			for (const auto& topic : topics) {
+				Benchmark::DoNotOptimize(MatchWithTagMatcher(a_tagMatcher, topic));
+			}
+		});
+		Benchmark::PrintSpeedup(unfilteredTime, filteredTime);
+	}
+
+	// A badly written user pattern, which makes the backtracking of std::regex exponential in the length of the text
+	// when it almost matches. TagMatcher stays linear.
+	void RunPathologicalPattern()
+	{
+		constexpr std::string_view pattern = " \\(((a+)+)\\)$";
+		std::cout << "Pathological pattern \"" << pattern << "\" on \" (aaa...a\" without the closing parenthesis (time per topic):\n";
+
+		TagMatcher tagMatcher;
+		tagMatcher.Compile(std::span(&pattern, 1));
+		const std::regex regex(pattern.begin(), pattern.end());
+		for (const std::size_t length : { 12, 16, 20 }) {
+			const auto text = " (" + std::string(length, 'a');
+			const auto label = std::to_string(length) + " characters";
+			Benchmark::Run("TagMatcher::MatchAll, " + label, 1, [&] { Benchmark::DoNotOptimize(tagMatcher.MatchAll(text)); }, 50ms);
+			Benchmark::Run("std::regex_search, " + label, 1, [&] {
+				std::smatch match;
+				try {
+					Benchmark::DoNotOptimize(std::regex_search(text, match, regex));
+				} catch (const std::regex_error&) {
+					// some implementations give up with error_complexity, which the plugin would log as a failed match
+				}
+			}, 50ms);
+		}
+	}
+}
+
+int main()
+{
+	const RegexTagMatcher regexMatcher;
+	TagMatcher tagMatcher;
+	tagMatcher.Compile(kPatterns);
+
+	RunCorpus(regexMatcher, tagMatcher, 1'000, 10);
+	RunCorpus(regexMatcher, tagMatcher, 100'000, 10);
+	RunCorpus(regexMatcher, tagMatcher, 100'000, 50);
+	RunLastCharacterFilter(tagMatcher);
+	RunPathologicalPattern();
+	return EXIT_SUCCESS;
+}
\ No newline at end of file
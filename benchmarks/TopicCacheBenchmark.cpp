@@ -0,0 +1,202 @@
+/*
+Copyright (C) 2025 Jonathan Feenstra
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+See EXCEPTIONS for additional permissions.
+*/
+
+// Compares the topic cache keyed by a HashUtil::Fingerprint in a FlatHashMap against the std::unordered_map it replaced,
+// which was keyed by a std::tuple of the topic, the speaker and a copy of the topic text, hashed with a hand-rolled combiner.
+// Both are replayed on the lookups of dialogue lists with different hit/miss mixes and numbers of cached topics.
+
+#include "Benchmark.h"
+#include "FlatHashMap.h"
+
+#include <random>
+#include <unordered_map>
+
+namespace
+{
+	// the part of a cached topic that the lookups touch
+	struct CachedTopic final
+	{
+		std::uint32_t topicFormID;
+		std::uint32_t speakerFormID;
+		std::string topicName;
+		std::uint32_t color;
+	};
+
+	// topic, speaker and topic text, the key of the plugin before FlatHashMap
+	using TupleKey = std::tuple<std::uint32_t, std::uint32_t, std::string>;
+
+	struct TupleKeyHash
+	{
+		std::size_t operator()(const TupleKey& a_key) const
+		{
+			std::size_t seed = 0;
+			seed ^= std::hash<std::uint32_t>()(std::get<0>(a_key)) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+			seed ^= std::hash<std::uint32_t>()(std::get<1>(a_key)) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+			seed ^= std::hash<std::string>()(std::get<2>(a_key)) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+			return seed;
+		}
+	};
+
+	using TupleCache = std::unordered_map<TupleKey, CachedTopic, TupleKeyHash>;
+	using FlatCache = FlatHashMap<std::uint64_t, CachedTopic, FlatIdentityHash>;
+
+	struct Topic final
+	{
+		std::uint32_t formID;
+		std::uint32_t speakerFormID;
+		std::string name;  // the string of the game, which the plugin only sees as const char*
+	};
+
+	// Topics of a_numSpeakers speakers with names like those of the game, a few of which are shared by several topics.
+	std::vector<Topic> MakeTopics(const std::size_t a_count, const std::uint32_t a_firstFormID, const std::size_t a_numSpeakers)
+	{
+		static constexpr std::array<std::string_view, 6> kNames{ "What can you tell me about ", "I'm looking for work. Anything about ", "Goodbye.", "Tell me about ", "(Persuade) ", "What's the news on " };
+		std::vector<Topic> topics;
+		topics.reserve(a_count);
+		for (std::uint32_t i = 0; i < a_count; ++i) {
+			auto name = std::string(kNames[i % kNames.size()]);
+			if (i % kNames.size() != 2) {
+				name += "subject " + std::to_string(a_firstFormID + i);
+			}
+			topics.push_back({ a_firstFormID + i, 0x0001A66B + static_cast<std::uint32_t>(i % a_numSpeakers), std::move(name) });
+		}
+		return topics;
+	}
+
+	std::uint64_t GetFingerprint(const Topic& a_topic) noexcept
+	{
+		return HashUtil::Fingerprint(a_topic.formID, a_topic.speakerFormID, HashUtil::Hash(a_topic.name));
+	}
+
+	void Fill(TupleCache& a_cache, const std::vector<Topic>& a_topics)
+	{
+		a_cache.clear();
+		for (const auto& topic : a_topics) {
+			a_cache.insert_or_assign(std::make_tuple(topic.formID, topic.speakerFormID, std::string(topic.name.c_str())),
+				CachedTopic{ topic.formID, topic.speakerFormID, topic.name, topic.formID });
+		}
+	}
+
+	void Fill(FlatCache& a_cache, const std::vector<Topic>& a_topics)
+	{
+		a_cache.Clear();
+		for (const auto& topic : a_topics) {
+			a_cache.InsertOrAssign(GetFingerprint(topic), CachedTopic{ topic.formID, topic.speakerFormID, topic.name, topic.formID });
+		}
+	}
+
+	// like processDialogue before FlatHashMap, which built the key with a copy of the topic text for every lookup
+	std::uint32_t LookUpWithTuple(const TupleCache& a_cache, const Topic& a_topic)
+	{
+		const auto where = a_cache.find(std::make_tuple(a_topic.formID, a_topic.speakerFormID, std::string(a_topic.name.c_str())));
+		return where != a_cache.end() ? where->second.color : 0;
+	}
+
+	// like processDialogue, which compares the cached topic to rule out fingerprint collisions
+	std::uint32_t LookUpWithFingerprint(const FlatCache& a_cache, const Topic& a_topic) noexcept
+	{
+		const std::string_view name(a_topic.name.c_str());
+		const auto cachedTopic = a_cache.Find(HashUtil::Fingerprint(a_topic.formID, a_topic.speakerFormID, HashUtil::Hash(name)));
+		const auto isSameTopic = cachedTopic && cachedTopic->topicFormID == a_topic.formID && cachedTopic->speakerFormID == a_topic.speakerFormID && cachedTopic->topicName == name;
+		return isSameTopic ? cachedTopic->color : 0;
+	}
+
+	// The topics of a_numDialogues dialogue lists of a_listSize topics, a_hitPercent of which are cached.
+	// The others are new topics, or topics whose text changed, which miss in both caches.
+	std::vector<Topic> MakeLookups(const std::vector<Topic>& a_cachedTopics, const std::size_t a_listSize, const std::size_t a_numDialogues, const std::uint32_t a_hitPercent)
+	{
+		std::mt19937 random(1);
+		const auto missingTopics = MakeTopics(a_listSize * a_numDialogues, 0x05000000, 64);
+		std::vector<Topic> lookups;
+		lookups.reserve(a_listSize * a_numDialogues);
+		for (std::size_t i = 0; i < a_listSize * a_numDialogues; ++i) {
+			if (random() % 100 < a_hitPercent) {
+				lookups.push_back(a_cachedTopics[random() % a_cachedTopics.size()]);
+			} else {
+				lookups.push_back(missingTopics[i]);
+			}
+		}
+		return lookups;
+	}
+
+	void RunMix(const std::size_t a_numCached, const std::size_t a_listSize, const std::uint32_t a_hitPercent)
+	{
+		const auto cachedTopics = MakeTopics(a_numCached, 0x00010000, 256);
+		const auto lookups = MakeLookups(cachedTopics, a_listSize, 64, a_hitPercent);
+		std::cout << a_numCached << " cached topics, lists of " << a_listSize << " topics, " << a_hitPercent << "% hits (time per lookup):\n";
+
+		TupleCache tupleCache;
+		Fill(tupleCache, cachedTopics);
+		FlatCache flatCache;
+		Fill(flatCache, cachedTopics);
+
+		// both must agree, or the comparison is meaningless
+		for (const auto& topic : lookups) {
+			if (LookUpWithTuple(tupleCache, topic) != LookUpWithFingerprint(flatCache, topic)) {
+				std::cerr << "Results differ for \"" << topic.name << "\"\n";
+				std::exit(EXIT_FAILURE);
+			}
+		}
+
+		const auto tupleTime = Benchmark::Run("unordered_map<tuple<FormID, FormID, string>>", lookups.size(), [&] {
+			for (const auto& topic : lookups) {
+				Benchmark::DoNotOptimize(LookUpWithTuple(tupleCache, topic));
+			}
+		});
+		const auto flatTime = Benchmark::Run("FlatHashMap with HashUtil::Fingerprint", lookups.size(), [&] {
+			for (const auto& topic : lookups) {
+				Benchmark::DoNotOptimize(LookUpWithFingerprint(flatCache, topic));
+			}
+		});
+		Benchmark::PrintSpeedup(tupleTime, flatTime);
+	}
+
+	// filling the cache again after it was cleared, which keeps the capacity of the FlatHashMap
+	void RunRefill(const std::size_t a_numCached)
+	{
+		const auto cachedTopics = MakeTopics(a_numCached, 0x00010000, 256);
+		std::cout << "Refilling " << a_numCached << " cached topics (time per topic):\n";
+
+		TupleCache tupleCache;
+		FlatCache flatCache;
+		const auto tupleTime = Benchmark::Run("unordered_map<tuple<FormID, FormID, string>>", cachedTopics.size(), [&] {
+			Fill(tupleCache, cachedTopics);
+			Benchmark::DoNotOptimize(tupleCache);
+		});
+		const auto flatTime = Benchmark::Run("FlatHashMap with HashUtil::Fingerprint", cachedTopics.size(), [&] {
+			Fill(flatCache, cachedTopics);
+			Benchmark::DoNotOptimize(flatCache);
+		});
+		Benchmark::PrintSpeedup(tupleTime, flatTime);
+	}
+}
+
+int main()
+{
+	// A few dialogues after loading a save, a long session and a full cache, whose size is limited by the plugin.
+	// Reopening a dialogue mostly hits, a new speaker mostly misses.
+	for (const std::size_t numCached : { 64, 1024, 4096 }) {
+		for (const std::uint32_t hitPercent : { 95, 50, 5 }) {
+			RunMix(numCached, 20, hitPercent);
+		}
+	}
+	RunMix(4096, 200, 95);
+	RunRefill(1024);
+	return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,174 @@
+/*
+Copyright (C) 2025 Jonathan Feenstra
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+See EXCEPTIONS for additional permissions.
+*/
+
+// Compares TopicDisplayTable against the std::unordered_map<std::string, TopicDisplayData> it replaced, by replaying the lookups
+// the Scaleform handlers make: every entry of the list when it's redrawn, and the highlighted entry while the player scrolls through it.
+// The handlers get the topic texts as const char* from GFxValues, so the map needed a std::string for every lookup.
+
+#include "Benchmark.h"
+#include "SessionArena.h"
+#include "TopicDisplayTable.h"
+
+#include <random>
+#include <unordered_map>
+
+namespace
+{
+	using Scaleform::TopicDisplayData;
+	using Scaleform::TopicDisplayTable;
+
+	// the lookups of the plugin before TopicDisplayTable
+	using DisplayDataMap = std::unordered_map<std::string, TopicDisplayData>;
+
+	struct DialogueList final
+	{
+		std::vector<std::string> texts;  // the strings of the movie, which the handlers see as const char*
+		std::vector<TopicDisplayData> displayData;
+	};
+
+	// a_count topics, of which the first a_knownCount have display data and the others are topics of other mods the table doesn't know
+	DialogueList MakeDialogueList(const std::size_t a_count, const std::size_t a_knownCount)
+	{
+		static constexpr std::array<std::string_view, 4> kTags{ "", " (Persuade)", " (Intimidate)", " (100 gold)" };
+		DialogueList list;
+		for (std::size_t i = 0; i < a_count; ++i) {
+			auto text = "What can you tell me about topic number " + std::to_string(i) + std::string(kTags[i % kTags.size()]);
+			if (i < a_knownCount) {
+				list.displayData.push_back({ 0xFFFFFF, 0xA0A0A0, text + " [Success]", std::nullopt });
+			}
+			list.texts.push_back(std::move(text));
+		}
+		return list;
+	}
+
+	void Fill(DisplayDataMap& a_map, const DialogueList& a_list)
+	{
+		a_map.clear();
+		for (std::size_t i = 0; i < a_list.displayData.size(); ++i) {
+			a_map.emplace(a_list.texts[i], a_list.displayData[i]);
+		}
+	}
+
+	void Fill(TopicDisplayTable& a_table, const DialogueList& a_list)
+	{
+		a_table.Clear();
+		for (std::size_t i = 0; i < a_list.displayData.size(); ++i) {
+			a_table.Insert(a_list.texts[i], a_list.displayData[i]);
+		}
+		a_table.Build();
+	}
+
+	// the color of the entry, like the handler of SetEntry
+	std::uint32_t LookUpWithMap(const DisplayDataMap& a_map, const char* a_text)
+	{
+		const auto where = a_map.find(std::string(a_text));
+		return where != a_map.end() ? where->second.newColor : 0;
+	}
+
+	std::uint32_t LookUpWithTable(const TopicDisplayTable& a_table, const char* a_text) noexcept
+	{
+		const auto entry = a_table.Find(a_text);
+		return entry ? entry->newColor : 0;
+	}
+
+	// The highlighted entries while the player scrolls down and up through the list a few times, and sometimes jumps with the mouse.
+	std::vector<std::size_t> MakeScrollingPattern(const std::size_t a_count)
+	{
+		std::mt19937 random(1);
+		std::vector<std::size_t> highlighted;
+		std::size_t index = 0;
+		for (std::size_t step = 0; step < 4 * a_count; ++step) {
+			if (random() % 8 == 0) {
+				index = random() % a_count;
+			} else if ((step / a_count) % 2 == 0) {
+				index = index + 1 < a_count ? index + 1 : index;
+			} else {
+				index = index > 0 ? index - 1 : index;
+			}
+			highlighted.push_back(index);
+		}
+		return highlighted;
+	}
+
+	void RunList(const std::size_t a_count, const std::size_t a_knownCount)
+	{
+		const auto list = MakeDialogueList(a_count, a_knownCount);
+		std::cout << a_count << " topics, " << a_knownCount << " with display data (time per lookup or inserted topic):\n";
+
+		DisplayDataMap map;
+		Fill(map, list);
+		SessionArena arena;
+		TopicDisplayTable table(&arena);
+		Fill(table, list);
+
+		// both must agree, or the comparison is meaningless
+		for (const auto& text : list.texts) {
+			if (LookUpWithMap(map, text.c_str()) != LookUpWithTable(table, text.c_str())) {
+				std::cerr << "Results differ for \"" << text << "\"\n";
+				std::exit(EXIT_FAILURE);
+			}
+		}
+
+		// every entry is colored whenever the list is redrawn, which happens on every kUpdate
+		const auto mapRedrawTime = Benchmark::Run("redraw, unordered_map<std::string>", list.texts.size(), [&] {
+			for (const auto& text : list.texts) {
+				Benchmark::DoNotOptimize(LookUpWithMap(map, text.c_str()));
+			}
+		});
+		const auto tableRedrawTime = Benchmark::Run("redraw, TopicDisplayTable::Find", list.texts.size(), [&] {
+			for (const auto& text : list.texts) {
+				Benchmark::DoNotOptimize(LookUpWithTable(table, text.c_str()));
+			}
+		});
+		Benchmark::PrintSpeedup(mapRedrawTime, tableRedrawTime);
+
+		const auto highlighted = MakeScrollingPattern(a_count);
+		const auto mapScrollTime = Benchmark::Run("scrolling, unordered_map<std::string>", highlighted.size(), [&] {
+			for (const auto index : highlighted) {
+				Benchmark::DoNotOptimize(LookUpWithMap(map, list.texts[index].c_str()));
+			}
+		});
+		const auto tableScrollTime = Benchmark::Run("scrolling, TopicDisplayTable::Find", highlighted.size(), [&] {
+			for (const auto index : highlighted) {
+				Benchmark::DoNotOptimize(LookUpWithTable(table, list.texts[index].c_str()));
+			}
+		});
+		Benchmark::PrintSpeedup(mapScrollTime, tableScrollTime);
+
+		// the display data is rebuilt on every kShow/kUpdate, the arena is reset when the menu closes
+		const auto mapFillTime = Benchmark::Run("rebuild, unordered_map<std::string>", list.displayData.size(), [&] {
+			Fill(map, list);
+			Benchmark::DoNotOptimize(map);
+		});
+		const auto tableFillTime = Benchmark::Run("rebuild, TopicDisplayTable", list.displayData.size(), [&] {
+			Fill(table, list);
+			Benchmark::DoNotOptimize(table);
+		});
+		Benchmark::PrintSpeedup(mapFillTime, tableFillTime);
+	}
+}
+
+int main()
+{
+	// a vanilla dialogue, a busy one and the topic lists of dialogue-heavy mod lists
+	RunList(8, 8);
+	RunList(40, 32);
+	RunList(200, 150);
+	return EXIT_SUCCESS;
+}
\ No newline at end of file
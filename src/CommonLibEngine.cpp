@@ -0,0 +1,218 @@
+/*
+Copyright (C) 2025 Jonathan Feenstra
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+See EXCEPTIONS for additional permissions.
+*/
+
+#include "CommonLibEngine.h"
+
+namespace
+{
+	const RE::TESTopic* ToTopic(const Dialogue::TopicHandle a_topic) noexcept
+	{
+		return reinterpret_cast<const RE::TESTopic*>(a_topic);
+	}
+
+	// the game's functions for topic infos aren't const
+	RE::TESTopicInfo* ToTopicInfo(const Dialogue::TopicInfoHandle a_topicInfo) noexcept
+	{
+		return const_cast<RE::TESTopicInfo*>(reinterpret_cast<const RE::TESTopicInfo*>(a_topicInfo));
+	}
+
+	const RE::TESConditionItem* ToConditionItem(const Dialogue::ConditionItemHandle a_conditionItem) noexcept
+	{
+		return reinterpret_cast<const RE::TESConditionItem*>(a_conditionItem);
+	}
+
+	float GetGameSettingFloat(const char* a_name, const float a_default) noexcept
+	{
+		const auto gameSettings = RE::GameSettingCollection::GetSingleton();
+		const auto setting = gameSettings ? gameSettings->GetSetting(a_name) : nullptr;
+		return setting ? setting->GetFloat() : a_default;
+	}
+}
+
+CommonLibEngine::CommonLibEngine(const DialogueContext& a_context) noexcept :
+	context(a_context)
+{
+}
+
+std::string_view CommonLibEngine::GetName(const Dialogue::TopicHandle a_topic) const noexcept
+{
+	return ToTopic(a_topic)->GetFullName();
+}
+
+std::uint32_t CommonLibEngine::GetNumInfos(const Dialogue::TopicHandle a_topic) const noexcept
+{
+	const auto topic = ToTopic(a_topic);
+	return topic->topicInfos ? topic->numTopicInfos : 0;
+}
+
+Dialogue::TopicInfoHandle CommonLibEngine::GetInfo(const Dialogue::TopicHandle a_topic, const std::uint32_t a_index) const noexcept
+{
+	return reinterpret_cast<Dialogue::TopicInfoHandle>(ToTopic(a_topic)->topicInfos[a_index]);
+}
+
+Dialogue::ConditionItemHandle CommonLibEngine::GetFirstCondition(const Dialogue::TopicInfoHandle a_topicInfo) const noexcept
+{
+	return reinterpret_cast<Dialogue::ConditionItemHandle>(ToTopicInfo(a_topicInfo)->objConditions.head);
+}
+
+bool CommonLibEngine::AreConditionsTrue(const Dialogue::TopicInfoHandle a_topicInfo) const noexcept
+{
+	const auto [conditionChain, inserted] = conditionChains.TryEmplace(a_topicInfo);
+	if (inserted) {
+		*conditionChain = ConditionChain::Compile(*this, GetFirstCondition(a_topicInfo));
+	}
+
+	// unlike TESCondition::IsTrue(speaker, player), this passes the topic's quest, which conditions on its aliases need
+	const auto topicInfo = ToTopicInfo(a_topicInfo);
+	auto checkParams = context.checkParams;
+	checkParams.quest = topicInfo->parentTopic ? topicInfo->parentTopic->ownerQuest : nullptr;
+	return conditionChain->Evaluate(GetEngine(), [&](const Dialogue::ConditionItemHandle a_conditionItem) {
+		const auto conditionItem = ToConditionItem(a_conditionItem);
+		if (conditionItem->data.functionData.function == RE::FUNCTION_DATA::FunctionID::kGetEquipped) {
+			return context.IsEquippedConditionTrue(conditionItem);
+		}
+		return conditionItem->IsTrue(checkParams);
+	});
+}
+
+Dialogue::ConditionItemHandle CommonLibEngine::GetNext(const Dialogue::ConditionItemHandle a_conditionItem) const noexcept
+{
+	return reinterpret_cast<Dialogue::ConditionItemHandle>(ToConditionItem(a_conditionItem)->next);
+}
+
+Dialogue::ConditionData CommonLibEngine::GetData(const Dialogue::ConditionItemHandle a_conditionItem) const noexcept
+{
+	const auto& data = ToConditionItem(a_conditionItem)->data;
+	const auto function = data.functionData.function;
+	Dialogue::ConditionData result{};
+	if (function == RE::FUNCTION_DATA::FunctionID::kGetActorValue) {
+		result.function = Dialogue::CONDITION_FUNCTION::kGetActorValue;
+		result.isSpeech = static_cast<RE::ActorValue>(reinterpret_cast<intptr_t>(data.functionData.params[0])) == RE::ActorValue::kSpeech;
+	} else if (function == RE::FUNCTION_DATA::FunctionID::kGetBribeSuccess) {
+		result.function = Dialogue::CONDITION_FUNCTION::kGetBribeSuccess;
+	} else if (function == RE::FUNCTION_DATA::FunctionID::kGetIntimidateSuccess) {
+		result.function = Dialogue::CONDITION_FUNCTION::kGetIntimidateSuccess;
+	} else if (function == RE::FUNCTION_DATA::FunctionID::kGetEquipped) {
+		result.function = Dialogue::CONDITION_FUNCTION::kGetEquipped;
+	} else {
+		result.function = Dialogue::CONDITION_FUNCTION::kOther;
+	}
+
+	switch (data.object) {
+	case RE::CONDITIONITEMOBJECT::kSelf:
+		result.object = Dialogue::CONDITION_OBJECT::kSubject;
+		break;
+	case RE::CONDITIONITEMOBJECT::kTarget:
+		result.object = Dialogue::CONDITION_OBJECT::kTarget;
+		break;
+	case RE::CONDITIONITEMOBJECT::kRef:
+		{
+			const auto runOnRef = data.runOnRef.get();
+			result.object = runOnRef && runOnRef->IsPlayerRef() ? Dialogue::CONDITION_OBJECT::kPlayer : Dialogue::CONDITION_OBJECT::kOther;
+			break;
+		}
+	default:
+		result.object = Dialogue::CONDITION_OBJECT::kOther;
+		break;
+	}
+	result.swapsSubjectAndTarget = data.flags.swapTarget;
+
+	result.opCode = static_cast<Dialogue::OPCODE>(data.flags.opCode);
+	result.isOR = data.flags.isOR;
+	if (data.flags.global) {
+		result.comparisonValue = data.comparisonValue.g->value;
+		result.global = reinterpret_cast<Dialogue::GlobalHandle>(data.comparisonValue.g);
+	} else {
+		result.comparisonValue = data.comparisonValue.f;
+	}
+	return result;
+}
+
+bool CommonLibEngine::IsTrue(const Dialogue::ConditionItemHandle a_conditionItem) const noexcept
+{
+	const auto conditionItem = ToConditionItem(a_conditionItem);
+	if (conditionItem->data.functionData.function == RE::FUNCTION_DATA::FunctionID::kGetEquipped) {
+		return context.IsEquippedConditionTrue(conditionItem);
+	}
+	auto checkParams = context.checkParams;
+	return conditionItem->IsTrue(checkParams);
+}
+
+Dialogue::SpeechCheckInputs CommonLibEngine::GetSpeechCheckInputs() const noexcept
+{
+	if (!speechCheckInputs) {
+		speechCheckInputs = readSpeechCheckInputs();
+	}
+	return *speechCheckInputs;
+}
+
+std::uint32_t CommonLibEngine::GetFormID(const Dialogue::GlobalHandle a_global) const noexcept
+{
+	return ToGlobal(a_global)->GetFormID();
+}
+
+std::string_view CommonLibEngine::GetResponseText(const Dialogue::TopicInfoHandle a_topicInfo) const noexcept
+{
+	const auto topicInfo = ToTopicInfo(a_topicInfo);
+	const auto key = (static_cast<std::uint64_t>(topicInfo->GetFormID()) << 32) | context.speakerFormID;
+	const auto [responseText, inserted] = responseTexts.TryEmplace(key);
+	if (inserted) {
+		*responseText = lookUpResponseText(topicInfo);
+	}
+	return *responseText;
+}
+
+std::string CommonLibEngine::lookUpResponseText(RE::TESTopicInfo* a_topicInfo) const noexcept
+{
+	if (context.speakerActor) {
+		auto dialogueData = a_topicInfo->GetDialogueData(context.speakerActor);
+		if (!dialogueData.responses.empty()) {
+			const auto response = dialogueData.responses.front();
+			return response->text.c_str();
+		}
+	}
+
+	return "";
+}
+
+Dialogue::SpeechCheckInputs CommonLibEngine::readSpeechCheckInputs() const noexcept
+{
+	static const auto intimidationPerk = RE::TESDataHandler::GetSingleton()->LookupForm<RE::BGSPerk>(0x105F29, "Skyrim.esm");
+	const auto player = context.player;
+
+	Dialogue::SpeechCheckInputs result{
+		static_cast<float>(player->GetLevel()),
+		static_cast<float>(player->GetGoldAmount()),
+		intimidationPerk && player->HasPerk(intimidationPerk) ? 2.0F : 1.0F,
+		1.0F,
+		Dialogue::CONFIDENCE::kAverage,
+		GetGameSettingFloat("fIntimidateSpeechcraftCurve", 1.0F),
+		{ GetGameSettingFloat("fIntimidateConfidenceMultCowardly", 1.0F),
+			GetGameSettingFloat("fIntimidateConfidenceMultCautious", 1.0F),
+			GetGameSettingFloat("fIntimidateConfidenceMultAverage", 1.0F),
+			GetGameSettingFloat("fIntimidateConfidenceMultBrave", 1.0F),
+			GetGameSettingFloat("fIntimidateConfidenceMultFoolhardy", 1.0F) }
+	};
+	if (const auto actor = context.speakerActor) {
+		result.speakerLevel = static_cast<float>(actor->GetLevel());
+		const auto confidence = actor->AsActorValueOwner()->GetActorValue(RE::ActorValue::kConfidence);
+		result.speakerConfidence = static_cast<Dialogue::CONFIDENCE>(std::clamp(static_cast<int>(confidence), 0, 4));
+	}
+	return result;
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "ConditionChain.h"
+#include "DialogueContext.h"
+#include "DialogueEngine.h"
+#include "FlatHashMap.h"
+
+// Implements the dialogue engine interfaces of the core library with the game's forms, for the dialogue list of a_context.
+class CommonLibEngine final :
+	public Dialogue::ITopics,
+	public Dialogue::ITopicInfos,
+	public Dialogue::IConditionItems,
+	public Dialogue::IActorValues,
+	public Dialogue::IGlobals,
+	public Dialogue::IResponseTexts
+{
+public:
+	explicit CommonLibEngine(const DialogueContext& a_context) noexcept;
+
+	Dialogue::Engine GetEngine() const noexcept { return { *this, *this, *this, *this, *this, *this }; }
+
+	static Dialogue::TopicHandle ToHandle(const RE::TESTopic* a_topic) noexcept { return reinterpret_cast<Dialogue::TopicHandle>(a_topic); }
+	static const RE::TESGlobal* ToGlobal(const Dialogue::GlobalHandle a_global) noexcept { return reinterpret_cast<const RE::TESGlobal*>(a_global); }
+
+	// response texts are kept for every topic info and speaker until this is called, e.g. when cached topics are invalidated
+	static void ClearResponseTexts() noexcept { responseTexts.Clear(); }
+
+	// ITopics
+	std::string_view GetName(Dialogue::TopicHandle a_topic) const noexcept override;
+	std::uint32_t GetNumInfos(Dialogue::TopicHandle a_topic) const noexcept override;
+	Dialogue::TopicInfoHandle GetInfo(Dialogue::TopicHandle a_topic, std::uint32_t a_index) const noexcept override;
+
+	// ITopicInfos
+	Dialogue::ConditionItemHandle GetFirstCondition(Dialogue::TopicInfoHandle a_topicInfo) const noexcept override;
+	bool AreConditionsTrue(Dialogue::TopicInfoHandle a_topicInfo) const noexcept override;
+
+	// IConditionItems
+	Dialogue::ConditionItemHandle GetNext(Dialogue::ConditionItemHandle a_conditionItem) const noexcept override;
+	Dialogue::ConditionData GetData(Dialogue::ConditionItemHandle a_conditionItem) const noexcept override;
+	bool IsTrue(Dialogue::ConditionItemHandle a_conditionItem) const noexcept override;
+
+	// IActorValues
+	float GetPlayerSpeechLevel() const noexcept override { return context.playerSpeechLevel; }
+	Dialogue::SpeechCheckInputs GetSpeechCheckInputs() const noexcept override;
+
+	// IGlobals
+	std::uint32_t GetFormID(Dialogue::GlobalHandle a_global) const noexcept override;
+
+	// IResponseTexts
+	std::string_view GetResponseText(Dialogue::TopicInfoHandle a_topicInfo) const noexcept override;
+
+private:
+	// keyed by the form IDs of the topic info (high half) and the speaker (low half)
+	static inline FlatHashMap<std::uint64_t, std::string> responseTexts;
+	// compiled on first use and kept for the rest of the game, since topic infos and their conditions are never unloaded
+	static inline FlatHashMap<Dialogue::TopicInfoHandle, ConditionChain> conditionChains;
+
+	const DialogueContext& context;
+	mutable std::optional<Dialogue::SpeechCheckInputs> speechCheckInputs;
+
+	std::string lookUpResponseText(RE::TESTopicInfo* a_topicInfo) const noexcept;
+	Dialogue::SpeechCheckInputs readSpeechCheckInputs() const noexcept;
+};
\ No newline at end of file
@@ -0,0 +1,60 @@
+/*
+Copyright (C) 2025 Jonathan Feenstra
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+See EXCEPTIONS for additional permissions.
+*/
+
+
+#include "ConditionChain.h"
+
+ConditionChain ConditionChain::Compile(const Dialogue::IConditionItems& a_conditionItems, const Dialogue::ConditionItemHandle a_first)
+{
+	struct Group final
+	{
+		std::vector<Term> terms;
+		std::uint32_t numEngineTerms;
+	};
+
+	std::vector<Group> groups;
+	auto startsGroup = true;
+	for (auto conditionItem = a_first; conditionItem; conditionItem = a_conditionItems.GetNext(conditionItem)) {
+		if (startsGroup) {
+			groups.emplace_back();
+		}
+		const auto data = a_conditionItems.GetData(conditionItem);
+		// the player's Speech is the only actor value known natively, the game evaluates conditions on the speaker's
+		const auto kind = data.function == Dialogue::CONDITION_FUNCTION::kGetActorValue && data.isSpeech && data.RunsOnPlayer() ? KIND::kPlayerSpeech : KIND::kEngine;
+		auto& group = groups.back();
+		group.terms.push_back({ conditionItem, data.comparisonValue, data.opCode, kind, data.global != nullptr, false });
+		group.numEngineTerms += kind == KIND::kEngine;
+		// the OR flag of the last condition has nothing to combine with
+		startsGroup = !data.isOR;
+	}
+
+	// native terms first within each group, then the groups that need the fewest calls into the game, keeping the game's order otherwise
+	for (auto& group : groups) {
+		std::ranges::stable_partition(group.terms, [](const Term& a_term) { return a_term.kind == KIND::kPlayerSpeech; });
+		group.terms.back().endsGroup = true;
+	}
+	std::ranges::stable_sort(groups, {}, &Group::numEngineTerms);
+
+	ConditionChain result;
+	for (const auto& group : groups) {
+		result.terms.insert(result.terms.end(), group.terms.begin(), group.terms.end());
+		result.numEngineTerms += group.numEngineTerms;
+	}
+	return result;
+}
\ No newline at end of file
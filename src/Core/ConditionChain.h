@@ -0,0 +1,73 @@
+#pragma once
+
+#include "DialogueEngine.h"
+
+// The condition list of a topic info, compiled into the order that decides it with the fewest calls into the game.
+// The game ORs a condition with the next one if its OR flag is set and ANDs the resulting groups, so A AND B OR C AND D
+// means A AND (B OR C) AND D. Since both are commutative, the groups and their terms can be evaluated in any order:
+// conditions on the player's Speech are evaluated natively and come first, so a chain that already fails on Speech,
+// such as the success response of a persuasion check, is decided without calling into the game at all.
+class ConditionChain final
+{
+public:
+	// a_first is the head of the condition list, nullptr for a topic info without conditions
+	static ConditionChain Compile(const Dialogue::IConditionItems& a_conditionItems, const Dialogue::ConditionItemHandle a_first);
+
+	// a_evaluateEngineTerm is a bool(Dialogue::ConditionItemHandle) that evaluates a condition the chain can't evaluate natively
+	template <class EvaluateEngineTerm>
+	bool Evaluate(const Dialogue::Engine& a_engine, EvaluateEngineTerm&& a_evaluateEngineTerm) const noexcept;
+	bool Evaluate(const Dialogue::Engine& a_engine) const noexcept
+	{
+		return Evaluate(a_engine, [&](const Dialogue::ConditionItemHandle a_conditionItem) { return a_engine.conditionItems.IsTrue(a_conditionItem); });
+	}
+
+	std::size_t NumTerms() const noexcept { return terms.size(); }
+	std::size_t NumEngineTerms() const noexcept { return numEngineTerms; }
+
+private:
+	enum class KIND : std::uint8_t
+	{
+		kPlayerSpeech,
+		kEngine,
+	};
+
+	struct Term final
+	{
+		Dialogue::ConditionItemHandle conditionItem;
+		float comparisonValue;  // read again during evaluation if the condition compares with a global
+		Dialogue::OPCODE opCode;
+		KIND kind;
+		bool hasGlobal;
+		bool endsGroup;
+	};
+
+	std::vector<Term> terms;
+	std::uint32_t numEngineTerms = 0;
+};
+
+template <class EvaluateEngineTerm>
+bool ConditionChain::Evaluate(const Dialogue::Engine& a_engine, EvaluateEngineTerm&& a_evaluateEngineTerm) const noexcept
+{
+	std::optional<float> playerSpeechLevel;
+	auto groupIsTrue = false;
+	for (const auto& term : terms) {
+		if (!groupIsTrue) {
+			if (term.kind == KIND::kPlayerSpeech) {
+				if (!playerSpeechLevel) {
+					playerSpeechLevel = a_engine.actorValues.GetPlayerSpeechLevel();
+				}
+				const auto comparisonValue = term.hasGlobal ? a_engine.conditionItems.GetData(term.conditionItem).comparisonValue : term.comparisonValue;
+				groupIsTrue = Dialogue::Compare(*playerSpeechLevel, term.opCode, comparisonValue);
+			} else {
+				groupIsTrue = a_evaluateEngineTerm(term.conditionItem);
+			}
+		}
+		if (term.endsGroup) {
+			if (!groupIsTrue) {
+				return false;
+			}
+			groupIsTrue = false;
+		}
+	}
+	return true;
+}
\ No newline at end of file
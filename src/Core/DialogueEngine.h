@@ -0,0 +1,185 @@
+#pragma once
+
+// Everything the topic processing pipeline needs from the game, behind small interfaces with opaque handles.
+// The plugin implements them with CommonLibSSE (see CommonLibEngine.h), MemoryEngine implements them with plain data.
+namespace Dialogue
+{
+	// never defined, the adapters cast their own objects to and from these handles
+	struct Topic;
+	struct TopicInfo;
+	struct ConditionItem;
+	struct Global;
+
+	using TopicHandle = const Topic*;
+	using TopicInfoHandle = const TopicInfo*;
+	using ConditionItemHandle = const ConditionItem*;
+	using GlobalHandle = const Global*;
+
+	// only the condition functions that identify speech checks
+	enum class CONDITION_FUNCTION : std::uint8_t
+	{
+		kGetActorValue,
+		kGetBribeSuccess,
+		kGetIntimidateSuccess,
+		kGetEquipped,
+		kOther,
+	};
+
+	// only the objects a condition can run on that tell whether it runs on the player: in dialogue, the subject is the speaker and the target is the player
+	enum class CONDITION_OBJECT : std::uint8_t
+	{
+		kTarget,  // first, so value-initialized data runs on the player
+		kSubject,
+		kPlayer,  // a reference that is the player
+		kOther,
+	};
+
+	// same order as RE::CONDITION_ITEM_DATA::OpCode
+	enum class OPCODE : std::uint8_t
+	{
+		kEqualTo,
+		kNotEqualTo,
+		kGreaterThan,
+		kGreaterThanOrEqualTo,
+		kLessThan,
+		kLessThanOrEqualTo,
+	};
+
+	inline bool Compare(const float a_value, const OPCODE a_opCode, const float a_comparisonValue) noexcept
+	{
+		switch (a_opCode) {
+		case OPCODE::kEqualTo:
+			return a_value == a_comparisonValue;
+		case OPCODE::kNotEqualTo:
+			return a_value != a_comparisonValue;
+		case OPCODE::kGreaterThan:
+			return a_value > a_comparisonValue;
+		case OPCODE::kGreaterThanOrEqualTo:
+			return a_value >= a_comparisonValue;
+		case OPCODE::kLessThan:
+			return a_value < a_comparisonValue;
+		case OPCODE::kLessThanOrEqualTo:
+			return a_value <= a_comparisonValue;
+		}
+		return false;
+	}
+
+	// same order as the values of the Confidence actor value
+	enum class CONFIDENCE : std::uint8_t
+	{
+		kCowardly,
+		kCautious,
+		kAverage,
+		kBrave,
+		kFoolhardy,
+	};
+
+	// what the outcomes of intimidation and bribes depend on besides the player's speech level, see SpeechFormulas.h
+	struct SpeechCheckInputs final
+	{
+		float playerLevel;
+		float playerGold;
+		float intimidationPerkMult;  // 2 with the Intimidation perk, which makes intimidation twice as successful
+		float speakerLevel;
+		CONFIDENCE speakerConfidence;
+		// the game settings of the same name, fIntimidateConfidenceMult<Confidence> indexed by CONFIDENCE
+		float intimidateSpeechcraftCurve;
+		std::array<float, 5> intimidateConfidenceMults;
+	};
+
+	struct ConditionData final
+	{
+		CONDITION_FUNCTION function;
+		OPCODE opCode;
+		bool isOR;
+		bool isSpeech;  // GetActorValue with the Speech actor value as parameter
+		CONDITION_OBJECT object;
+		bool swapsSubjectAndTarget;
+		float comparisonValue;  // the current value of the global if the condition compares with one
+		GlobalHandle global;
+
+		bool RunsOnPlayer() const noexcept
+		{
+			switch (object) {
+			case CONDITION_OBJECT::kTarget:
+				return !swapsSubjectAndTarget;
+			case CONDITION_OBJECT::kSubject:
+				return swapsSubjectAndTarget;
+			case CONDITION_OBJECT::kPlayer:
+				return true;
+			default:
+				return false;
+			}
+		}
+	};
+
+	class ITopics
+	{
+	public:
+		virtual ~ITopics() = default;
+
+		// the full name of the topic form, which contains <BribeCost> for bribes
+		virtual std::string_view GetName(TopicHandle a_topic) const noexcept = 0;
+		virtual std::uint32_t GetNumInfos(TopicHandle a_topic) const noexcept = 0;
+		virtual TopicInfoHandle GetInfo(TopicHandle a_topic, std::uint32_t a_index) const noexcept = 0;
+	};
+
+	class ITopicInfos
+	{
+	public:
+		virtual ~ITopicInfos() = default;
+
+		virtual ConditionItemHandle GetFirstCondition(TopicInfoHandle a_topicInfo) const noexcept = 0;
+		// evaluates all conditions of the topic info for the current speaker
+		virtual bool AreConditionsTrue(TopicInfoHandle a_topicInfo) const noexcept = 0;
+	};
+
+	class IConditionItems
+	{
+	public:
+		virtual ~IConditionItems() = default;
+
+		virtual ConditionItemHandle GetNext(ConditionItemHandle a_conditionItem) const noexcept = 0;
+		virtual ConditionData GetData(ConditionItemHandle a_conditionItem) const noexcept = 0;
+		// evaluates a single condition for the current speaker
+		virtual bool IsTrue(ConditionItemHandle a_conditionItem) const noexcept = 0;
+	};
+
+	class IActorValues
+	{
+	public:
+		virtual ~IActorValues() = default;
+
+		virtual float GetPlayerSpeechLevel() const noexcept = 0;
+		// read once for the current speaker, the inputs don't change while the dialogue list is processed
+		virtual SpeechCheckInputs GetSpeechCheckInputs() const noexcept = 0;
+	};
+
+	class IGlobals
+	{
+	public:
+		virtual ~IGlobals() = default;
+
+		virtual std::uint32_t GetFormID(GlobalHandle a_global) const noexcept = 0;
+	};
+
+	class IResponseTexts
+	{
+	public:
+		virtual ~IResponseTexts() = default;
+
+		// The first response of the topic info as the current speaker would say it.
+		// Only valid until the next call, so callers that keep the text copy it.
+		virtual std::string_view GetResponseText(TopicInfoHandle a_topicInfo) const noexcept = 0;
+	};
+
+	struct Engine final
+	{
+		const ITopics& topics;
+		const ITopicInfos& topicInfos;
+		const IConditionItems& conditionItems;
+		const IActorValues& actorValues;
+		const IGlobals& globals;
+		const IResponseTexts& responseTexts;
+	};
+}
\ No newline at end of file
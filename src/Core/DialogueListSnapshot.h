@@ -0,0 +1,40 @@
+#pragma once
+
+// The dialogue list as it was left after processing, so an update of the list only needs to process the entries that were added or whose text changed.
+class DialogueListSnapshot final
+{
+public:
+	struct Entry final
+	{
+		const void* dialogue;
+		std::uint32_t topicFormID;
+		std::uint64_t textHash;     // of the processed text that was written to the dialogue
+		std::uint64_t fingerprint;  // of the cached topic
+	};
+
+	void Clear() noexcept { entries.clear(); }
+
+	// The entry of a_dialogue if it still belongs to the same topic and still has the processed text, usually at the same position as before.
+	const Entry* FindUnchanged(const std::size_t a_position, const void* a_dialogue, const std::uint32_t a_topicFormID, const std::uint64_t a_textHash) const noexcept
+	{
+		const auto isUnchanged = [&](const Entry& a_entry) {
+			return a_entry.dialogue == a_dialogue && a_entry.topicFormID == a_topicFormID && a_entry.textHash == a_textHash;
+		};
+		if (a_position < entries.size() && isUnchanged(entries[a_position])) {
+			return &entries[a_position];
+		}
+		const auto it = std::ranges::find_if(entries, isUnchanged);
+		return it != entries.end() ? std::to_address(it) : nullptr;
+	}
+
+	void Add(const Entry& a_entry) { entries.push_back(a_entry); }
+
+	std::span<const Entry> GetEntries() const noexcept { return entries; }
+	std::size_t Size() const noexcept { return entries.size(); }
+
+	// keeps the capacity of both snapshots
+	void Swap(DialogueListSnapshot& a_other) noexcept { entries.swap(a_other.entries); }
+
+private:
+	std::vector<Entry> entries;
+};
\ No newline at end of file
@@ -0,0 +1,167 @@
+#pragma once
+
+#include "HashUtil.h"
+
+template <class Key>
+struct FlatHash
+{
+	std::uint64_t operator()(const Key& a_key) const noexcept
+	{
+		static_assert(std::is_integral_v<Key> || std::is_enum_v<Key> || std::is_pointer_v<Key>, "Provide a hash for this key type");
+		if constexpr (std::is_pointer_v<Key>) {
+			return HashUtil::Mix(reinterpret_cast<std::uintptr_t>(a_key));
+		} else {
+			return HashUtil::Mix(static_cast<std::uint64_t>(a_key));
+		}
+	}
+};
+
+// Keys that are already well distributed hashes, such as topic fingerprints
+struct FlatIdentityHash
+{
+	std::uint64_t operator()(const std::uint64_t a_key) const noexcept { return a_key; }
+};
+
+// Open addressing hash map with linear probing, storing keys and values in one contiguous array.
+// A control byte per slot holds 7 bits of the hash, so most probes for missing keys don't touch the slots.
+// Elements can't be erased individually, which fits caches that are only cleared as a whole.
+template <class Key, class Value, class Hash = FlatHash<Key>>
+class FlatHashMap
+{
+public:
+	struct Slot
+	{
+		Key key;
+		Value value;
+	};
+
+	FlatHashMap() = default;
+
+	std::size_t Size() const noexcept { return size; }
+	bool Empty() const noexcept { return size == 0; }
+
+	// keeps the capacity, so refilling the map doesn't need to allocate again
+	void Clear() noexcept
+	{
+		std::fill(controls.begin(), controls.end(), kEmpty);
+		for (auto& slot : slots) {
+			slot = Slot{};
+		}
+		size = 0;
+	}
+
+	void Reserve(const std::size_t a_count)
+	{
+		if (a_count * kMaxLoadDenominator > controls.size() * kMaxLoadNumerator) {
+			rehash(std::bit_ceil(std::max<std::size_t>(a_count * kMaxLoadDenominator / kMaxLoadNumerator + 1, kMinCapacity)));
+		}
+	}
+
+	Value* Find(const Key& a_key) noexcept
+	{
+		const auto index = findIndex(a_key);
+		return index == kNotFound ? nullptr : &slots[index].value;
+	}
+
+	const Value* Find(const Key& a_key) const noexcept
+	{
+		const auto index = findIndex(a_key);
+		return index == kNotFound ? nullptr : &slots[index].value;
+	}
+
+	// Returns the value for the key, default-constructing it if the key was missing, and whether it was inserted.
+	std::pair<Value*, bool> TryEmplace(const Key& a_key)
+	{
+		Reserve(size + 1);
+		const auto hash = Hash()(a_key);
+		const auto control = controlByte(hash);
+		const auto mask = controls.size() - 1;
+		for (auto index = static_cast<std::size_t>(hash) & mask;; index = (index + 1) & mask) {
+			if (controls[index] == kEmpty) {
+				controls[index] = control;
+				slots[index].key = a_key;
+				++size;
+				return { &slots[index].value, true };
+			}
+			if (controls[index] == control && slots[index].key == a_key) {
+				return { &slots[index].value, false };
+			}
+		}
+	}
+
+	Value& InsertOrAssign(const Key& a_key, Value a_value)
+	{
+		const auto [value, inserted] = TryEmplace(a_key);
+		*value = std::move(a_value);
+		return *value;
+	}
+
+	Value& operator[](const Key& a_key) { return *TryEmplace(a_key).first; }
+
+	template <class Function>
+	void ForEach(Function&& a_function)
+	{
+		for (std::size_t i = 0; i < controls.size(); ++i) {
+			if (controls[i] != kEmpty) {
+				a_function(std::as_const(slots[i].key), slots[i].value);
+			}
+		}
+	}
+
+	template <class Function>
+	void ForEach(Function&& a_function) const
+	{
+		for (std::size_t i = 0; i < controls.size(); ++i) {
+			if (controls[i] != kEmpty) {
+				a_function(slots[i].key, slots[i].value);
+			}
+		}
+	}
+
+private:
+	static constexpr std::uint8_t kEmpty = 0;
+	static constexpr std::size_t kNotFound = SIZE_MAX;
+	static constexpr std::size_t kMinCapacity = 16;
+	static constexpr std::size_t kMaxLoadNumerator = 7;
+	static constexpr std::size_t kMaxLoadDenominator = 8;
+
+	std::vector<std::uint8_t> controls;
+	std::vector<Slot> slots;
+	std::size_t size = 0;
+
+	static std::uint8_t controlByte(const std::uint64_t a_hash) noexcept { return static_cast<std::uint8_t>(0x80 | (a_hash >> 57)); }
+
+	std::size_t findIndex(const Key& a_key) const noexcept
+	{
+		if (size == 0) {
+			return kNotFound;
+		}
+
+		const auto hash = Hash()(a_key);
+		const auto control = controlByte(hash);
+		const auto mask = controls.size() - 1;
+		for (auto index = static_cast<std::size_t>(hash) & mask;; index = (index + 1) & mask) {
+			if (controls[index] == kEmpty) {
+				return kNotFound;
+			}
+			if (controls[index] == control && slots[index].key == a_key) {
+				return index;
+			}
+		}
+	}
+
+	void rehash(const std::size_t a_capacity)
+	{
+		auto oldControls = std::move(controls);
+		auto oldSlots = std::move(slots);
+		controls.assign(a_capacity, kEmpty);
+		slots.clear();
+		slots.resize(a_capacity);
+		size = 0;
+		for (std::size_t i = 0; i < oldControls.size(); ++i) {
+			if (oldControls[i] != kEmpty) {
+				*TryEmplace(oldSlots[i].key).first = std::move(oldSlots[i].value);
+			}
+		}
+	}
+};
\ No newline at end of file
@@ -0,0 +1,179 @@
+/*
+Copyright (C) 2025 Jonathan Feenstra
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+See EXCEPTIONS for additional permissions.
+*/
+
+#include "FormatProgram.h"
+
+namespace
+{
+	std::string_view GetStringArgument(const FormatArguments& a_arguments, const std::size_t a_index) noexcept
+	{
+		switch (a_index) {
+		case 0:
+			return a_arguments.mainText;
+		case 1:
+			return a_arguments.tagText;
+		case 2:
+			return a_arguments.resultText;
+		default:
+			return a_arguments.predictedResponseText;
+		}
+	}
+}
+
+FormatProgram::FormatProgram(const std::string_view a_format)
+{
+	std::size_t nextAutomaticIndex = 0;
+	bool usesAutomaticIndexing = false;
+	bool usesManualIndexing = false;
+	std::string literal;
+
+	for (std::size_t pos = 0; pos < a_format.size();) {
+		const auto c = a_format[pos];
+		if (c == '}') {
+			if (pos + 1 < a_format.size() && a_format[pos + 1] == '}') {
+				literal += '}';
+				pos += 2;
+				continue;
+			}
+			throw std::format_error("unmatched '}' in format string");
+		}
+		if (c != '{') {
+			literal += c;
+			++pos;
+			continue;
+		}
+		if (pos + 1 < a_format.size() && a_format[pos + 1] == '{') {
+			literal += '{';
+			pos += 2;
+			continue;
+		}
+
+		const auto end = a_format.find('}', pos + 1);
+		if (end == std::string_view::npos) {
+			throw std::format_error("unmatched '{' in format string");
+		}
+
+		const auto field = a_format.substr(pos + 1, end - pos - 1);
+		if (field.find('{') != std::string_view::npos) {
+			throw std::format_error("nested replacement fields are not supported");
+		}
+
+		const auto colon = field.find(':');
+		const auto id = field.substr(0, colon);
+		const auto spec = colon == std::string_view::npos ? std::string_view{} : field.substr(colon + 1);
+
+		std::size_t index = 0;
+		if (id.empty()) {
+			if (usesManualIndexing) {
+				throw std::format_error("cannot switch from manual to automatic argument indexing");
+			}
+			usesAutomaticIndexing = true;
+			index = nextAutomaticIndex++;
+		} else {
+			if (usesAutomaticIndexing) {
+				throw std::format_error("cannot switch from automatic to manual argument indexing");
+			}
+			usesManualIndexing = true;
+			const auto [ptr, ec] = std::from_chars(id.data(), id.data() + id.size(), index);
+			if (ec != std::errc{} || ptr != id.data() + id.size()) {
+				throw std::format_error("invalid argument index in format string");
+			}
+		}
+
+		if (index >= kNumArguments) {
+			throw std::format_error("argument index out of range");
+		}
+
+		addLiteral(literal);
+		literal.clear();
+		addArgument(index, spec);
+		pos = end + 1;
+	}
+
+	addLiteral(literal);
+}
+
+void FormatProgram::Format(std::string& a_buffer, const FormatArguments& a_arguments) const
+{
+	formatTo(a_buffer, a_arguments);
+}
+
+void FormatProgram::Format(std::pmr::string& a_buffer, const FormatArguments& a_arguments) const
+{
+	formatTo(a_buffer, a_arguments);
+}
+
+template <class String>
+void FormatProgram::formatTo(String& a_buffer, const FormatArguments& a_arguments) const
+{
+	a_buffer.clear();
+	auto out = std::back_inserter(a_buffer);
+	for (const auto& token : tokens) {
+		const std::string_view tokenText(text.data() + token.offset, token.length);
+		if (token.argument == kLiteral) {
+			a_buffer.append(tokenText);
+		} else if (isNumericArgument(token.argument)) {
+			const auto value = token.argument == 3 ? a_arguments.requiredSpeechLevel : a_arguments.playerSpeechLevel;
+			if (token.hasSpec) {
+				std::vformat_to(out, tokenText, std::make_format_args(value));
+			} else {
+				std::format_to(out, "{}", value);
+			}
+		} else {
+			const auto value = GetStringArgument(a_arguments, token.argument);
+			if (token.hasSpec) {
+				std::vformat_to(out, tokenText, std::make_format_args(value));
+			} else {
+				a_buffer.append(value);
+			}
+		}
+	}
+}
+
+void FormatProgram::addLiteral(const std::string_view a_literal)
+{
+	if (a_literal.empty()) {
+		return;
+	}
+
+	tokens.push_back({ kLiteral, false, static_cast<std::uint32_t>(text.size()), static_cast<std::uint32_t>(a_literal.size()) });
+	text += a_literal;
+}
+
+void FormatProgram::addArgument(const std::size_t a_index, const std::string_view a_spec)
+{
+	usedArguments |= static_cast<std::uint8_t>(1 << a_index);
+	if (a_spec.empty()) {
+		tokens.push_back({ static_cast<std::uint8_t>(a_index), false, 0, 0 });
+		return;
+	}
+
+	// only the spec is parsed while formatting, validating it here means formatting itself won't throw
+	const auto field = "{:" + std::string(a_spec) + '}';
+	if (isNumericArgument(a_index)) {
+		const auto value = 0.0F;
+		std::ignore = std::vformat(field, std::make_format_args(value));
+	} else {
+		const auto value = ""sv;
+		std::ignore = std::vformat(field, std::make_format_args(value));
+	}
+
+	tokens.push_back({ static_cast<std::uint8_t>(a_index), true, static_cast<std::uint32_t>(text.size()), static_cast<std::uint32_t>(field.size()) });
+	text += field;
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+
+// Values for the {0}-{5} tokens of the topic and subtitle format strings (see [TopicFormats] in the INI file)
+struct FormatArguments final
+{
+	std::string_view mainText;
+	std::string_view tagText;
+	std::string_view resultText;
+	float requiredSpeechLevel;
+	std::string_view predictedResponseText;
+	float playerSpeechLevel;
+};
+
+// A format string that is parsed once into literal runs and argument slots, so formatting doesn't have to parse it again.
+class FormatProgram final
+{
+public:
+	static constexpr std::size_t kNumArguments = 6;
+
+	FormatProgram() = default;
+
+	// Throws std::format_error for the same format strings that std::vformat would reject.
+	explicit FormatProgram(const std::string_view a_format);
+
+	// Overwrites a_buffer, so a reused buffer doesn't need to reallocate.
+	void Format(std::string& a_buffer, const FormatArguments& a_arguments) const;
+	// for strings in an arena, such as the resolved subtitles of TopicDisplayTable
+	void Format(std::pmr::string& a_buffer, const FormatArguments& a_arguments) const;
+
+	bool UsesArgument(const std::size_t a_index) const noexcept { return (usedArguments >> a_index) & 1; }
+	bool IsEmpty() const noexcept { return tokens.empty(); }
+
+private:
+	static constexpr std::uint8_t kLiteral = UINT8_MAX;
+
+	struct Token final
+	{
+		std::uint8_t argument;  // index of the argument or kLiteral
+		bool hasSpec;           // if true, the text is a replacement field with a format spec, otherwise the literal text
+		std::uint32_t offset;
+		std::uint32_t length;
+	};
+
+	std::vector<Token> tokens;
+	std::string text;
+	std::uint8_t usedArguments = 0;
+
+	static bool isNumericArgument(const std::size_t a_index) noexcept { return a_index == 3 || a_index == 5; }
+
+	template <class String>
+	void formatTo(String& a_buffer, const FormatArguments& a_arguments) const;
+
+	void addLiteral(const std::string_view a_literal);
+	void addArgument(const std::size_t a_index, const std::string_view a_spec);
+};
\ No newline at end of file
@@ -0,0 +1,100 @@
+/*
+Copyright (C) 2025 Jonathan Feenstra
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+See EXCEPTIONS for additional permissions.
+*/
+
+#include "HashUtil.h"
+
+namespace
+{
+	constexpr std::uint64_t kSecret0 = 0xa0761d6478bd642f;
+	constexpr std::uint64_t kSecret1 = 0xe7037ed1a0b428db;
+	constexpr std::uint64_t kSecret2 = 0x8ebc6af09c88c6e3;
+	constexpr std::uint64_t kSecret3 = 0x589965cc75374cc3;
+
+	std::uint64_t Read64(const unsigned char* a_data) noexcept
+	{
+		std::uint64_t value;
+		std::memcpy(&value, a_data, sizeof(value));
+		return value;
+	}
+
+	std::uint64_t Read32(const unsigned char* a_data) noexcept
+	{
+		std::uint32_t value;
+		std::memcpy(&value, a_data, sizeof(value));
+		return value;
+	}
+}
+
+namespace HashUtil
+{
+	std::uint64_t Hash(const std::string_view a_text, std::uint64_t a_seed) noexcept
+	{
+		auto data = reinterpret_cast<const unsigned char*>(a_text.data());
+		const auto length = a_text.size();
+		a_seed ^= MulFold(a_seed ^ kSecret0, kSecret1);
+
+		std::uint64_t a;
+		std::uint64_t b;
+		if (length <= 16) {
+			if (length >= 4) {
+				const auto offset = (length >> 3) << 2;
+				a = (Read32(data) << 32) | Read32(data + offset);
+				b = (Read32(data + length - 4) << 32) | Read32(data + length - 4 - offset);
+			} else if (length > 0) {
+				a = (static_cast<std::uint64_t>(data[0]) << 16) | (static_cast<std::uint64_t>(data[length >> 1]) << 8) | data[length - 1];
+				b = 0;
+			} else {
+				a = 0;
+				b = 0;
+			}
+		} else {
+			auto remaining = length;
+			if (remaining > 48) {
+				auto seed1 = a_seed;
+				auto seed2 = a_seed;
+				do {
+					a_seed = MulFold(Read64(data) ^ kSecret1, Read64(data + 8) ^ a_seed);
+					seed1 = MulFold(Read64(data + 16) ^ kSecret2, Read64(data + 24) ^ seed1);
+					seed2 = MulFold(Read64(data + 32) ^ kSecret3, Read64(data + 40) ^ seed2);
+					data += 48;
+					remaining -= 48;
+				} while (remaining > 48);
+				a_seed ^= seed1 ^ seed2;
+			}
+			while (remaining > 16) {
+				a_seed = MulFold(Read64(data) ^ kSecret1, Read64(data + 8) ^ a_seed);
+				data += 16;
+				remaining -= 16;
+			}
+			a = Read64(data + remaining - 16);
+			b = Read64(data + remaining - 8);
+		}
+
+		a ^= kSecret1;
+		b ^= a_seed;
+#if defined(_MSC_VER) && defined(_M_X64)
+		a = _umul128(a, b, &b);
+#else
+		const auto product = static_cast<unsigned __int128>(a) * b;
+		a = static_cast<std::uint64_t>(product);
+		b = static_cast<std::uint64_t>(product >> 64);
+#endif
+		return MulFold(a ^ kSecret0 ^ length, b ^ kSecret1);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+#pragma once
+
+namespace HashUtil
+{
+	// 64x64 -> 128 bit multiplication, folded back to 64 bits by xoring the halves
+	inline std::uint64_t MulFold(const std::uint64_t a_lhs, const std::uint64_t a_rhs) noexcept
+	{
+#if defined(_MSC_VER) && defined(_M_X64)
+		std::uint64_t high;
+		const auto low = _umul128(a_lhs, a_rhs, &high);
+		return low ^ high;
+#else
+		const auto product = static_cast<unsigned __int128>(a_lhs) * a_rhs;
+		return static_cast<std::uint64_t>(product) ^ static_cast<std::uint64_t>(product >> 64);
+#endif
+	}
+
+	// Finalizes integer keys such as form IDs, which are not well distributed by themselves.
+	inline std::uint64_t Mix(const std::uint64_t a_value) noexcept
+	{
+		return MulFold(a_value ^ 0xa0761d6478bd642f, 0xe7037ed1a0b428db);
+	}
+
+	// Hashes 8 or 16 bytes per multiplication, in the style of wyhash.
+	std::uint64_t Hash(const std::string_view a_text, std::uint64_t a_seed = 0) noexcept;
+
+	// Identifies a processed topic by its form ID, the speaker and the hash of its text.
+	inline std::uint64_t Fingerprint(const std::uint32_t a_topicFormID, const std::uint32_t a_speakerFormID, const std::uint64_t a_textHash) noexcept
+	{
+		return MulFold(a_textHash ^ 0x8ebc6af09c88c6e3, ((static_cast<std::uint64_t>(a_topicFormID) << 32) | a_speakerFormID) ^ 0x589965cc75374cc3);
+	}
+}
\ No newline at end of file
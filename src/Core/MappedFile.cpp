@@ -0,0 +1,112 @@
+/*
+Copyright (C) 2025 Jonathan Feenstra
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+See EXCEPTIONS for additional permissions.
+*/
+
+#include "MappedFile.h"
+
+#if defined(_WIN32)
+#	include <Windows.h>
+#else
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+MappedFile::MappedFile(MappedFile&& a_other) noexcept :
+	data(std::exchange(a_other.data, nullptr)),
+	size(std::exchange(a_other.size, 0))
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& a_other) noexcept
+{
+	if (this != &a_other) {
+		Close();
+		data = std::exchange(a_other.data, nullptr);
+		size = std::exchange(a_other.size, 0);
+	}
+	return *this;
+}
+
+bool MappedFile::Open(const std::filesystem::path& a_path) noexcept
+{
+	Close();
+
+#if defined(_WIN32)
+	const auto file = ::CreateFileW(a_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	LARGE_INTEGER fileSize{};
+	HANDLE mapping = nullptr;
+	if (::GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+		mapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	}
+	::CloseHandle(file);
+	if (!mapping) {
+		return false;
+	}
+
+	// the view keeps the mapping alive
+	const auto view = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	::CloseHandle(mapping);
+	if (!view) {
+		return false;
+	}
+
+	data = static_cast<const std::byte*>(view);
+	size = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+	const auto file = ::open(a_path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (file < 0) {
+		return false;
+	}
+
+	struct stat status{};
+	void* view = MAP_FAILED;
+	if (::fstat(file, &status) == 0 && status.st_size > 0) {
+		view = ::mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+	}
+	::close(file);
+	if (view == MAP_FAILED) {
+		return false;
+	}
+
+	data = static_cast<const std::byte*>(view);
+	size = static_cast<std::size_t>(status.st_size);
+#endif
+
+	return true;
+}
+
+void MappedFile::Close() noexcept
+{
+	if (!data) {
+		return;
+	}
+
+#if defined(_WIN32)
+	::UnmapViewOfFile(data);
+#else
+	::munmap(const_cast<std::byte*>(data), size);
+#endif
+	data = nullptr;
+	size = 0;
+}
\ No newline at end of file
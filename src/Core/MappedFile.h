@@ -0,0 +1,25 @@
+#pragma once
+
+// A file mapped read-only into memory, so it can be used without reading or parsing it first.
+class MappedFile final
+{
+public:
+	MappedFile() = default;
+	~MappedFile() { Close(); }
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile(MappedFile&& a_other) noexcept;
+	MappedFile& operator=(const MappedFile&) = delete;
+	MappedFile& operator=(MappedFile&& a_other) noexcept;
+
+	// false if the file doesn't exist, is empty or can't be mapped
+	bool Open(const std::filesystem::path& a_path) noexcept;
+	void Close() noexcept;
+
+	std::span<const std::byte> GetData() const noexcept { return { data, size }; }
+	bool IsOpen() const noexcept { return data != nullptr; }
+
+private:
+	const std::byte* data = nullptr;
+	std::size_t size = 0;
+};
\ No newline at end of file
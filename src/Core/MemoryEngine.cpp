@@ -0,0 +1,122 @@
+/*
+Copyright (C) 2025 Jonathan Feenstra
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+See EXCEPTIONS for additional permissions.
+*/
+
+#include "MemoryEngine.h"
+
+namespace
+{
+	const MemoryEngine::Topic* ToTopic(const Dialogue::TopicHandle a_topic) noexcept
+	{
+		return reinterpret_cast<const MemoryEngine::Topic*>(a_topic);
+	}
+
+	const MemoryEngine::TopicInfo* ToTopicInfo(const Dialogue::TopicInfoHandle a_topicInfo) noexcept
+	{
+		return reinterpret_cast<const MemoryEngine::TopicInfo*>(a_topicInfo);
+	}
+
+	const MemoryEngine::Condition* ToCondition(const Dialogue::ConditionItemHandle a_conditionItem) noexcept
+	{
+		return reinterpret_cast<const MemoryEngine::Condition*>(a_conditionItem);
+	}
+}
+
+Dialogue::TopicHandle MemoryEngine::AddTopic(Topic a_topic)
+{
+	auto& topic = topics.emplace_back(std::move(a_topic));
+	for (auto& info : topic.infos) {
+		for (std::size_t i = 0; i + 1 < info.conditions.size(); ++i) {
+			info.conditions[i].next = &info.conditions[i + 1];
+		}
+		if (!info.conditions.empty()) {
+			info.conditions.back().next = nullptr;
+		}
+	}
+	return reinterpret_cast<Dialogue::TopicHandle>(&topic);
+}
+
+Dialogue::GlobalHandle MemoryEngine::AddGlobal(const float a_value, const std::uint32_t a_formID)
+{
+	return reinterpret_cast<Dialogue::GlobalHandle>(&globals.emplace_back(a_value, a_formID));
+}
+
+void MemoryEngine::SetGlobal(const Dialogue::GlobalHandle a_global, const float a_value) noexcept
+{
+	const_cast<Global*>(reinterpret_cast<const Global*>(a_global))->value = a_value;
+}
+
+std::string_view MemoryEngine::GetName(const Dialogue::TopicHandle a_topic) const noexcept
+{
+	return ToTopic(a_topic)->name;
+}
+
+std::uint32_t MemoryEngine::GetNumInfos(const Dialogue::TopicHandle a_topic) const noexcept
+{
+	return static_cast<std::uint32_t>(ToTopic(a_topic)->infos.size());
+}
+
+Dialogue::TopicInfoHandle MemoryEngine::GetInfo(const Dialogue::TopicHandle a_topic, const std::uint32_t a_index) const noexcept
+{
+	return reinterpret_cast<Dialogue::TopicInfoHandle>(&ToTopic(a_topic)->infos[a_index]);
+}
+
+Dialogue::ConditionItemHandle MemoryEngine::GetFirstCondition(const Dialogue::TopicInfoHandle a_topicInfo) const noexcept
+{
+	const auto& conditions = ToTopicInfo(a_topicInfo)->conditions;
+	return conditions.empty() ? nullptr : reinterpret_cast<Dialogue::ConditionItemHandle>(conditions.data());
+}
+
+bool MemoryEngine::AreConditionsTrue(const Dialogue::TopicInfoHandle a_topicInfo) const noexcept
+{
+	return ToTopicInfo(a_topicInfo)->conditionsTrue;
+}
+
+Dialogue::ConditionItemHandle MemoryEngine::GetNext(const Dialogue::ConditionItemHandle a_conditionItem) const noexcept
+{
+	return reinterpret_cast<Dialogue::ConditionItemHandle>(ToCondition(a_conditionItem)->next);
+}
+
+Dialogue::ConditionData MemoryEngine::GetData(const Dialogue::ConditionItemHandle a_conditionItem) const noexcept
+{
+	auto data = ToCondition(a_conditionItem)->data;
+	if (data.global) {
+		data.comparisonValue = reinterpret_cast<const Global*>(data.global)->value;
+	}
+	return data;
+}
+
+bool MemoryEngine::IsTrue(const Dialogue::ConditionItemHandle a_conditionItem) const noexcept
+{
+	const auto condition = ToCondition(a_conditionItem);
+	if (condition->data.isSpeech && condition->data.RunsOnPlayer()) {
+		const auto data = GetData(a_conditionItem);
+		return Dialogue::Compare(playerSpeechLevel, data.opCode, data.comparisonValue);
+	}
+	return condition->isTrue;
+}
+
+std::uint32_t MemoryEngine::GetFormID(const Dialogue::GlobalHandle a_global) const noexcept
+{
+	return reinterpret_cast<const Global*>(a_global)->formID;
+}
+
+std::string_view MemoryEngine::GetResponseText(const Dialogue::TopicInfoHandle a_topicInfo) const noexcept
+{
+	return ToTopicInfo(a_topicInfo)->responseText;
+}
\ No newline at end of file
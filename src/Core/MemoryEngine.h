@@ -0,0 +1,83 @@
+#pragma once
+
+#include "DialogueEngine.h"
+
+// Implements the dialogue engine interfaces with plain data instead of game forms,
+// so the topic processing pipeline can be run, profiled and sanitized on any platform.
+class MemoryEngine final :
+	public Dialogue::ITopics,
+	public Dialogue::ITopicInfos,
+	public Dialogue::IConditionItems,
+	public Dialogue::IActorValues,
+	public Dialogue::IGlobals,
+	public Dialogue::IResponseTexts
+{
+public:
+	struct Condition final
+	{
+		Dialogue::ConditionData data;
+		bool isTrue;  // ignored for Speech conditions on the player, which are evaluated against the player's speech level
+		const Condition* next;
+	};
+
+	struct TopicInfo final
+	{
+		std::vector<Condition> conditions;
+		bool conditionsTrue;
+		std::string responseText;
+	};
+
+	struct Topic final
+	{
+		std::string name;
+		std::vector<TopicInfo> infos;
+	};
+
+	// topics are stored with stable addresses, so the returned handle stays valid for the lifetime of the engine
+	Dialogue::TopicHandle AddTopic(Topic a_topic);
+	// globals referenced by Dialogue::ConditionData::global, a_formID identifies them in serialized data
+	Dialogue::GlobalHandle AddGlobal(float a_value, std::uint32_t a_formID);
+	void SetGlobal(Dialogue::GlobalHandle a_global, float a_value) noexcept;
+
+	void SetPlayerSpeechLevel(float a_playerSpeechLevel) noexcept { playerSpeechLevel = a_playerSpeechLevel; }
+	void SetSpeechCheckInputs(const Dialogue::SpeechCheckInputs& a_speechCheckInputs) noexcept { speechCheckInputs = a_speechCheckInputs; }
+
+	Dialogue::Engine GetEngine() const noexcept { return { *this, *this, *this, *this, *this, *this }; }
+
+	// ITopics
+	std::string_view GetName(Dialogue::TopicHandle a_topic) const noexcept override;
+	std::uint32_t GetNumInfos(Dialogue::TopicHandle a_topic) const noexcept override;
+	Dialogue::TopicInfoHandle GetInfo(Dialogue::TopicHandle a_topic, std::uint32_t a_index) const noexcept override;
+
+	// ITopicInfos
+	Dialogue::ConditionItemHandle GetFirstCondition(Dialogue::TopicInfoHandle a_topicInfo) const noexcept override;
+	bool AreConditionsTrue(Dialogue::TopicInfoHandle a_topicInfo) const noexcept override;
+
+	// IConditionItems
+	Dialogue::ConditionItemHandle GetNext(Dialogue::ConditionItemHandle a_conditionItem) const noexcept override;
+	Dialogue::ConditionData GetData(Dialogue::ConditionItemHandle a_conditionItem) const noexcept override;
+	bool IsTrue(Dialogue::ConditionItemHandle a_conditionItem) const noexcept override;
+
+	// IActorValues
+	float GetPlayerSpeechLevel() const noexcept override { return playerSpeechLevel; }
+	Dialogue::SpeechCheckInputs GetSpeechCheckInputs() const noexcept override { return speechCheckInputs; }
+
+	// IGlobals
+	std::uint32_t GetFormID(Dialogue::GlobalHandle a_global) const noexcept override;
+
+	// IResponseTexts
+	std::string_view GetResponseText(Dialogue::TopicInfoHandle a_topicInfo) const noexcept override;
+
+private:
+	struct Global final
+	{
+		float value;
+		std::uint32_t formID;
+	};
+
+	std::deque<Topic> topics;
+	std::deque<Global> globals;
+	float playerSpeechLevel = 15.0F;
+	// a new level 1 character facing an average level 1 speaker
+	Dialogue::SpeechCheckInputs speechCheckInputs{ 1.0F, 0.0F, 1.0F, 1.0F, Dialogue::CONFIDENCE::kAverage, 1.0F, { 1.0F, 1.0F, 1.0F, 1.0F, 1.0F } };
+};
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "SubtitlePresenter.h"
+
+namespace Scaleform
+{
+	// A topic list and subtitle field without a movie, which counts the calls that would go through GFx values,
+	// so the cost of showing subtitles can be checked without the game.
+	class MemorySubtitleView final : public ISubtitleView
+	{
+	public:
+		struct CallCounts final
+		{
+			std::uint32_t getEntryText;
+			std::uint32_t getSubtitleText;
+			std::uint32_t getResponseText;
+			std::uint32_t createString;
+			std::uint32_t setText;
+			std::uint32_t setTextColor;
+		};
+
+		std::vector<std::string> entries;                         // the texts of EntriesA
+		std::string subtitle;                                     // the text of the subtitle field
+		const Dialogue::IResponseTexts* responseTexts = nullptr;  // of the engine the deferred subtitles of the table refer to
+		CallCounts callCounts{};
+
+		const char* GetEntryText(const std::uint32_t a_entryIndex) noexcept override
+		{
+			++callCounts.getEntryText;
+			return a_entryIndex < entries.size() ? entries[a_entryIndex].c_str() : nullptr;
+		}
+
+		const char* GetSubtitleText() noexcept override
+		{
+			++callCounts.getSubtitleText;
+			return subtitle.c_str();
+		}
+
+		std::string_view GetResponseText(const Dialogue::TopicInfoHandle a_responseInfo) noexcept override
+		{
+			++callCounts.getResponseText;
+			return responseTexts ? responseTexts->GetResponseText(a_responseInfo) : std::string_view();
+		}
+
+		void CreateSubtitle(const std::uint32_t a_slot, const char* a_text) noexcept override
+		{
+			++callCounts.createString;
+			if (a_slot >= strings.size()) {
+				strings.resize(a_slot + 1);
+			}
+			strings[a_slot] = a_text;
+		}
+
+		void ShowSubtitle(const std::uint32_t a_slot) noexcept override
+		{
+			++callCounts.setText;
+			subtitle = strings[a_slot];
+		}
+
+		void ApplySubtitleColor() noexcept override { ++callCounts.setTextColor; }
+
+		// like ShowDialogueText, which shows the response of the game
+		void ShowGameSubtitle(SubtitlePresenter& a_presenter, const std::string_view a_text)
+		{
+			subtitle = a_text;
+			a_presenter.OnGameSubtitleShown();
+		}
+
+	private:
+		std::vector<std::string> strings;  // the strings created in the movie, by slot
+	};
+}
\ No newline at end of file
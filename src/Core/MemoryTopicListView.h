@@ -0,0 +1,61 @@
+#pragma once
+
+#include "TopicListColors.h"
+
+namespace Scaleform
+{
+	// A topic list without a movie, which counts the calls that would go through GFx values,
+	// so the cost of colouring the list can be checked without the game.
+	class MemoryTopicListView final : public ITopicListView
+	{
+	public:
+		struct EntryClip final
+		{
+			std::optional<std::string> text;  // empty if the clip doesn't show an entry
+			bool isNew = true;
+			std::uint32_t color = 0xFFFFFF;
+		};
+
+		std::vector<EntryClip> clips;
+		std::uint32_t scrollPosition = 0;  // the index in EntriesA of the entry the first clip shows
+		std::int32_t selectedIndex = -1;
+		std::uint32_t numCalls = 0;  // every call crosses into the movie
+
+		std::uint32_t GetNumEntryClips() noexcept override
+		{
+			++numCalls;
+			return static_cast<std::uint32_t>(clips.size());
+		}
+
+		const char* GetEntryText(const std::uint32_t a_clipIndex) noexcept override
+		{
+			++numCalls;
+			const auto& text = clips[a_clipIndex].text;
+			return text ? text->c_str() : nullptr;
+		}
+
+		bool IsEntryNew(const std::uint32_t a_clipIndex) noexcept override
+		{
+			++numCalls;
+			return clips[a_clipIndex].isNew;
+		}
+
+		void SetEntryColor(const std::uint32_t a_clipIndex, const std::uint32_t a_color) noexcept override
+		{
+			++numCalls;
+			clips[a_clipIndex].color = a_color;
+		}
+
+		std::uint32_t GetEntryClipIndex(const std::uint32_t a_entryIndex) noexcept override
+		{
+			++numCalls;
+			return a_entryIndex >= scrollPosition && a_entryIndex - scrollPosition < clips.size() && clips[a_entryIndex - scrollPosition].text ? a_entryIndex - scrollPosition : kNoClip;
+		}
+
+		std::int32_t GetSelectedIndex() noexcept override
+		{
+			++numCalls;
+			return selectedIndex;
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,329 @@
+/*
+Copyright (C) 2025 Jonathan Feenstra
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+See EXCEPTIONS for additional permissions.
+*/
+
+#include "Profiler.h"
+
+namespace Profiler
+{
+	namespace
+	{
+		constexpr std::size_t kNumStages = static_cast<std::size_t>(STAGE::kTotal);
+
+		// Bounded queue for several producers and the writer thread as consumer. Every slot has a sequence number that
+		// tells whose turn it is, so neither side needs a lock: https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+		class EventRing final
+		{
+		public:
+			struct Event final
+			{
+				std::uint64_t start;
+				std::uint64_t duration;
+				std::uint32_t threadID;
+				STAGE stage;
+			};
+
+			EventRing() :
+				slots(std::make_unique<Slot[]>(kCapacity))
+			{
+				for (std::uint64_t index = 0; index < kCapacity; ++index) {
+					slots[index].sequence.store(index, std::memory_order_relaxed);
+				}
+			}
+
+			// false if the ring is full
+			bool TryPush(const Event& a_event) noexcept
+			{
+				auto index = writeIndex.load(std::memory_order_relaxed);
+				for (;;) {
+					auto& slot = slots[index & kMask];
+					const auto sequence = slot.sequence.load(std::memory_order_acquire);
+					const auto difference = static_cast<std::int64_t>(sequence - index);
+					if (difference == 0) {
+						if (writeIndex.compare_exchange_weak(index, index + 1, std::memory_order_relaxed)) {
+							slot.event = a_event;
+							slot.sequence.store(index + 1, std::memory_order_release);
+							return true;
+						}
+					} else if (difference < 0) {
+						return false;
+					} else {
+						index = writeIndex.load(std::memory_order_relaxed);
+					}
+				}
+			}
+
+			// only called by the writer thread
+			bool TryPop(Event& a_event) noexcept
+			{
+				auto& slot = slots[readIndex & kMask];
+				if (slot.sequence.load(std::memory_order_acquire) != readIndex + 1) {
+					return false;
+				}
+				a_event = slot.event;
+				slot.sequence.store(readIndex + kCapacity, std::memory_order_release);
+				++readIndex;
+				return true;
+			}
+
+		private:
+			static constexpr std::uint64_t kCapacity = 1 << 16;
+			static constexpr std::uint64_t kMask = kCapacity - 1;
+
+			struct Slot final
+			{
+				std::atomic<std::uint64_t> sequence;
+				Event event;
+			};
+
+			std::unique_ptr<Slot[]> slots;
+			alignas(64) std::atomic<std::uint64_t> writeIndex{ 0 };
+			alignas(64) std::uint64_t readIndex = 0;
+		};
+
+		// Log-linear buckets with 4 sub-buckets per power of two, so percentiles are at most 25% too high.
+		class Histogram final
+		{
+		public:
+			void Add(const std::uint64_t a_duration) noexcept
+			{
+				counts[bucketIndex(a_duration)].fetch_add(1, std::memory_order_relaxed);
+				auto max = maxDuration.load(std::memory_order_relaxed);
+				while (a_duration > max && !maxDuration.compare_exchange_weak(max, a_duration, std::memory_order_relaxed)) {
+				}
+			}
+
+			Percentiles GetPercentiles() const noexcept
+			{
+				std::array<std::uint64_t, kNumBuckets> snapshot;
+				std::uint64_t total = 0;
+				for (std::size_t bucket = 0; bucket < kNumBuckets; ++bucket) {
+					snapshot[bucket] = counts[bucket].load(std::memory_order_relaxed);
+					total += snapshot[bucket];
+				}
+
+				const auto max = maxDuration.load(std::memory_order_relaxed);
+				const auto percentile = [&](const std::uint64_t a_rank) {
+					std::uint64_t cumulative = 0;
+					for (std::size_t bucket = 0; bucket < kNumBuckets; ++bucket) {
+						cumulative += snapshot[bucket];
+						if (cumulative >= a_rank) {
+							return std::min(bucketUpperBound(bucket), max);
+						}
+					}
+					return max;
+				};
+				// the smallest duration that at least 50% or 99% of the samples don't exceed
+				return { total, percentile((total + 1) / 2), percentile((total * 99 + 99) / 100), max };
+			}
+
+			void Reset() noexcept
+			{
+				for (auto& count : counts) {
+					count.store(0, std::memory_order_relaxed);
+				}
+				maxDuration.store(0, std::memory_order_relaxed);
+			}
+
+		private:
+			static constexpr std::size_t kNumBuckets = 63 * 4;
+
+			static std::size_t bucketIndex(const std::uint64_t a_duration) noexcept
+			{
+				if (a_duration < 4) {
+					return static_cast<std::size_t>(a_duration);
+				}
+				const auto width = static_cast<std::size_t>(std::bit_width(a_duration));
+				return (width - 2) * 4 + ((a_duration >> (width - 3)) & 3);
+			}
+
+			static std::uint64_t bucketUpperBound(const std::size_t a_bucket) noexcept
+			{
+				if (a_bucket < 4) {
+					return a_bucket;
+				}
+				const auto shift = a_bucket / 4 - 1;
+				return ((4 + a_bucket % 4 + std::uint64_t{ 1 }) << shift) - 1;
+			}
+
+			std::array<std::atomic<std::uint64_t>, kNumBuckets> counts{};
+			std::atomic<std::uint64_t> maxDuration{ 0 };
+		};
+
+		struct State final
+		{
+			EventRing ring;
+			std::array<Histogram, kNumStages> histograms;
+			std::atomic<std::uint64_t> numDroppedEvents{ 0 };
+			std::uint64_t startTime = 0;
+
+			std::mutex mutex;
+			std::condition_variable_any wakeUp;
+			std::jthread writer;
+			std::ofstream trace;
+			bool hasWrittenEvent = false;
+		};
+
+		// never destroyed, so the writer thread isn't joined while the game unloads the plugin
+		State& GetState()
+		{
+			static const auto state = new State();
+			return *state;
+		}
+
+		std::uint32_t GetThreadID() noexcept
+		{
+			static thread_local const auto threadID = static_cast<std::uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id()));
+			return threadID;
+		}
+
+		// microseconds with nanosecond precision, as the trace event format expects
+		void WriteMicroseconds(std::ostream& a_stream, const std::uint64_t a_nanoseconds)
+		{
+			std::array<char, 4> fraction{ '.', '0', '0', '0' };
+			std::to_chars(fraction.data() + 1 + (a_nanoseconds % 1000 < 100) + (a_nanoseconds % 1000 < 10), fraction.data() + fraction.size(), a_nanoseconds % 1000);
+			a_stream << a_nanoseconds / 1000;
+			a_stream.write(fraction.data(), fraction.size());
+		}
+
+		void WriteEvents(State& a_state)
+		{
+			EventRing::Event event;
+			auto wroteAny = false;
+			while (a_state.ring.TryPop(event)) {
+				auto& trace = a_state.trace;
+				trace << (a_state.hasWrittenEvent ? ",\n" : "\n");
+				trace << R"({"name":")" << GetStageName(event.stage) << R"(","cat":"PredictablePersuasion","ph":"X","pid":1,"tid":)" << event.threadID << R"(,"ts":)";
+				WriteMicroseconds(trace, event.start - a_state.startTime);
+				trace << R"(,"dur":)";
+				WriteMicroseconds(trace, event.duration);
+				trace << '}';
+				a_state.hasWrittenEvent = true;
+				wroteAny = true;
+			}
+			if (wroteAny) {
+				a_state.trace.flush();
+			}
+		}
+
+		void RunWriter(const std::stop_token a_stopToken)
+		{
+			auto& state = GetState();
+			while (!a_stopToken.stop_requested()) {
+				{
+					std::unique_lock lock(state.mutex);
+					state.wakeUp.wait_for(lock, a_stopToken, std::chrono::milliseconds(100), [] { return false; });
+				}
+				WriteEvents(state);
+			}
+			WriteEvents(state);
+		}
+	}
+
+	const char* GetStageName(const STAGE a_stage) noexcept
+	{
+		switch (a_stage) {
+		case STAGE::kProcessMessage:
+			return "ProcessMessage";
+		case STAGE::kProcessTopic:
+			return "ProcessTopic";
+		case STAGE::kTagMatch:
+			return "TagMatch";
+		case STAGE::kConditions:
+			return "Conditions";
+		case STAGE::kResponseText:
+			return "ResponseText";
+		case STAGE::kFormat:
+			return "Format";
+		case STAGE::kShowModSubtitle:
+			return "ShowModSubtitle";
+		case STAGE::kColorEntries:
+			return "ColorEntries";
+		case STAGE::kPrefetch:
+			return "Prefetch";
+		default:
+			return "Unknown";
+		}
+	}
+
+	bool Start(const std::filesystem::path& a_tracePath)
+	{
+		auto& state = GetState();
+		if (state.writer.joinable()) {
+			return true;
+		}
+
+		// the JSON array format of trace events doesn't need the closing bracket, which is only written by Stop
+		state.trace.open(a_tracePath, std::ios::out | std::ios::trunc);
+		if (!state.trace) {
+			return false;
+		}
+		state.trace << '[';
+		state.hasWrittenEvent = false;
+		state.startTime = Now();
+		state.writer = std::jthread(RunWriter);
+		detail::isRecording.store(true, std::memory_order_relaxed);
+		return true;
+	}
+
+	void Stop() noexcept
+	{
+		auto& state = GetState();
+		detail::isRecording.store(false, std::memory_order_relaxed);
+		if (!state.writer.joinable()) {
+			return;
+		}
+
+		state.writer.request_stop();
+		state.writer.join();
+		state.trace << "\n]\n";
+		state.trace.close();
+	}
+
+	std::uint64_t Now() noexcept
+	{
+		return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	void Record(const STAGE a_stage, const std::uint64_t a_start, const std::uint64_t a_end) noexcept
+	{
+		auto& state = GetState();
+		const auto duration = a_end - a_start;
+		state.histograms[static_cast<std::size_t>(a_stage)].Add(duration);
+		if (!state.ring.TryPush({ a_start, duration, GetThreadID(), a_stage })) {
+			state.numDroppedEvents.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	Percentiles GetSessionPercentiles(const STAGE a_stage) noexcept
+	{
+		return GetState().histograms[static_cast<std::size_t>(a_stage)].GetPercentiles();
+	}
+
+	void ResetSession() noexcept
+	{
+		for (auto& histogram : GetState().histograms) {
+			histogram.Reset();
+		}
+	}
+
+	std::uint64_t GetNumDroppedEvents() noexcept
+	{
+		return GetState().numDroppedEvents.load(std::memory_order_relaxed);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,88 @@
+#pragma once
+
+// Scoped timers for the stages of topic processing and the Scaleform handlers.
+// PROFILE_STAGE expands to nothing unless the ENABLE_PROFILING CMake option defines PP_ENABLE_PROFILING.
+// Even then, timers only record while the profiler is started, which the plugin does if bEnableProfiling is set.
+namespace Profiler
+{
+	enum class STAGE : std::uint8_t
+	{
+		kProcessMessage,
+		kProcessTopic,
+		kTagMatch,
+		kConditions,
+		kResponseText,
+		kFormat,
+		kShowModSubtitle,
+		kColorEntries,
+		kPrefetch,
+		kTotal,
+	};
+
+	struct Percentiles final
+	{
+		std::uint64_t count;
+		// upper bounds of the histogram buckets they fall into, which are at most 25% too high
+		std::uint64_t p50Nanoseconds;
+		std::uint64_t p99Nanoseconds;
+		std::uint64_t maxNanoseconds;  // exact
+	};
+
+	namespace detail
+	{
+		inline std::atomic_bool isRecording{ false };
+	}
+
+	const char* GetStageName(const STAGE a_stage) noexcept;
+
+	// Starts a thread that writes the recorded timers to a_tracePath as Chrome trace events, which can be opened in
+	// chrome://tracing or ui.perfetto.dev. The file stays readable if the game exits without calling Stop.
+	bool Start(const std::filesystem::path& a_tracePath);
+	void Stop() noexcept;
+	inline bool IsRecording() noexcept { return detail::isRecording.load(std::memory_order_relaxed); }
+
+	std::uint64_t Now() noexcept;
+	void Record(const STAGE a_stage, const std::uint64_t a_start, const std::uint64_t a_end) noexcept;
+
+	// since the last call to ResetSession, e.g. for a single dialogue
+	Percentiles GetSessionPercentiles(const STAGE a_stage) noexcept;
+	void ResetSession() noexcept;
+	// events that didn't fit into the ring buffer before the writer thread emptied it
+	std::uint64_t GetNumDroppedEvents() noexcept;
+
+	class ScopedTimer final
+	{
+	public:
+		explicit ScopedTimer(const STAGE a_stage) noexcept :
+			stage(a_stage),
+			isRecording(IsRecording()),
+			start(isRecording ? Now() : 0)
+		{
+		}
+
+		~ScopedTimer()
+		{
+			if (isRecording) {
+				Record(stage, start, Now());
+			}
+		}
+
+		ScopedTimer(const ScopedTimer&) = delete;
+		ScopedTimer(ScopedTimer&&) = delete;
+		void operator=(const ScopedTimer&) = delete;
+		void operator=(ScopedTimer&&) = delete;
+
+	private:
+		STAGE stage;
+		bool isRecording;
+		std::uint64_t start;
+	};
+}
+
+#ifdef PP_ENABLE_PROFILING
+#	define PROFILE_CONCAT_IMPL(a_lhs, a_rhs) a_lhs##a_rhs
+#	define PROFILE_CONCAT(a_lhs, a_rhs) PROFILE_CONCAT_IMPL(a_lhs, a_rhs)
+#	define PROFILE_STAGE(a_stage) const Profiler::ScopedTimer PROFILE_CONCAT(profileTimer, __LINE__)(Profiler::STAGE::a_stage)
+#else
+#	define PROFILE_STAGE(a_stage) static_cast<void>(0)
+#endif
\ No newline at end of file
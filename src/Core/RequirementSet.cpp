@@ -0,0 +1,122 @@
+/*
+Copyright (C) 2025 Jonathan Feenstra
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+See EXCEPTIONS for additional permissions.
+*/
+
+#include "RequirementSet.h"
+
+namespace RequirementSet
+{
+	namespace
+	{
+		std::string_view Trim(std::string_view a_text) noexcept
+		{
+			const auto first = a_text.find_first_not_of(" \t");
+			if (first == std::string_view::npos) {
+				return {};
+			}
+			return a_text.substr(first, a_text.find_last_not_of(" \t") - first + 1);
+		}
+
+		[[noreturn]] void Fail(const std::string_view a_reason, const std::string_view a_item)
+		{
+			throw std::invalid_argument(std::string(a_reason) + " in \"" + std::string(a_item) + '"');
+		}
+
+		void ParseForm(const std::string_view a_form, const std::string_view a_item, Requirement& a_requirement)
+		{
+			auto formID = a_form;
+			if (const auto separator = a_form.find('|'); separator != std::string_view::npos) {
+				a_requirement.plugin = Trim(a_form.substr(0, separator));
+				formID = Trim(a_form.substr(separator + 1));
+				if (a_requirement.plugin.empty()) {
+					Fail("missing plugin name", a_item);
+				}
+			}
+			if (formID.starts_with("0x") || formID.starts_with("0X")) {
+				formID.remove_prefix(2);
+			}
+
+			const auto end = formID.data() + formID.size();
+			const auto [last, error] = std::from_chars(formID.data(), end, a_requirement.formID, 16);
+			if (formID.empty() || error != std::errc{} || last != end || a_requirement.formID == 0) {
+				Fail("invalid form ID", a_item);
+			}
+		}
+
+		// the longest operator first, so ">=" isn't read as ">"
+		constexpr std::array<std::pair<std::string_view, Dialogue::OPCODE>, 6> kOperators{ {
+			{ "=="sv, Dialogue::OPCODE::kEqualTo },
+			{ "!="sv, Dialogue::OPCODE::kNotEqualTo },
+			{ ">="sv, Dialogue::OPCODE::kGreaterThanOrEqualTo },
+			{ "<="sv, Dialogue::OPCODE::kLessThanOrEqualTo },
+			{ ">"sv, Dialogue::OPCODE::kGreaterThan },
+			{ "<"sv, Dialogue::OPCODE::kLessThan },
+		} };
+
+		Requirement ParseItem(const Requirement::TYPE a_type, const std::string_view a_item)
+		{
+			Requirement requirement{ a_type, {}, 0, {}, Dialogue::OPCODE::kEqualTo, 0.0F };
+			if (a_type == Requirement::TYPE::kPerk) {
+				ParseForm(a_item, a_item, requirement);
+				return requirement;
+			}
+
+			const auto operatorPosition = a_item.find_first_of("=!<>");
+			if (operatorPosition == std::string_view::npos) {
+				Fail("missing comparison", a_item);
+			}
+			const auto comparison = a_item.substr(operatorPosition);
+			const auto it = std::ranges::find_if(kOperators, [&](const auto& a_operator) { return comparison.starts_with(a_operator.first); });
+			if (it == kOperators.end()) {
+				Fail("invalid comparison operator", a_item);
+			}
+			requirement.opCode = it->second;
+
+			const auto subject = Trim(a_item.substr(0, operatorPosition));
+			if (subject.empty()) {
+				Fail("missing actor value or form", a_item);
+			}
+			if (a_type == Requirement::TYPE::kActorValue) {
+				requirement.actorValue = subject;
+			} else {
+				ParseForm(subject, a_item, requirement);
+			}
+
+			const auto value = Trim(comparison.substr(it->first.size()));
+			const auto end = value.data() + value.size();
+			const auto [last, error] = std::from_chars(value.data(), end, requirement.value);
+			if (value.empty() || error != std::errc{} || last != end) {
+				Fail("invalid number", a_item);
+			}
+			return requirement;
+		}
+	}
+
+	std::vector<Requirement> Parse(const Requirement::TYPE a_type, const std::string_view a_list)
+	{
+		std::vector<Requirement> requirements;
+		for (std::size_t start = 0; start <= a_list.size();) {
+			const auto end = std::min(a_list.find(',', start), a_list.size());
+			if (const auto item = Trim(a_list.substr(start, end - start)); !item.empty()) {
+				requirements.push_back(ParseItem(a_type, item));
+			}
+			start = end + 1;
+		}
+		return requirements;
+	}
+}
\ No newline at end of file
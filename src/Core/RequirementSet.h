@@ -0,0 +1,31 @@
+#pragma once
+
+#include "DialogueEngine.h"
+
+// A requirement for the mod to take effect, configured in [Requirements]. Forms are only identified here,
+// the plugin looks them up once the game's data is loaded.
+struct Requirement final
+{
+	enum class TYPE : std::uint8_t
+	{
+		kPerk,
+		kActorValue,  // of the player, or the player's level
+		kGlobal,
+		kQuestStage,
+	};
+
+	TYPE type;
+	std::string plugin;      // the plugin that formID belongs to, empty if formID is a full form ID
+	std::uint32_t formID;    // of the perk, global or quest
+	std::string actorValue;  // the name of the actor value, or "Level"
+	Dialogue::OPCODE opCode;
+	float value;  // compared with the actor value, the global or the current stage of the quest
+};
+
+namespace RequirementSet
+{
+	// Parses a comma separated list of requirements of a_type. Perks are forms, the other types are comparisons such as
+	// "Speech >= 50" or "Skyrim.esm|0x3372B >= 10". Forms are hexadecimal full form IDs, or form IDs within a plugin after "Plugin.esp|".
+	// Throws std::invalid_argument if the list can't be parsed.
+	std::vector<Requirement> Parse(const Requirement::TYPE a_type, const std::string_view a_list);
+}
\ No newline at end of file
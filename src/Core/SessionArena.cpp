@@ -0,0 +1,65 @@
+/*
+Copyright (C) 2025 Jonathan Feenstra
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+See EXCEPTIONS for additional permissions.
+*/
+
+#include "SessionArena.h"
+
+void SessionArena::Reset() noexcept
+{
+	currentBlock = 0;
+	offset = 0;
+}
+
+std::size_t SessionArena::GetCapacity() const noexcept
+{
+	std::size_t capacity = 0;
+	for (const auto& block : blocks) {
+		capacity += block.size;
+	}
+	return capacity;
+}
+
+std::size_t SessionArena::GetUsed() const noexcept
+{
+	std::size_t used = offset;
+	for (std::size_t i = 0; i < currentBlock && i < blocks.size(); ++i) {
+		used += blocks[i].size;
+	}
+	return used;
+}
+
+void* SessionArena::do_allocate(const std::size_t a_bytes, const std::size_t a_alignment)
+{
+	// continues with the blocks that are kept from earlier sessions before allocating a new one
+	for (; currentBlock < blocks.size(); ++currentBlock, offset = 0) {
+		const auto& block = blocks[currentBlock];
+		const auto address = reinterpret_cast<std::uintptr_t>(block.data.get()) + offset;
+		const auto padding = (a_alignment - address % a_alignment) % a_alignment;
+		if (padding + a_bytes <= block.size - offset) {
+			offset += padding + a_bytes;
+			return block.data.get() + offset - a_bytes;
+		}
+	}
+
+	// the blocks double in size, so a session allocates from the global heap a logarithmic number of times at most
+	const auto blockSize = std::max(blocks.empty() ? initialBlockSize : blocks.back().size * 2, a_bytes + a_alignment);
+	blocks.push_back({ std::make_unique_for_overwrite<std::byte[]>(blockSize), blockSize });
+	currentBlock = blocks.size() - 1;
+	offset = 0;
+	return do_allocate(a_bytes, a_alignment);
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+// A monotonic memory resource for the working data of a single dialogue menu session, which is all freed at once when the menu closes.
+// Reset() keeps the blocks for the next session, so rebuilding the display data in sessions of a similar size doesn't allocate
+// from the global heap. Processing topics that aren't cached still does, the topic cache outlives the sessions.
+class SessionArena final : public std::pmr::memory_resource
+{
+public:
+	explicit SessionArena(const std::size_t a_initialBlockSize = 64 * 1024) noexcept :
+		initialBlockSize(a_initialBlockSize) {}
+	~SessionArena() override = default;
+
+	SessionArena(const SessionArena&) = delete;
+	SessionArena(SessionArena&&) = delete;
+	SessionArena& operator=(const SessionArena&) = delete;
+	SessionArena& operator=(SessionArena&&) = delete;
+
+	// Everything allocated since the last reset must no longer be used.
+	void Reset() noexcept;
+
+	std::size_t GetNumBlocks() const noexcept { return blocks.size(); }
+	std::size_t GetCapacity() const noexcept;
+	// the bytes allocated since the last reset, including alignment padding and the unused ends of the blocks before the current one
+	std::size_t GetUsed() const noexcept;
+
+private:
+	struct Block final
+	{
+		std::unique_ptr<std::byte[]> data;
+		std::size_t size;
+	};
+
+	void* do_allocate(std::size_t a_bytes, std::size_t a_alignment) override;
+	// memory is only freed by Reset
+	void do_deallocate(void*, std::size_t, std::size_t) noexcept override {}
+	bool do_is_equal(const std::pmr::memory_resource& a_other) const noexcept override { return this == &a_other; }
+
+	std::size_t initialBlockSize;
+	std::vector<Block> blocks;
+	std::size_t currentBlock = 0;
+	std::size_t offset = 0;  // in the current block
+};
\ No newline at end of file
@@ -0,0 +1,77 @@
+/*
+Copyright (C) 2025 Jonathan Feenstra
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+See EXCEPTIONS for additional permissions.
+*/
+
+#include "SessionRecorder.h"
+
+namespace SessionRecorder
+{
+	namespace
+	{
+		SessionTrace::Writer writer;
+		bool hasRecordedList = false;  // sessions that never showed a list, e.g. because the requirements weren't met, aren't written
+	}
+
+	bool Start(const std::filesystem::path& a_tracePath)
+	{
+		if (detail::isRecording) {
+			return true;
+		}
+		if (!writer.Open(a_tracePath)) {
+			return false;
+		}
+
+		hasRecordedList = false;
+		detail::isRecording = true;
+		return true;
+	}
+
+	void Stop() noexcept
+	{
+		detail::isRecording = false;
+		writer.Close();
+	}
+
+	std::uint32_t RecordTopic(const Dialogue::Engine& a_engine, const Dialogue::TopicHandle a_topic, const std::uint32_t a_formID, const bool a_withResponseTexts)
+	{
+		return writer.WriteTopic(SessionTrace::CaptureTopic(a_engine, a_topic, a_formID, a_withResponseTexts));
+	}
+
+	void RecordDialogueList(const SessionTrace::DialogueList& a_list)
+	{
+		writer.WriteDialogueList(a_list);
+		hasRecordedList = true;
+	}
+
+	void RecordSelection(const std::string_view a_topicText)
+	{
+		if (hasRecordedList) {
+			writer.WriteSelection(a_topicText);
+		}
+	}
+
+	void EndSession()
+	{
+		if (!detail::isRecording || !hasRecordedList) {
+			return;
+		}
+
+		writer.EndSession();
+		hasRecordedList = false;
+	}
+}
\ No newline at end of file
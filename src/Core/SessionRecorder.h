@@ -0,0 +1,24 @@
+#pragma once
+
+#include "SessionTrace.h"
+
+// Records the dialogue sessions of the game into a trace file, which the replay tool runs through the pipeline without the game.
+// Only used from the main thread, which is the one that processes the dialogue list and calls the Scaleform function handlers.
+namespace SessionRecorder
+{
+	namespace detail
+	{
+		inline bool isRecording = false;
+	}
+
+	bool Start(const std::filesystem::path& a_tracePath);
+	void Stop() noexcept;
+	inline bool IsRecording() noexcept { return detail::isRecording; }
+
+	// captures a_topic for the current speaker of a_engine, returns the index that entries of the dialogue list refer to it with
+	std::uint32_t RecordTopic(const Dialogue::Engine& a_engine, const Dialogue::TopicHandle a_topic, const std::uint32_t a_formID, const bool a_withResponseTexts);
+	void RecordDialogueList(const SessionTrace::DialogueList& a_list);
+	void RecordSelection(const std::string_view a_topicText);
+	// writes the recorded session to the file
+	void EndSession();
+}
\ No newline at end of file
@@ -0,0 +1,416 @@
+/*
+Copyright (C) 2025 Jonathan Feenstra
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+See EXCEPTIONS for additional permissions.
+*/
+
+#include "SessionTrace.h"
+
+#include "HashUtil.h"
+#include "MappedFile.h"
+
+namespace SessionTrace
+{
+	namespace
+	{
+		// The file starts with this header, followed by records that each start with a RECORD byte. Fixed size fields are
+		// stored as in memory (little-endian) and counts as LEB128 varints, so kVersion has to change whenever a record changes.
+		struct FileHeader final
+		{
+			static constexpr std::array<char, 4> kMagic{ 'P', 'P', 'S', 'T' };
+			static constexpr std::uint32_t kVersion = 2;
+
+			std::array<char, 4> magic;
+			std::uint32_t version;
+		};
+		static_assert(sizeof(FileHeader) == 8);
+
+		enum class RECORD : std::uint8_t
+		{
+			kTopic,
+			kDialogueList,
+			kSelection,  // belongs to the last dialogue list
+			kEndSession,
+		};
+
+		enum INFO_FLAG : std::uint8_t
+		{
+			kConditionsTrue = 1 << 0,
+			kHasResponseText = 1 << 1,
+		};
+
+		enum CONDITION_FLAG : std::uint8_t
+		{
+			kIsOR = 1 << 0,
+			kIsSpeech = 1 << 1,
+			kIsTrue = 1 << 2,
+			kSwapsSubjectAndTarget = 1 << 3,
+		};
+
+		class RecordWriter final
+		{
+		public:
+			explicit RecordWriter(std::string& a_buffer) noexcept :
+				buffer(a_buffer)
+			{}
+
+			template <class T>
+			void Write(const T a_value)
+			{
+				static_assert(std::is_trivially_copyable_v<T>);
+				buffer.append(reinterpret_cast<const char*>(&a_value), sizeof(T));
+			}
+
+			void WriteCount(std::size_t a_count)
+			{
+				for (; a_count >= 0x80; a_count >>= 7) {
+					buffer.push_back(static_cast<char>((a_count & 0x7F) | 0x80));
+				}
+				buffer.push_back(static_cast<char>(a_count));
+			}
+
+			void WriteString(const std::string_view a_string)
+			{
+				WriteCount(a_string.size());
+				buffer.append(a_string);
+			}
+
+		private:
+			std::string& buffer;
+		};
+
+		// every read fails once the data ran out, so records only need to be checked at their end
+		class RecordReader final
+		{
+		public:
+			explicit RecordReader(const std::span<const std::byte> a_data) noexcept :
+				data(a_data)
+			{}
+
+			bool IsValid() const noexcept { return isValid; }
+			bool IsAtEnd() const noexcept { return position == data.size(); }
+			void Invalidate() noexcept { isValid = false; }
+
+			template <class T>
+			T Read() noexcept
+			{
+				static_assert(std::is_trivially_copyable_v<T>);
+				T value{};
+				if (isValid && data.size() - position >= sizeof(T)) {
+					std::memcpy(&value, data.data() + position, sizeof(T));
+					position += sizeof(T);
+				} else {
+					isValid = false;
+				}
+				return value;
+			}
+
+			// A count of elements that take at least a_minSize bytes each, so a corrupt count can't allocate more than the file holds.
+			// Indices are read with an a_minSize of 0, which isn't checked against the rest of the file.
+			std::uint32_t ReadCount(const std::size_t a_minSize = 1) noexcept
+			{
+				std::uint64_t count = 0;
+				for (std::uint32_t shift = 0; isValid; shift += 7) {
+					const auto byte = Read<std::uint8_t>();
+					count |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+					if ((byte & 0x80) == 0) {
+						break;
+					}
+					if (shift >= 28) {
+						isValid = false;
+					}
+				}
+				if (count > UINT32_MAX || (a_minSize > 0 && count > (data.size() - position) / a_minSize)) {
+					isValid = false;
+				}
+				return isValid ? static_cast<std::uint32_t>(count) : 0;
+			}
+
+			std::string ReadString() noexcept
+			{
+				const auto length = ReadCount();
+				if (!isValid) {
+					return {};
+				}
+				std::string result(reinterpret_cast<const char*>(data.data() + position), length);
+				position += length;
+				return result;
+			}
+
+		private:
+			std::span<const std::byte> data;
+			std::size_t position = 0;
+			bool isValid = true;
+		};
+
+		void WriteTopicRecord(RecordWriter& a_writer, const Topic& a_topic)
+		{
+			a_writer.Write(RECORD::kTopic);
+			a_writer.Write(a_topic.formID);
+			a_writer.WriteString(a_topic.name);
+			a_writer.WriteCount(a_topic.infos.size());
+			for (const auto& info : a_topic.infos) {
+				a_writer.Write<std::uint8_t>((info.conditionsTrue ? kConditionsTrue : 0) | (info.responseText ? kHasResponseText : 0));
+				if (info.responseText) {
+					a_writer.WriteString(*info.responseText);
+				}
+				a_writer.WriteCount(info.conditions.size());
+				for (const auto& condition : info.conditions) {
+					a_writer.Write(condition.data.function);
+					a_writer.Write(condition.data.opCode);
+					a_writer.Write(condition.data.object);
+					a_writer.Write<std::uint8_t>(
+						(condition.data.isOR ? kIsOR : 0) | (condition.data.isSpeech ? kIsSpeech : 0) | (condition.isTrue ? kIsTrue : 0) |
+						(condition.data.swapsSubjectAndTarget ? kSwapsSubjectAndTarget : 0));
+					a_writer.Write(condition.data.comparisonValue);
+					a_writer.Write(condition.globalFormID);
+				}
+			}
+		}
+
+		Topic ReadTopicRecord(RecordReader& a_reader)
+		{
+			Topic topic{ a_reader.Read<std::uint32_t>(), a_reader.ReadString(), {} };
+			topic.infos.resize(a_reader.ReadCount(2));
+			for (auto& info : topic.infos) {
+				const auto flags = a_reader.Read<std::uint8_t>();
+				info.conditionsTrue = (flags & kConditionsTrue) != 0;
+				if (flags & kHasResponseText) {
+					info.responseText = a_reader.ReadString();
+				}
+				info.conditions.resize(a_reader.ReadCount(12));
+				for (auto& condition : info.conditions) {
+					condition.data.function = a_reader.Read<Dialogue::CONDITION_FUNCTION>();
+					condition.data.opCode = a_reader.Read<Dialogue::OPCODE>();
+					condition.data.object = a_reader.Read<Dialogue::CONDITION_OBJECT>();
+					const auto conditionFlags = a_reader.Read<std::uint8_t>();
+					condition.data.isOR = (conditionFlags & kIsOR) != 0;
+					condition.data.isSpeech = (conditionFlags & kIsSpeech) != 0;
+					condition.data.swapsSubjectAndTarget = (conditionFlags & kSwapsSubjectAndTarget) != 0;
+					condition.isTrue = (conditionFlags & kIsTrue) != 0;
+					condition.data.comparisonValue = a_reader.Read<float>();
+					condition.data.global = nullptr;
+					condition.globalFormID = a_reader.Read<std::uint32_t>();
+					if (condition.data.function > Dialogue::CONDITION_FUNCTION::kOther || condition.data.opCode > Dialogue::OPCODE::kLessThanOrEqualTo ||
+						condition.data.object > Dialogue::CONDITION_OBJECT::kOther) {
+						a_reader.Invalidate();
+					}
+				}
+				if (!a_reader.IsValid()) {
+					break;
+				}
+			}
+			return topic;
+		}
+
+		DialogueList ReadDialogueListRecord(RecordReader& a_reader, const std::size_t a_numTopics)
+		{
+			DialogueList list{ a_reader.Read<MESSAGE>(), a_reader.Read<std::uint32_t>(), a_reader.Read<float>(), {}, {} };
+			if (list.message > MESSAGE::kUpdate) {
+				a_reader.Invalidate();
+			}
+			list.entries.resize(a_reader.ReadCount(3));
+			for (auto& entry : list.entries) {
+				entry.topicIndex = a_reader.ReadCount(0);
+				entry.topicText = a_reader.ReadString();
+				entry.shownText = a_reader.ReadString();
+				if (entry.topicIndex >= a_numTopics) {
+					a_reader.Invalidate();
+				}
+				if (!a_reader.IsValid()) {
+					break;
+				}
+			}
+			return list;
+		}
+	}
+
+	bool Trace::Load(const std::filesystem::path& a_path)
+	{
+		topics.clear();
+		sessions.clear();
+		isTruncated = false;
+
+		MappedFile file;
+		if (!file.Open(a_path)) {
+			return false;
+		}
+
+		const auto data = file.GetData();
+		FileHeader header;
+		if (data.size() < sizeof(header)) {
+			return false;
+		}
+		std::memcpy(&header, data.data(), sizeof(header));
+		if (header.magic != FileHeader::kMagic || header.version != FileHeader::kVersion) {
+			return false;
+		}
+
+		RecordReader reader(data.subspan(sizeof(header)));
+		Session session;
+		while (reader.IsValid() && !reader.IsAtEnd()) {
+			switch (reader.Read<RECORD>()) {
+			case RECORD::kTopic:
+				if (auto topic = ReadTopicRecord(reader); reader.IsValid()) {
+					topics.push_back(std::move(topic));
+				}
+				break;
+			case RECORD::kDialogueList:
+				if (auto list = ReadDialogueListRecord(reader, topics.size()); reader.IsValid()) {
+					session.lists.push_back(std::move(list));
+				}
+				break;
+			case RECORD::kSelection:
+				if (auto topicText = reader.ReadString(); reader.IsValid() && !session.lists.empty()) {
+					session.lists.back().selections.push_back(std::move(topicText));
+				} else {
+					reader.Invalidate();
+				}
+				break;
+			case RECORD::kEndSession:
+				sessions.push_back(std::move(session));
+				session = {};
+				break;
+			default:
+				reader.Invalidate();
+			}
+		}
+
+		isTruncated = !reader.IsValid() || !session.lists.empty();
+		return true;
+	}
+
+	Topic CaptureTopic(const Dialogue::Engine& a_engine, const Dialogue::TopicHandle a_topic, const std::uint32_t a_formID, const bool a_withResponseTexts)
+	{
+		Topic topic{ a_formID, std::string(a_engine.topics.GetName(a_topic)), {} };
+		const auto numInfos = a_engine.topics.GetNumInfos(a_topic);
+		topic.infos.reserve(numInfos);
+		for (std::uint32_t index = 0; index < numInfos; ++index) {
+			const auto topicInfo = a_engine.topics.GetInfo(a_topic, index);
+			auto& info = topic.infos.emplace_back();
+			if (!topicInfo) {
+				continue;
+			}
+
+			for (auto conditionItem = a_engine.topicInfos.GetFirstCondition(topicInfo); conditionItem; conditionItem = a_engine.conditionItems.GetNext(conditionItem)) {
+				auto data = a_engine.conditionItems.GetData(conditionItem);
+				const auto globalFormID = data.global ? a_engine.globals.GetFormID(data.global) : 0;
+				data.global = nullptr;
+				info.conditions.emplace_back(data, globalFormID, a_engine.conditionItems.IsTrue(conditionItem));
+			}
+			info.conditionsTrue = a_engine.topicInfos.AreConditionsTrue(topicInfo);
+			if (a_withResponseTexts) {
+				info.responseText = a_engine.responseTexts.GetResponseText(topicInfo);
+			}
+		}
+		return topic;
+	}
+
+	Dialogue::TopicHandle AddToEngine(MemoryEngine& a_engine, const Topic& a_topic)
+	{
+		MemoryEngine::Topic topic{ a_topic.name, {} };
+		topic.infos.reserve(a_topic.infos.size());
+		for (const auto& info : a_topic.infos) {
+			auto& memoryInfo = topic.infos.emplace_back(std::vector<MemoryEngine::Condition>{}, info.conditionsTrue, info.responseText.value_or(""));
+			memoryInfo.conditions.reserve(info.conditions.size());
+			for (const auto& condition : info.conditions) {
+				auto data = condition.data;
+				if (condition.globalFormID != 0) {
+					data.global = a_engine.AddGlobal(data.comparisonValue, condition.globalFormID);
+				}
+				memoryInfo.conditions.emplace_back(data, condition.isTrue, nullptr);
+			}
+		}
+		return a_engine.AddTopic(std::move(topic));
+	}
+
+	bool Writer::Open(const std::filesystem::path& a_path)
+	{
+		Close();
+		file.open(a_path, std::ios::binary | std::ios::trunc);
+		if (!file) {
+			return false;
+		}
+
+		const FileHeader header{ FileHeader::kMagic, FileHeader::kVersion };
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		return file.flush().good();
+	}
+
+	void Writer::Close() noexcept
+	{
+		file.close();
+		buffer.clear();
+		topicRecords.clear();
+		topicSpans.clear();
+		topicIndices.Clear();
+	}
+
+	std::uint32_t Writer::WriteTopic(const Topic& a_topic)
+	{
+		const auto offset = topicRecords.size();
+		RecordWriter writer(topicRecords);
+		WriteTopicRecord(writer, a_topic);
+		const std::string_view record(topicRecords.data() + offset, topicRecords.size() - offset);
+
+		const auto hash = HashUtil::Hash(record);
+		if (const auto index = topicIndices.Find(hash)) {
+			const auto [knownOffset, knownLength] = topicSpans[*index];
+			if (std::string_view(topicRecords.data() + knownOffset, knownLength) == record) {
+				topicRecords.resize(offset);
+				return *index;
+			}
+		}
+
+		const auto index = static_cast<std::uint32_t>(topicSpans.size());
+		topicSpans.emplace_back(static_cast<std::uint32_t>(offset), static_cast<std::uint32_t>(record.size()));
+		topicIndices[hash] = index;
+		buffer.append(record);
+		return index;
+	}
+
+	void Writer::WriteDialogueList(const DialogueList& a_list)
+	{
+		RecordWriter writer(buffer);
+		writer.Write(RECORD::kDialogueList);
+		writer.Write(a_list.message);
+		writer.Write(a_list.speakerFormID);
+		writer.Write(a_list.playerSpeechLevel);
+		writer.WriteCount(a_list.entries.size());
+		for (const auto& entry : a_list.entries) {
+			writer.WriteCount(entry.topicIndex);
+			writer.WriteString(entry.topicText);
+			writer.WriteString(entry.shownText);
+		}
+	}
+
+	void Writer::WriteSelection(const std::string_view a_topicText)
+	{
+		RecordWriter writer(buffer);
+		writer.Write(RECORD::kSelection);
+		writer.WriteString(a_topicText);
+	}
+
+	void Writer::EndSession()
+	{
+		RecordWriter writer(buffer);
+		writer.Write(RECORD::kEndSession);
+		// flushed after every session, so the trace stays readable if the game crashes
+		file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+		file.flush();
+		buffer.clear();
+	}
+}
\ No newline at end of file
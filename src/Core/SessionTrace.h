@@ -0,0 +1,100 @@
+#pragma once
+
+#include "DialogueEngine.h"
+#include "FlatHashMap.h"
+#include "MemoryEngine.h"
+
+// Dialogue sessions recorded in the game, so they can be replayed through the topic processing pipeline with MemoryEngine.
+// A trace holds the topics of the dialogue lists with the results of their conditions as they were evaluated for the speaker,
+// which makes replaying a session deterministic and independent of the load order it was recorded with.
+namespace SessionTrace
+{
+	struct Condition final
+	{
+		Dialogue::ConditionData data;  // without the global, which is identified by globalFormID instead
+		std::uint32_t globalFormID;    // 0 if the condition doesn't compare with a global
+		bool isTrue;
+	};
+
+	struct TopicInfo final
+	{
+		std::vector<Condition> conditions;
+		bool conditionsTrue;
+		std::optional<std::string> responseText;  // only recorded if a format showed the predicted response
+	};
+
+	struct Topic final
+	{
+		std::uint32_t formID;
+		std::string name;
+		std::vector<TopicInfo> infos;
+	};
+
+	enum class MESSAGE : std::uint8_t
+	{
+		kShow,
+		kUpdate,
+	};
+
+	struct Entry final
+	{
+		std::uint32_t topicIndex;
+		std::string topicText;  // before processing
+		std::string shownText;  // after processing, as the dialogue menu showed it
+	};
+
+	struct DialogueList final
+	{
+		MESSAGE message;
+		std::uint32_t speakerFormID;
+		float playerSpeechLevel;
+		std::vector<Entry> entries;
+		std::vector<std::string> selections;  // the texts of the entries the player highlighted while the list was shown
+	};
+
+	// from opening the dialogue menu until closing it
+	struct Session final
+	{
+		std::vector<DialogueList> lists;
+	};
+
+	struct Trace final
+	{
+		std::vector<Topic> topics;
+		std::vector<Session> sessions;
+		bool isTruncated;  // the file ended in the middle of a session, e.g. because the game crashed
+
+		// false if the file is missing or isn't a trace of this version, a corrupt or cut off end is dropped
+		bool Load(const std::filesystem::path& a_path);
+	};
+
+	// Reads a_topic as the current speaker of a_engine sees it, which evaluates all of its conditions.
+	// Response texts are expensive to look up, so they're only read if a_withResponseTexts is set.
+	Topic CaptureTopic(const Dialogue::Engine& a_engine, const Dialogue::TopicHandle a_topic, const std::uint32_t a_formID, const bool a_withResponseTexts);
+	// adds a_topic with its recorded condition results, each global it compares with gets its own handle
+	Dialogue::TopicHandle AddToEngine(MemoryEngine& a_engine, const Topic& a_topic);
+
+	// Appends records to a trace file. They're buffered until EndSession, so recording doesn't write to the disk during a dialogue.
+	class Writer final
+	{
+	public:
+		// truncates the file and writes the header
+		bool Open(const std::filesystem::path& a_path);
+		void Close() noexcept;
+		bool IsOpen() const noexcept { return file.is_open(); }
+
+		// returns the index that entries refer to the topic with, identical topics are only written once
+		std::uint32_t WriteTopic(const Topic& a_topic);
+		// the selections of a_list are ignored, they're written with WriteSelection after the list
+		void WriteDialogueList(const DialogueList& a_list);
+		void WriteSelection(const std::string_view a_topicText);
+		void EndSession();
+
+	private:
+		std::ofstream file;
+		std::string buffer;
+		std::string topicRecords;                                       // all topics written so far, to rule out hash collisions
+		std::vector<std::pair<std::uint32_t, std::uint32_t>> topicSpans;  // offset and length in topicRecords, by topic index
+		FlatHashMap<std::uint64_t, std::uint32_t, FlatIdentityHash> topicIndices;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "FormatProgram.h"
+#include "RequirementSet.h"
+#include "TagMatcher.h"
+#include "TagPresets.h"
+#include "TopicDescriptor.h"
+
+// An immutable snapshot of the INI file. Load publishes a new snapshot, so the file can be reloaded while the game runs:
+// readers take the current snapshot once with Get() and keep using it until they're done, even if a newer one is published meanwhile.
+// Snapshots are always owned by a shared_ptr, so data that refers into one can keep it alive with shared_from_this().
+class alignas(64) Settings final : public std::enable_shared_from_this<Settings>
+{
+public:
+	enum class SHOW_SUBTITLES : std::uint8_t
+	{
+		kNever = 0,
+		kOnlyForNoCheck = 1,
+		kForAllSpeechChecks = 2,
+	};
+
+	// how the outcomes of intimidation and bribes are predicted
+	enum class SPEECH_CHECK_EVALUATOR : std::uint8_t
+	{
+		kEngine = 0,        // the game's condition functions
+		kNative = 1,        // SpeechFormulas, without calling into the game
+		kDifferential = 2,  // both, the engine decides and the native results are compared with it
+	};
+
+	// the settings that depend on the type of speech check
+	struct CheckTypeProfile final
+	{
+		FormatProgram topicFormat;
+		FormatProgram subtitleFormat;
+		std::string tagPlaceholder;
+	};
+
+	// the formats of the INI file's defaults, indexed by TopicProcessor::SPEECH_CHECK_TYPE, which the replay tool uses as well
+	static constexpr std::array<const char*, 3> kDefaultTopicFormats{ "{0} ({1} Level {3})", "{0} ({1})", "{0} (Bribe with {1})" };
+	static constexpr auto kDefaultSubtitleFormat = "{4}";
+
+	// Reads the INI file into a new snapshot and publishes it. It looks up the game's language, so it has to run on the main thread.
+	static void Load();
+	// Watches the INI file on a background thread, which reads and publishes a new snapshot whenever it changes, so the main thread
+	// only picks up the new pointer. Watching stops by itself after a reload that turns bReloadOnChange off.
+	static void StartWatching();
+	// Tells the thread of StartWatching to stop, without waiting for it.
+	static void StopWatching();
+
+	// nullptr until the first snapshot is published
+	static std::shared_ptr<const Settings> Get() noexcept { return current.load(std::memory_order_acquire); }
+	static void Publish(std::shared_ptr<const Settings> a_settings) noexcept { current.store(std::move(a_settings), std::memory_order_release); }
+
+	const CheckTypeProfile& GetProfile(const TopicProcessor::SPEECH_CHECK_TYPE a_checkType) const noexcept { return profiles[static_cast<std::size_t>(a_checkType)]; }
+
+	// The scalars that are read for every topic come first, so they share a cache line.
+	std::uint32_t generation;  // increases with every Load, so cached results can tell that they're outdated
+	bool applyTopicFormatting;
+	bool applyTopicColors;
+	bool batchTopicColors;
+	SHOW_SUBTITLES showSubtitles;
+	bool showsPredictedResponse;  // derived from the formats, predicting responses is skipped if no format shows them
+	std::uint32_t subtitleColor;
+	std::uint32_t successColor;
+	std::uint32_t failureColorNew;
+	std::uint32_t failureColorOld;
+	std::uint32_t noCheckColorNew;
+	std::uint32_t noCheckColorOld;
+	std::uint32_t regularColorNew;
+	std::uint32_t regularColorOld;
+
+	// [TagRegex]
+	// the tags of the game's language, or nullptr if a custom pattern is used, then tagMatcher matches all tags
+	const TagPreset* tagPreset;
+	// the persuade, intimidate and bribe patterns in that order, compiled into a single automaton
+	TagMatcher tagMatcher;
+
+	// [TopicFormats], [Subtitles] and [TagPlaceholders], indexed by TopicProcessor::SPEECH_CHECK_TYPE
+	std::array<CheckTypeProfile, 3> profiles;
+
+	// [CheckResults]
+	std::string checkSuccessText;
+	std::string checkFailureText;
+	std::string noCheckText;
+
+	// [SpeechChecks]
+	SPEECH_CHECK_EVALUATOR speechCheckEvaluator;
+
+	// [Prefetch]
+	bool prefetchTopics;
+	std::uint32_t prefetchBudgetMicroseconds;
+
+	// [Profiling]
+	bool enableProfiling;
+	bool recordSessions;
+
+	// [Requirements], all of which have to be met
+	std::vector<Requirement> requirements;
+	bool hasInvalidRequirements;  // a list that couldn't be parsed, which the player can't meet either
+
+	// [HotReload]
+	bool reloadOnChange;
+
+private:
+	static inline std::atomic<std::shared_ptr<const Settings>> current;
+};
\ No newline at end of file
@@ -0,0 +1,170 @@
+/*
+Copyright (C) 2025 Jonathan Feenstra
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+See EXCEPTIONS for additional permissions.
+*/
+
+#include "SpeechCheckIndex.h"
+
+#include "HashUtil.h"
+
+void SpeechCheckIndex::Clear() noexcept
+{
+	slots = {};
+	ownedSlots.clear();
+	file.Close();
+	size = 0;
+}
+
+void SpeechCheckIndex::Build(const std::span<const Entry> a_entries)
+{
+	Clear();
+	const auto numRelevant = std::ranges::count_if(a_entries, [](const Entry& a_entry) { return a_entry.formID != 0 && IsRelevant(a_entry.descriptor); });
+	const auto capacity = std::bit_ceil(std::max<std::size_t>(static_cast<std::size_t>(numRelevant) * 2, 8));
+	const auto mask = capacity - 1;
+	ownedSlots.assign(capacity, Entry{});
+	for (const auto& entry : a_entries) {
+		if (entry.formID == 0 || !IsRelevant(entry.descriptor)) {
+			continue;
+		}
+
+		for (auto slot = static_cast<std::size_t>(HashUtil::Mix(entry.formID)) & mask;; slot = (slot + 1) & mask) {
+			if (ownedSlots[slot].formID == 0) {
+				ownedSlots[slot] = entry;
+				++size;
+				break;
+			}
+			if (ownedSlots[slot].formID == entry.formID) {
+				ownedSlots[slot] = entry;
+				break;
+			}
+		}
+	}
+	slots = ownedSlots;
+}
+
+bool SpeechCheckIndex::Save(const std::filesystem::path& a_path, const std::uint64_t a_loadOrderHash) const
+{
+	if (slots.empty()) {
+		return false;
+	}
+
+	const FileHeader header{
+		FileHeader::kMagic,
+		FileHeader::kVersion,
+		a_loadOrderHash,
+		static_cast<std::uint32_t>(slots.size()),
+		static_cast<std::uint32_t>(size),
+		checksum(slots)
+	};
+
+	// written next to the old file and then renamed, so a crash never leaves a partial file behind
+	auto tempPath = a_path;
+	tempPath += ".tmp";
+	{
+		std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+		stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		stream.write(reinterpret_cast<const char*>(slots.data()), static_cast<std::streamsize>(slots.size_bytes()));
+		if (!stream.flush()) {
+			return false;
+		}
+	}
+
+	std::error_code error;
+	std::filesystem::rename(tempPath, a_path, error);
+	return !error;
+}
+
+bool SpeechCheckIndex::Load(const std::filesystem::path& a_path, const std::uint64_t a_loadOrderHash) noexcept
+{
+	Clear();
+	if (!file.Open(a_path)) {
+		return false;
+	}
+
+	const auto data = file.GetData();
+	if (data.size() < sizeof(FileHeader) || (data.size() - sizeof(FileHeader)) % sizeof(Entry) != 0) {
+		file.Close();
+		return false;
+	}
+
+	FileHeader header;
+	std::memcpy(&header, data.data(), sizeof(header));
+	// the mapping is page aligned and the header keeps the slots aligned
+	const std::span<const Entry> mappedSlots(reinterpret_cast<const Entry*>(data.data() + sizeof(FileHeader)), (data.size() - sizeof(FileHeader)) / sizeof(Entry));
+	if (header.loadOrderHash != a_loadOrderHash || !isValid(header, mappedSlots)) {
+		file.Close();
+		return false;
+	}
+
+	slots = mappedSlots;
+	size = header.numEntries;
+	return true;
+}
+
+const TopicProcessor::TopicDescriptor* SpeechCheckIndex::Find(const std::uint32_t a_formID) const noexcept
+{
+	if (slots.empty()) {
+		return nullptr;
+	}
+	if (a_formID == 0) {
+		return &TopicProcessor::kRegularTopic;
+	}
+
+	const auto mask = slots.size() - 1;
+	for (auto slot = static_cast<std::size_t>(HashUtil::Mix(a_formID)) & mask;; slot = (slot + 1) & mask) {
+		const auto& entry = slots[slot];
+		if (entry.formID == a_formID) {
+			return &entry.descriptor;
+		}
+		if (entry.formID == 0) {
+			return &TopicProcessor::kRegularTopic;
+		}
+	}
+}
+
+std::uint64_t SpeechCheckIndex::checksum(const std::span<const Entry> a_slots) noexcept
+{
+	return HashUtil::Hash({ reinterpret_cast<const char*>(a_slots.data()), a_slots.size_bytes() }, FileHeader::kVersion);
+}
+
+bool SpeechCheckIndex::isValid(const FileHeader& a_header, const std::span<const Entry> a_slots) noexcept
+{
+	if (a_header.magic != FileHeader::kMagic || a_header.version != FileHeader::kVersion) {
+		return false;
+	}
+
+	// Find relies on a power of two capacity with at least one empty slot
+	if (a_header.numSlots != a_slots.size() || !std::has_single_bit(a_header.numSlots) || a_header.numEntries >= a_header.numSlots) {
+		return false;
+	}
+
+	if (a_header.checksum != checksum(a_slots)) {
+		return false;
+	}
+
+	std::uint32_t numEntries = 0;
+	for (const auto& entry : a_slots) {
+		if (entry.formID == 0) {
+			continue;
+		}
+		if (entry.descriptor.checkType > TopicProcessor::SPEECH_CHECK_TYPE::kNone) {
+			return false;
+		}
+		++numEntries;
+	}
+	return numEntries == a_header.numEntries;
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "MappedFile.h"
+#include "TopicDescriptor.h"
+
+// Maps the form IDs of topics to their speech check descriptors.
+// Only topics with a speech check or a bribe cost are stored, every other topic is a regular topic.
+// The table can be saved to a file and mapped back into memory as is, so later launches don't need to scan all topics.
+class SpeechCheckIndex final
+{
+public:
+	struct Entry final
+	{
+		std::uint32_t formID;  // 0 marks an empty slot
+		TopicProcessor::TopicDescriptor descriptor;
+	};
+	static_assert(sizeof(Entry) == 20 && std::is_trivially_copyable_v<Entry>);
+
+	static bool IsRelevant(const TopicProcessor::TopicDescriptor& a_descriptor) noexcept
+	{
+		return a_descriptor.checkType != TopicProcessor::SPEECH_CHECK_TYPE::kNone || a_descriptor.HasFlag(TopicProcessor::TopicDescriptor::kBribeCost);
+	}
+
+	void Clear() noexcept;
+	// a_entries can contain irrelevant topics, which are skipped
+	void Build(std::span<const Entry> a_entries);
+
+	// a_loadOrderHash identifies the plugins the index was built from, a file for other plugins is stale
+	bool Save(const std::filesystem::path& a_path, const std::uint64_t a_loadOrderHash) const;
+	// false if the file is missing, stale or corrupt, the index is then left empty
+	bool Load(const std::filesystem::path& a_path, const std::uint64_t a_loadOrderHash) noexcept;
+
+	// nullptr if the index isn't built, so the caller has to describe the topic itself
+	const TopicProcessor::TopicDescriptor* Find(const std::uint32_t a_formID) const noexcept;
+
+	bool IsBuilt() const noexcept { return !slots.empty(); }
+	bool IsMapped() const noexcept { return file.IsOpen(); }
+	std::size_t Size() const noexcept { return size; }
+
+private:
+	// The file starts with this header, followed by the slots. Both are stored as in memory (little-endian), so kVersion
+	// has to change whenever the layout of the header, Entry or TopicDescriptor, or the way topics are described changes.
+	struct FileHeader final
+	{
+		static constexpr std::array<char, 4> kMagic{ 'P', 'P', 'S', 'I' };
+		static constexpr std::uint32_t kVersion = 1;
+
+		std::array<char, 4> magic;
+		std::uint32_t version;
+		std::uint64_t loadOrderHash;
+		std::uint32_t numSlots;
+		std::uint32_t numEntries;
+		std::uint64_t checksum;  // of the slots
+	};
+	static_assert(sizeof(FileHeader) == 32 && sizeof(FileHeader) % alignof(Entry) == 0);
+
+	static std::uint64_t checksum(std::span<const Entry> a_slots) noexcept;
+	static bool isValid(const FileHeader& a_header, std::span<const Entry> a_slots) noexcept;
+
+	// open addressing with linear probing, the capacity is a power of two
+	std::span<const Entry> slots;  // either ownedSlots or the mapped file
+	std::vector<Entry> ownedSlots;
+	MappedFile file;
+	std::size_t size = 0;
+};
\ No newline at end of file
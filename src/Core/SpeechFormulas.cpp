@@ -0,0 +1,91 @@
+/*
+Copyright (C) 2025 Jonathan Feenstra
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+See EXCEPTIONS for additional permissions.
+*/
+
+
+#include "SpeechFormulas.h"
+
+namespace SpeechFormulas
+{
+	namespace
+	{
+		std::mutex differentialLock;
+		DifferentialStats differentialStats{};
+	}
+
+	float GetRequiredIntimidationSpeechLevel(const Dialogue::SpeechCheckInputs& a_inputs) noexcept
+	{
+		const auto confidenceMult = a_inputs.intimidateConfidenceMults[static_cast<std::size_t>(a_inputs.speakerConfidence)];
+		const auto speakerScore = a_inputs.speakerLevel * confidenceMult;
+		if (a_inputs.intimidationPerkMult <= 0.0F) {
+			return speakerScore <= 0.0F ? 0.0F : std::numeric_limits<float>::infinity();
+		}
+
+		// the player's level counts even without any speech
+		const auto missingScore = speakerScore / a_inputs.intimidationPerkMult - a_inputs.playerLevel;
+		if (missingScore <= 0.0F) {
+			return 0.0F;
+		}
+		if (a_inputs.intimidateSpeechcraftCurve <= 0.0F) {
+			return std::numeric_limits<float>::infinity();
+		}
+		return missingScore / a_inputs.intimidateSpeechcraftCurve;
+	}
+
+	std::optional<float> ParseBribeAmount(const std::string_view a_tagText) noexcept
+	{
+		const auto isDigit = [&](const std::size_t a_index) { return a_index < a_tagText.size() && a_tagText[a_index] >= '0' && a_tagText[a_index] <= '9'; };
+		auto index = a_tagText.find_first_of("0123456789");
+		if (index == std::string_view::npos) {
+			return std::nullopt;
+		}
+
+		std::uint64_t amount = 0;
+		while (isDigit(index)) {
+			amount = amount * 10 + static_cast<std::uint64_t>(a_tagText[index] - '0');
+			if (amount > UINT32_MAX) {
+				return std::nullopt;
+			}
+			++index;
+			// thousands separators of the game's language, e.g. "1,000 gold" or "1.000 Gold"
+			const auto isSeparator = index < a_tagText.size() && (a_tagText[index] == ',' || a_tagText[index] == '.' || a_tagText[index] == ' ');
+			if (isSeparator && isDigit(index + 1) && isDigit(index + 2) && isDigit(index + 3) && !isDigit(index + 4)) {
+				++index;
+			}
+		}
+		return static_cast<float>(amount);
+	}
+
+	void RecordComparison(const Mismatch& a_comparison) noexcept
+	{
+		const std::scoped_lock lock(differentialLock);
+		++differentialStats.comparisons;
+		if (a_comparison.nativeResult != a_comparison.engineResult) {
+			++differentialStats.mismatches;
+			if (!differentialStats.firstMismatch) {
+				differentialStats.firstMismatch = a_comparison;
+			}
+		}
+	}
+
+	DifferentialStats TakeDifferentialStats() noexcept
+	{
+		const std::scoped_lock lock(differentialLock);
+		return std::exchange(differentialStats, {});
+	}
+}
\ No newline at end of file
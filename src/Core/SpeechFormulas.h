@@ -0,0 +1,40 @@
+#pragma once
+
+#include "DialogueEngine.h"
+#include "TopicDescriptor.h"
+
+// Closed-form versions of the game's GetIntimidateSuccess and GetBribeSuccess condition functions, so their outcome follows from
+// a few inputs that the engine reads once per dialogue list instead of calling into the game for every topic.
+// Based on: https://en.uesp.net/wiki/Skyrim:Speech#Bribe_Formula
+namespace SpeechFormulas
+{
+	// The speech level from which intimidating the speaker succeeds:
+	// (playerLevel + speech * fIntimidateSpeechcraftCurve) * intimidationPerkMult >= speakerLevel * fIntimidateConfidenceMult<Confidence>
+	// 0 if it always succeeds, infinity if it never does.
+	float GetRequiredIntimidationSpeechLevel(const Dialogue::SpeechCheckInputs& a_inputs) noexcept;
+
+	// The game already substituted <BribeCost> into the topic text, so the amount is read from the tag (e.g. "100 gold").
+	// nullopt if the tag doesn't contain a number, e.g. because a custom tag regex doesn't capture it.
+	std::optional<float> ParseBribeAmount(const std::string_view a_tagText) noexcept;
+
+	// In the differential mode of Settings::SPEECH_CHECK_EVALUATOR, the engine decides and the native results are compared with it.
+	struct Mismatch final
+	{
+		TopicProcessor::SPEECH_CHECK_TYPE checkType;
+		bool nativeResult;
+		bool engineResult;
+		float requiredValue;  // the required speech level or the bribe amount
+		float playerValue;    // the player's speech level or gold
+	};
+
+	struct DifferentialStats final
+	{
+		std::uint64_t comparisons;
+		std::uint64_t mismatches;
+		std::optional<Mismatch> firstMismatch;
+	};
+
+	void RecordComparison(const Mismatch& a_comparison) noexcept;
+	// since the last call, e.g. for a single dialogue
+	DifferentialStats TakeDifferentialStats() noexcept;
+}
\ No newline at end of file
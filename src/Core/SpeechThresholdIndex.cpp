@@ -0,0 +1,60 @@
+/*
+Copyright (C) 2025 Jonathan Feenstra
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+See EXCEPTIONS for additional permissions.
+*/
+
+#include "SpeechThresholdIndex.h"
+
+void SpeechThresholdIndex::Clear() noexcept
+{
+	thresholds.clear();
+	dependents.clear();
+}
+
+void SpeechThresholdIndex::InsertThreshold(const std::uint64_t a_key, const float a_requiredSpeechLevel)
+{
+	const Threshold threshold{ a_requiredSpeechLevel, a_key };
+	const auto it = std::ranges::lower_bound(thresholds, threshold);
+	if (it == thresholds.end() || *it != threshold) {
+		thresholds.insert(it, threshold);
+	}
+}
+
+void SpeechThresholdIndex::EraseThreshold(const std::uint64_t a_key, const float a_requiredSpeechLevel) noexcept
+{
+	const Threshold threshold{ a_requiredSpeechLevel, a_key };
+	const auto it = std::ranges::lower_bound(thresholds, threshold);
+	if (it != thresholds.end() && *it == threshold) {
+		thresholds.erase(it);
+	}
+}
+
+void SpeechThresholdIndex::InsertDependent(const std::uint64_t a_key)
+{
+	if (std::ranges::find(dependents, a_key) == dependents.end()) {
+		dependents.push_back(a_key);
+	}
+}
+
+void SpeechThresholdIndex::EraseDependent(const std::uint64_t a_key) noexcept
+{
+	if (const auto it = std::ranges::find(dependents, a_key); it != dependents.end()) {
+		// the order doesn't matter
+		*it = dependents.back();
+		dependents.pop_back();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+// Keeps track of which processed topics depend on the player's speech level, so a change of the speech level
+// only invalidates the persuasion checks whose required speech level it crossed instead of every topic.
+class SpeechThresholdIndex final
+{
+public:
+	void Clear() noexcept;
+
+	// a_key passes its check while the speech level is at least a_requiredSpeechLevel
+	void InsertThreshold(const std::uint64_t a_key, const float a_requiredSpeechLevel);
+	void EraseThreshold(const std::uint64_t a_key, const float a_requiredSpeechLevel) noexcept;
+
+	// a_key changes with every change of the speech level, e.g. because its format shows the speech level
+	void InsertDependent(const std::uint64_t a_key);
+	void EraseDependent(const std::uint64_t a_key) noexcept;
+
+	// Calls a_callback with the key of every topic that can be affected by changing the speech level from a_oldLevel to a_newLevel.
+	template <class Callback>
+	void ForEachAffected(const float a_oldLevel, const float a_newLevel, Callback&& a_callback) const
+	{
+		if (a_oldLevel == a_newLevel) {
+			return;
+		}
+
+		// a check with required speech level X flips if and only if min < X <= max
+		const auto [min, max] = std::minmax(a_oldLevel, a_newLevel);
+		const auto first = std::ranges::upper_bound(thresholds, min, {}, &Threshold::requiredSpeechLevel);
+		const auto last = std::ranges::upper_bound(first, thresholds.end(), max, {}, &Threshold::requiredSpeechLevel);
+		for (auto it = first; it != last; ++it) {
+			a_callback(it->key);
+		}
+		for (const auto key : dependents) {
+			a_callback(key);
+		}
+	}
+
+	std::size_t NumThresholds() const noexcept { return thresholds.size(); }
+	std::size_t NumDependents() const noexcept { return dependents.size(); }
+
+private:
+	struct Threshold final
+	{
+		float requiredSpeechLevel;
+		std::uint64_t key;
+
+		auto operator<=>(const Threshold&) const = default;
+	};
+
+	std::vector<Threshold> thresholds;  // sorted by required speech level
+	std::vector<std::uint64_t> dependents;
+};
\ No newline at end of file
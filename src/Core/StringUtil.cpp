@@ -0,0 +1,230 @@
+/*
+Copyright (C) 2025 Jonathan Feenstra
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+See EXCEPTIONS for additional permissions.
+*/
+
+#include "StringUtil.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#	define PP_X86_64
+#	if !defined(_MSC_VER)
+#		include <immintrin.h>
+#		define PP_TARGET_AVX2 __attribute__((target("avx2")))
+#	else
+#		define PP_TARGET_AVX2
+#	endif
+#endif
+
+namespace StringUtil
+{
+	namespace
+	{
+		constexpr char FoldCase(const char a_char) noexcept
+		{
+			return a_char >= 'A' && a_char <= 'Z' ? static_cast<char>(a_char | 0x20) : a_char;
+		}
+
+		bool LowerCaseEquals(const char* a_text, const std::string_view a_lowerCaseNeedle) noexcept
+		{
+			for (std::size_t i = 0; i < a_lowerCaseNeedle.size(); ++i) {
+				if (FoldCase(a_text[i]) != a_lowerCaseNeedle[i]) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		bool LowerCaseContainsScalar(const std::string_view a_hayStack, const std::string_view a_lowerCaseNeedle) noexcept
+		{
+			return std::search(
+					   a_hayStack.begin(),
+					   a_hayStack.end(),
+					   a_lowerCaseNeedle.begin(),
+					   a_lowerCaseNeedle.end(),
+					   [](char a, char b) {
+						   return FoldCase(a) == b;
+					   }) != a_hayStack.end();
+		}
+
+#ifdef PP_X86_64
+		// The vector kernels compare the first and last character of the needle at every position of a block at once,
+		// and only compare the characters between them at the positions where both match.
+		// See: http://0x80.pl/articles/simd-strfind.html#generic-sse-avx2
+		// Blocks that would read past the haystack are copied into a padded buffer first, so short topic names take a single block.
+		constexpr std::size_t kMaxVectorNeedle = 64;
+
+		// The haystack from a_position, padded with zeros so a block of a_blockSize characters can be read at every position in it.
+		const char* LoadPaddedBlock(const std::string_view a_hayStack, const std::size_t a_position, const std::size_t a_blockSize, std::span<char> a_buffer) noexcept
+		{
+			const auto rest = a_hayStack.size() - a_position;
+			if (rest >= a_blockSize) {
+				return a_hayStack.data() + a_position;
+			}
+			std::memcpy(a_buffer.data(), a_hayStack.data() + a_position, rest);
+			std::memset(a_buffer.data() + rest, 0, a_blockSize - rest);
+			return a_buffer.data();
+		}
+
+		// the positions in a block where the needle can start, as a bit mask
+		std::uint32_t GetPositionMask(const std::size_t a_numPositions) noexcept
+		{
+			return a_numPositions >= 32 ? UINT32_MAX : (1U << a_numPositions) - 1;
+		}
+
+		__m128i FoldCaseSSE2(const __m128i a_chars) noexcept
+		{
+			// shifts 'A'...'Z' to the lowest signed values, so a single signed comparison finds them
+			const auto shifted = _mm_add_epi8(a_chars, _mm_set1_epi8(static_cast<char>(0x80 - 'A')));
+			const auto isUpper = _mm_cmplt_epi8(shifted, _mm_set1_epi8(static_cast<char>(-0x80 + 26)));
+			return _mm_or_si128(a_chars, _mm_and_si128(isUpper, _mm_set1_epi8(0x20)));
+		}
+
+		bool LowerCaseContainsSSE2(const std::string_view a_hayStack, const std::string_view a_lowerCaseNeedle) noexcept
+		{
+			const auto size = a_lowerCaseNeedle.size();
+			if (size < 2 || size > kMaxVectorNeedle || a_hayStack.size() < size) {
+				return LowerCaseContainsScalar(a_hayStack, a_lowerCaseNeedle);
+			}
+
+			constexpr auto kBlock = sizeof(__m128i);
+			const auto first = _mm_set1_epi8(a_lowerCaseNeedle.front());
+			const auto last = _mm_set1_epi8(a_lowerCaseNeedle.back());
+			const auto middle = a_lowerCaseNeedle.substr(1, size - 2);
+			const auto numPositions = a_hayStack.size() - size + 1;
+			std::array<char, kBlock + kMaxVectorNeedle> buffer;
+			for (std::size_t position = 0; position < numPositions; position += kBlock) {
+				const auto block = LoadPaddedBlock(a_hayStack, position, kBlock + size - 1, buffer);
+				const auto blockFirst = FoldCaseSSE2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block)));
+				const auto blockLast = FoldCaseSSE2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block + size - 1)));
+				auto candidates = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(blockFirst, first), _mm_cmpeq_epi8(blockLast, last))));
+				candidates &= GetPositionMask(numPositions - position);
+				while (candidates) {
+					if (LowerCaseEquals(block + std::countr_zero(candidates) + 1, middle)) {
+						return true;
+					}
+					candidates &= candidates - 1;
+				}
+			}
+			return false;
+		}
+
+		PP_TARGET_AVX2 __m256i FoldCaseAVX2(const __m256i a_chars) noexcept
+		{
+			// AVX2 has no signed less-than comparison for bytes, so the bound is compared the other way around
+			const auto shifted = _mm256_add_epi8(a_chars, _mm256_set1_epi8(static_cast<char>(0x80 - 'A')));
+			const auto isUpper = _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(-0x80 + 26)), shifted);
+			return _mm256_or_si256(a_chars, _mm256_and_si256(isUpper, _mm256_set1_epi8(0x20)));
+		}
+
+		PP_TARGET_AVX2 bool LowerCaseContainsAVX2(const std::string_view a_hayStack, const std::string_view a_lowerCaseNeedle) noexcept
+		{
+			const auto size = a_lowerCaseNeedle.size();
+			if (size < 2 || size > kMaxVectorNeedle || a_hayStack.size() < size) {
+				return LowerCaseContainsScalar(a_hayStack, a_lowerCaseNeedle);
+			}
+			// most topic names fit in a single SSE2 block, which doesn't need to copy as many padding bytes
+			if (a_hayStack.size() - size + 1 <= sizeof(__m128i)) {
+				return LowerCaseContainsSSE2(a_hayStack, a_lowerCaseNeedle);
+			}
+
+			constexpr auto kBlock = sizeof(__m256i);
+			const auto first = _mm256_set1_epi8(a_lowerCaseNeedle.front());
+			const auto last = _mm256_set1_epi8(a_lowerCaseNeedle.back());
+			const auto middle = a_lowerCaseNeedle.substr(1, size - 2);
+			const auto numPositions = a_hayStack.size() - size + 1;
+			std::array<char, kBlock + kMaxVectorNeedle> buffer;
+			for (std::size_t position = 0; position < numPositions; position += kBlock) {
+				const auto block = LoadPaddedBlock(a_hayStack, position, kBlock + size - 1, buffer);
+				const auto blockFirst = FoldCaseAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(block)));
+				const auto blockLast = FoldCaseAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + size - 1)));
+				auto candidates = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(blockFirst, first), _mm256_cmpeq_epi8(blockLast, last))));
+				candidates &= GetPositionMask(numPositions - position);
+				while (candidates) {
+					if (LowerCaseEquals(block + std::countr_zero(candidates) + 1, middle)) {
+						return true;
+					}
+					candidates &= candidates - 1;
+				}
+			}
+			return false;
+		}
+
+		bool SupportsAVX2() noexcept
+		{
+#	ifdef _MSC_VER
+			int info[4];
+			__cpuid(info, 0);
+			if (info[0] < 7) {
+				return false;
+			}
+			__cpuid(info, 1);
+			constexpr auto kOSXSAVE = 1 << 27;
+			constexpr auto kAVX = 1 << 28;
+			if ((info[2] & (kOSXSAVE | kAVX)) != (kOSXSAVE | kAVX)) {
+				return false;
+			}
+			// the OS must save the upper halves of the YMM registers on context switches
+			if ((_xgetbv(0) & 0x6) != 0x6) {
+				return false;
+			}
+			__cpuidex(info, 7, 0);
+			return (info[1] & (1 << 5)) != 0;
+#	else
+			return __builtin_cpu_supports("avx2");
+#	endif
+		}
+#endif
+
+		using Kernel = bool (*)(std::string_view, std::string_view) noexcept;
+
+		Kernel GetKernel(const ISA a_isa) noexcept
+		{
+			switch (a_isa) {
+#ifdef PP_X86_64
+			case ISA::kAVX2:
+				return LowerCaseContainsAVX2;
+			case ISA::kSSE2:
+				return LowerCaseContainsSSE2;
+#endif
+			default:
+				return LowerCaseContainsScalar;
+			}
+		}
+	}
+
+	ISA GetSupportedISA() noexcept
+	{
+#ifdef PP_X86_64
+		// SSE2 is part of x86-64
+		static const auto isa = SupportsAVX2() ? ISA::kAVX2 : ISA::kSSE2;
+		return isa;
+#else
+		return ISA::kScalar;
+#endif
+	}
+
+	bool LowerCaseContains(const std::string_view a_hayStack, const std::string_view a_lowerCaseNeedle) noexcept
+	{
+		static const auto kernel = GetKernel(GetSupportedISA());
+		return kernel(a_hayStack, a_lowerCaseNeedle);
+	}
+
+	bool LowerCaseContains(const std::string_view a_hayStack, const std::string_view a_lowerCaseNeedle, const ISA a_isa) noexcept
+	{
+		return GetKernel(a_isa)(a_hayStack, a_lowerCaseNeedle);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,20 @@
+#pragma once
+
+namespace StringUtil
+{
+	// the instruction sets of the string kernels, from slowest to fastest
+	enum class ISA : std::uint8_t
+	{
+		kScalar,
+		kSSE2,
+		kAVX2,
+	};
+
+	// The fastest instruction set that this CPU and OS support, detected on the first call.
+	ISA GetSupportedISA() noexcept;
+
+	// Only folds ASCII letters, like std::tolower in the "C" locale. a_lowerCaseNeedle must already be lower case.
+	bool LowerCaseContains(const std::string_view a_hayStack, const std::string_view a_lowerCaseNeedle) noexcept;
+	// Uses the kernel for a_isa, which must not be faster than GetSupportedISA(), e.g. to compare the kernels with the scalar one.
+	bool LowerCaseContains(const std::string_view a_hayStack, const std::string_view a_lowerCaseNeedle, const ISA a_isa) noexcept;
+}
\ No newline at end of file
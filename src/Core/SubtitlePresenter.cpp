@@ -0,0 +1,104 @@
+/*
+Copyright (C) 2025 Jonathan Feenstra
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+See EXCEPTIONS for additional permissions.
+*/
+
+#include "SubtitlePresenter.h"
+
+#include "Profiler.h"
+#include "SessionRecorder.h"
+
+namespace Scaleform
+{
+	void SubtitlePresenter::Show(ISubtitleView& a_view, const TopicDisplayTable& a_topicDisplayData, const std::uint32_t a_entryIndex) noexcept
+	{
+		PROFILE_STAGE(kShowModSubtitle);
+		// the entries of EntriesA only change when the dialogue list does, which rebuilds the table, also if only its order changed
+		if (tableGeneration != a_topicDisplayData.GetGeneration()) {
+			tableGeneration = a_topicDisplayData.GetGeneration();
+			displayIndices.clear();
+			createdSubtitles.clear();
+		}
+
+		if (a_entryIndex >= displayIndices.size()) {
+			displayIndices.resize(a_entryIndex + 1, kUnknownIndex);
+		}
+		auto& displayIndex = displayIndices[a_entryIndex];
+		// the recorder needs the text of every selection
+		if (displayIndex == kUnknownIndex || SessionRecorder::IsRecording()) {
+			const auto text = a_view.GetEntryText(a_entryIndex);
+			if (!text || !*text)
+				return;
+
+			if (SessionRecorder::IsRecording()) {
+				SessionRecorder::RecordSelection(text);
+			}
+			displayIndex = a_topicDisplayData.FindIndex(text);
+		}
+		if (displayIndex == TopicDisplayTable::kNoEntry)
+			return;
+
+		const auto& displayData = a_topicDisplayData.GetEntry(displayIndex);
+		// the predicted response is only looked up for the topics the player highlights
+		if (const auto responseInfo = a_topicDisplayData.GetUnresolvedResponseInfo(displayData)) {
+			PROFILE_STAGE(kResponseText);
+			a_topicDisplayData.ResolveSubtitle(displayData, a_view.GetResponseText(responseInfo));
+		}
+
+		if (!a_topicDisplayData.HasSubtitle(displayData) && isGameSubtitle) {
+			// prevent hiding game subtitles by overwriting them with empty strings
+			const auto currentSubtitle = a_view.GetSubtitleText();
+			if (currentSubtitle) {
+				const std::string_view currentSubtitleStr(currentSubtitle);
+				if (!currentSubtitleStr.empty() && currentSubtitleStr != " ") {
+					return;
+				}
+			}
+		}
+
+		// a string created in the movie is passed to SetText as is, instead of being copied into the movie on every call
+		if (displayIndex >= createdSubtitles.size()) {
+			createdSubtitles.resize(a_topicDisplayData.Size());
+		}
+		if (!createdSubtitles[displayIndex]) {
+			a_view.CreateSubtitle(displayIndex, a_topicDisplayData.GetSubtitle(displayData));
+			createdSubtitles[displayIndex] = true;
+		}
+
+		if (!showsSubtitleColor) {
+			a_view.ApplySubtitleColor();
+			showsSubtitleColor = true;
+		}
+		a_view.ShowSubtitle(displayIndex);
+		isGameSubtitle = false;
+	}
+
+	void SubtitlePresenter::OnGameSubtitleShown() noexcept
+	{
+		isGameSubtitle = true;
+		showsSubtitleColor = false;
+	}
+
+	void SubtitlePresenter::Reset() noexcept
+	{
+		tableGeneration = UINT32_MAX;
+		displayIndices.clear();
+		createdSubtitles.clear();
+		isGameSubtitle = false;
+		showsSubtitleColor = false;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "TopicDisplayTable.h"
+
+namespace Scaleform
+{
+	// The entries of the topic list and the subtitle text field. The plugin implements this with GFx values, MemorySubtitleView with plain data.
+	class ISubtitleView
+	{
+	public:
+		virtual ~ISubtitleView() = default;
+
+		// the text of the entry at a_entryIndex of EntriesA, nullptr if there is none
+		virtual const char* GetEntryText(std::uint32_t a_entryIndex) noexcept = 0;
+		// the text the subtitle field shows, nullptr if it can't be read
+		virtual const char* GetSubtitleText() noexcept = 0;
+		// the text of the response the game would say, only valid until the next call
+		virtual std::string_view GetResponseText(Dialogue::TopicInfoHandle a_responseInfo) noexcept = 0;
+
+		// Creates a_text as a string in the movie, kept in a_slot until the view is released or the slot is created again.
+		virtual void CreateSubtitle(std::uint32_t a_slot, const char* a_text) noexcept = 0;
+		// shows the string created in a_slot in the subtitle field
+		virtual void ShowSubtitle(std::uint32_t a_slot) noexcept = 0;
+		virtual void ApplySubtitleColor() noexcept = 0;
+	};
+
+	// Shows the subtitles of the highlighted topics. It remembers which display entry each entry of the list has and which subtitles
+	// were created in the movie, so moving the selection reads little more than the highlighted index and passes an existing string to SetText.
+	class SubtitlePresenter final
+	{
+	public:
+		// Shows the subtitle of the entry at a_entryIndex of the list, unless it has none and would hide a game subtitle.
+		void Show(ISubtitleView& a_view, const TopicDisplayTable& a_topicDisplayData, std::uint32_t a_entryIndex) noexcept;
+		// the game replaced the subtitle with its own and restored the default colour
+		void OnGameSubtitleShown() noexcept;
+		// forgets the entries and subtitles of the movie, which is called when the menu opens and closes
+		void Reset() noexcept;
+
+	private:
+		static constexpr std::uint32_t kUnknownIndex = UINT32_MAX - 1;  // distinct from TopicDisplayTable::kNoEntry
+
+		std::uint32_t tableGeneration = UINT32_MAX;
+		std::vector<std::uint32_t> displayIndices;  // of each entry in EntriesA, looked up by text the first time it's highlighted
+		std::vector<bool> createdSubtitles;         // by display index, whether the view has the subtitle in its slot
+		bool isGameSubtitle = false;
+		bool showsSubtitleColor = false;  // reset when a game subtitle restores the default colour
+	};
+}
\ No newline at end of file
@@ -0,0 +1,701 @@
+/*
+Copyright (C) 2025 Jonathan Feenstra
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+See EXCEPTIONS for additional permissions.
+*/
+
+#include "TagMatcher.h"
+
+namespace
+{
+	enum ASSERTION : std::uint8_t
+	{
+		kBegin,
+		kEnd,
+		kWordBoundary,
+		kNotWordBoundary,
+	};
+
+	enum CAPTURE_SLOT : std::uint8_t
+	{
+		kMatchEnd,
+		kGroupStart,
+		kGroupEnd,
+	};
+
+	constexpr std::uint32_t kUnbounded = UINT32_MAX;
+
+	bool IsWordChar(const unsigned char a_char) noexcept
+	{
+		return std::isalnum(a_char) || a_char == '_';
+	}
+
+	bool IsHexDigit(const char a_char) noexcept
+	{
+		return std::isxdigit(static_cast<unsigned char>(a_char));
+	}
+}
+
+// Compiles the ECMAScript-like subset of regular expressions that is useful for tag patterns.
+// Concatenations are emitted in reverse order, because the automaton reads the topic text from end to start.
+class TagPatternCompiler final
+{
+public:
+	explicit TagPatternCompiler(TagMatcher& a_matcher) :
+		matcher(a_matcher) {}
+
+	void Add(const std::uint8_t a_patternIndex, const std::string_view a_pattern)
+	{
+		nodes.clear();
+		pattern = a_pattern;
+		pos = 0;
+		numGroups = 0;
+
+		const auto root = parseAlternation();
+		if (pos != pattern.size()) {
+			fail("unmatched ')'");
+		}
+
+		matcher.entryPoints[a_patternIndex] = static_cast<std::uint16_t>(matcher.program.size());
+		matcher.anchoredAtEnd[a_patternIndex] = endsWithEndAssertion(root);
+		emit(root);
+		push({ TagMatcher::OPCODE::kMatch, a_patternIndex, 0, 0 });
+	}
+
+private:
+	enum class NODE_TYPE : std::uint8_t
+	{
+		kClass,
+		kConcat,
+		kAlternate,
+		kRepeat,
+		kGroup,
+		kAssert,
+	};
+
+	struct Node final
+	{
+		NODE_TYPE type;
+		std::uint32_t value = 0;  // character class index, group number or assertion type
+		std::uint32_t min = 1;
+		std::uint32_t max = 1;
+		bool greedy = true;
+		std::vector<std::size_t> children;
+	};
+
+	TagMatcher& matcher;
+	std::vector<Node> nodes;
+	std::string_view pattern;
+	std::size_t pos = 0;
+	std::uint32_t numGroups = 0;
+
+	[[noreturn]] void fail(const std::string_view a_reason) const
+	{
+		throw std::invalid_argument(std::string(a_reason) + " at position " + std::to_string(pos) + " in \"" + std::string(pattern) + '"');
+	}
+
+	bool atEnd() const noexcept { return pos >= pattern.size(); }
+
+	bool consume(const char a_char) noexcept
+	{
+		if (!atEnd() && pattern[pos] == a_char) {
+			++pos;
+			return true;
+		}
+		return false;
+	}
+
+	std::size_t addNode(Node a_node)
+	{
+		nodes.push_back(std::move(a_node));
+		return nodes.size() - 1;
+	}
+
+	std::size_t addClass(const std::bitset<256>& a_class)
+	{
+		matcher.charClasses.push_back(a_class);
+		return addNode({ NODE_TYPE::kClass, static_cast<std::uint32_t>(matcher.charClasses.size() - 1) });
+	}
+
+	std::size_t addLiteral(const unsigned char a_char)
+	{
+		std::bitset<256> charClass;
+		charClass.set(a_char);
+		return addClass(charClass);
+	}
+
+	static void addRange(std::bitset<256>& a_class, const unsigned char a_first, const unsigned char a_last) noexcept
+	{
+		for (auto c = static_cast<std::uint32_t>(a_first); c <= a_last; ++c) {
+			a_class.set(c);
+		}
+	}
+
+	static bool addShorthandClass(std::bitset<256>& a_class, const char a_escape) noexcept
+	{
+		std::bitset<256> shorthand;
+		switch (std::tolower(static_cast<unsigned char>(a_escape))) {
+		case 'd':
+			addRange(shorthand, '0', '9');
+			break;
+		case 'w':
+			for (std::uint32_t c = 0; c < 256; ++c) {
+				shorthand.set(c, IsWordChar(static_cast<unsigned char>(c)));
+			}
+			break;
+		case 's':
+			for (const auto c : " \t\n\v\f\r"sv) {
+				shorthand.set(static_cast<unsigned char>(c));
+			}
+			break;
+		default:
+			return false;
+		}
+
+		a_class |= std::isupper(static_cast<unsigned char>(a_escape)) ? ~shorthand : shorthand;
+		return true;
+	}
+
+	unsigned char parseHex(const std::size_t a_digits)
+	{
+		if (pos + a_digits > pattern.size() || !std::all_of(pattern.begin() + pos, pattern.begin() + pos + a_digits, IsHexDigit)) {
+			fail("invalid hexadecimal escape");
+		}
+		const auto value = std::stoul(std::string(pattern.substr(pos, a_digits)), nullptr, 16);
+		pos += a_digits;
+		if (value > 0xFF) {
+			fail("escaped code points above \\xFF are not supported, use the UTF-8 text directly");
+		}
+		return static_cast<unsigned char>(value);
+	}
+
+	// escapes that represent a single character, both inside and outside brackets
+	unsigned char parseCharEscape(const char a_escape)
+	{
+		switch (a_escape) {
+		case 'n':
+			return '\n';
+		case 'r':
+			return '\r';
+		case 't':
+			return '\t';
+		case 'f':
+			return '\f';
+		case 'v':
+			return '\v';
+		case '0':
+			return '\0';
+		case 'x':
+			return parseHex(2);
+		case 'u':
+			return parseHex(4);
+		default:
+			if (a_escape >= '1' && a_escape <= '9') {
+				fail("backreferences are not supported");
+			}
+			return static_cast<unsigned char>(a_escape);
+		}
+	}
+
+	std::size_t parseAlternation()
+	{
+		const auto first = parseConcat();
+		if (atEnd() || pattern[pos] != '|') {
+			return first;
+		}
+
+		Node alternate{ NODE_TYPE::kAlternate };
+		alternate.children.push_back(first);
+		while (consume('|')) {
+			alternate.children.push_back(parseConcat());
+		}
+		return addNode(std::move(alternate));
+	}
+
+	std::size_t parseConcat()
+	{
+		Node concat{ NODE_TYPE::kConcat };
+		while (!atEnd() && pattern[pos] != '|' && pattern[pos] != ')') {
+			concat.children.push_back(parseQuantified());
+		}
+		return addNode(std::move(concat));
+	}
+
+	bool parseBound(std::uint32_t& a_value) noexcept
+	{
+		const auto start = pos;
+		a_value = 0;
+		while (!atEnd() && std::isdigit(static_cast<unsigned char>(pattern[pos])) && a_value < 1000) {
+			a_value = a_value * 10 + static_cast<std::uint32_t>(pattern[pos++] - '0');
+		}
+		return pos != start;
+	}
+
+	// parses {n}, {n,} or {m,n}, leaving the position unchanged when the brace is not a valid quantifier
+	bool parseBraces(std::uint32_t& a_min, std::uint32_t& a_max) noexcept
+	{
+		const auto start = pos;
+		++pos;
+		if (parseBound(a_min)) {
+			a_max = a_min;
+			if (consume(',')) {
+				if (!parseBound(a_max)) {
+					a_max = kUnbounded;
+				}
+			}
+			if (consume('}')) {
+				return true;
+			}
+		}
+		pos = start;
+		return false;
+	}
+
+	std::size_t parseQuantified()
+	{
+		const auto atom = parseAtom();
+		if (atEnd()) {
+			return atom;
+		}
+
+		std::uint32_t min;
+		std::uint32_t max;
+		switch (pattern[pos]) {
+		case '*':
+			++pos;
+			min = 0;
+			max = kUnbounded;
+			break;
+		case '+':
+			++pos;
+			min = 1;
+			max = kUnbounded;
+			break;
+		case '?':
+			++pos;
+			min = 0;
+			max = 1;
+			break;
+		case '{':
+			if (!parseBraces(min, max)) {
+				return atom;
+			}
+			if (min > max) {
+				fail("numbers out of order in {} quantifier");
+			}
+			break;
+		default:
+			return atom;
+		}
+
+		Node repeat{ NODE_TYPE::kRepeat, 0, min, max, !consume('?') };
+		repeat.children.push_back(atom);
+		return addNode(std::move(repeat));
+	}
+
+	std::size_t parseAtom()
+	{
+		const auto c = pattern[pos++];
+		switch (c) {
+		case '(':
+			{
+				Node group{ NODE_TYPE::kGroup };
+				if (consume('?')) {
+					if (!consume(':')) {
+						fail("lookaheads and named groups are not supported");
+					}
+				} else {
+					group.value = ++numGroups;
+				}
+				group.children.push_back(parseAlternation());
+				if (!consume(')')) {
+					fail("missing ')'");
+				}
+				return addNode(std::move(group));
+			}
+		case '[':
+			return parseBracket();
+		case '.':
+			{
+				std::bitset<256> any;
+				any.set();
+				any.reset('\n');
+				any.reset('\r');
+				return addClass(any);
+			}
+		case '^':
+			return addNode({ NODE_TYPE::kAssert, kBegin });
+		case '$':
+			return addNode({ NODE_TYPE::kAssert, kEnd });
+		case '*':
+		case '+':
+		case '?':
+			--pos;
+			fail("nothing to repeat");
+		case '\\':
+			return parseEscape();
+		default:
+			return addLiteral(static_cast<unsigned char>(c));
+		}
+	}
+
+	std::size_t parseEscape()
+	{
+		if (atEnd()) {
+			fail("trailing backslash");
+		}
+
+		const auto c = pattern[pos++];
+		if (c == 'b') {
+			return addNode({ NODE_TYPE::kAssert, kWordBoundary });
+		}
+		if (c == 'B') {
+			return addNode({ NODE_TYPE::kAssert, kNotWordBoundary });
+		}
+
+		std::bitset<256> charClass;
+		if (addShorthandClass(charClass, c)) {
+			return addClass(charClass);
+		}
+		return addLiteral(parseCharEscape(c));
+	}
+
+	std::size_t parseBracket()
+	{
+		std::bitset<256> charClass;
+		const auto negate = consume('^');
+		while (!consume(']')) {
+			if (atEnd()) {
+				fail("missing ']'");
+			}
+
+			auto first = static_cast<unsigned char>(pattern[pos++]);
+			if (first == '\\') {
+				if (atEnd()) {
+					fail("trailing backslash");
+				}
+				const auto escape = pattern[pos++];
+				if (addShorthandClass(charClass, escape)) {
+					continue;
+				}
+				first = escape == 'b' ? '\b' : parseCharEscape(escape);
+			}
+
+			if (pos + 1 < pattern.size() && pattern[pos] == '-' && pattern[pos + 1] != ']') {
+				++pos;
+				auto last = static_cast<unsigned char>(pattern[pos++]);
+				if (last == '\\') {
+					if (atEnd()) {
+						fail("trailing backslash");
+					}
+					last = parseCharEscape(pattern[pos++]);
+				}
+				if (first > last) {
+					fail("range out of order in character class");
+				}
+				addRange(charClass, first, last);
+			} else {
+				charClass.set(first);
+			}
+		}
+
+		return addClass(negate ? ~charClass : charClass);
+	}
+
+	bool endsWithEndAssertion(const std::size_t a_node) const noexcept
+	{
+		const auto& node = nodes[a_node];
+		switch (node.type) {
+		case NODE_TYPE::kAssert:
+			return node.value == kEnd;
+		case NODE_TYPE::kConcat:
+			return !node.children.empty() && endsWithEndAssertion(node.children.back());
+		case NODE_TYPE::kAlternate:
+			return std::all_of(node.children.begin(), node.children.end(), [this](const std::size_t a_child) { return endsWithEndAssertion(a_child); });
+		case NODE_TYPE::kGroup:
+			return endsWithEndAssertion(node.children.front());
+		case NODE_TYPE::kRepeat:
+			return node.min > 0 && endsWithEndAssertion(node.children.front());
+		default:
+			return false;
+		}
+	}
+
+	std::uint16_t push(const TagMatcher::Instruction a_instruction)
+	{
+		if (matcher.program.size() >= TagMatcher::kMaxInstructions) {
+			fail("pattern is too complex");
+		}
+		matcher.program.push_back(a_instruction);
+		return static_cast<std::uint16_t>(matcher.program.size() - 1);
+	}
+
+	std::uint16_t next() const noexcept { return static_cast<std::uint16_t>(matcher.program.size()); }
+
+	void emit(const std::size_t a_node)
+	{
+		using OPCODE = TagMatcher::OPCODE;
+
+		const auto& node = nodes[a_node];
+		switch (node.type) {
+		case NODE_TYPE::kClass:
+			push({ OPCODE::kClass, 0, static_cast<std::uint16_t>(node.value), 0 });
+			break;
+		case NODE_TYPE::kConcat:
+			for (auto it = node.children.rbegin(); it != node.children.rend(); ++it) {
+				emit(*it);
+			}
+			break;
+		case NODE_TYPE::kAlternate:
+			{
+				std::vector<std::uint16_t> jumpsToEnd;
+				for (std::size_t i = 0; i < node.children.size(); ++i) {
+					if (i + 1 == node.children.size()) {
+						emit(node.children[i]);
+						break;
+					}
+					const auto split = push({ OPCODE::kSplit });
+					matcher.program[split].x = next();
+					emit(node.children[i]);
+					jumpsToEnd.push_back(push({ OPCODE::kJump }));
+					matcher.program[split].y = next();
+				}
+				for (const auto jump : jumpsToEnd) {
+					matcher.program[jump].x = next();
+				}
+				break;
+			}
+		case NODE_TYPE::kRepeat:
+			{
+				const auto child = node.children.front();
+				for (std::uint32_t i = 0; i < node.min; ++i) {
+					emit(child);
+				}
+
+				if (node.max == kUnbounded) {
+					const auto split = push({ OPCODE::kSplit });
+					emit(child);
+					push({ OPCODE::kJump, 0, split });
+					const auto body = static_cast<std::uint16_t>(split + 1);
+					matcher.program[split].x = node.greedy ? body : next();
+					matcher.program[split].y = node.greedy ? next() : body;
+				} else {
+					std::vector<std::uint16_t> splits;
+					for (auto i = node.min; i < node.max; ++i) {
+						splits.push_back(push({ OPCODE::kSplit }));
+						emit(child);
+					}
+					for (const auto split : splits) {
+						const auto body = static_cast<std::uint16_t>(split + 1);
+						matcher.program[split].x = node.greedy ? body : next();
+						matcher.program[split].y = node.greedy ? next() : body;
+					}
+				}
+				break;
+			}
+		case NODE_TYPE::kGroup:
+			if (node.value == 1) {
+				push({ OPCODE::kSave, kGroupEnd });
+				emit(node.children.front());
+				push({ OPCODE::kSave, kGroupStart });
+			} else {
+				emit(node.children.front());
+			}
+			break;
+		case NODE_TYPE::kAssert:
+			push({ OPCODE::kAssert, static_cast<std::uint8_t>(node.value) });
+			break;
+		}
+	}
+};
+
+struct TagMatcher::ThreadList final
+{
+	struct Thread final
+	{
+		std::uint16_t pc;
+		Captures captures;
+	};
+
+	std::array<Thread, kMaxInstructions> threads;
+	std::bitset<kMaxInstructions> visited;
+	std::size_t size = 0;
+
+	void clear() noexcept
+	{
+		visited.reset();
+		size = 0;
+	}
+};
+
+std::string_view TagMatcher::Match::Group(const std::string_view a_text) const noexcept
+{
+	if (groupStart == kNoPosition || groupEnd == kNoPosition) {
+		return {};
+	}
+	return a_text.substr(groupStart, groupEnd - groupStart);
+}
+
+void TagMatcher::Compile(std::span<const std::string_view> a_patterns)
+{
+	if (a_patterns.size() > kMaxPatterns) {
+		throw std::invalid_argument("too many tag patterns");
+	}
+
+	TagMatcher compiled;
+	TagPatternCompiler compiler(compiled);
+	for (std::size_t i = 0; i < a_patterns.size(); ++i) {
+		compiler.Add(static_cast<std::uint8_t>(i), a_patterns[i]);
+	}
+	compiled.numPatterns = a_patterns.size();
+
+	compiled.hasFinalChars = std::all_of(compiled.anchoredAtEnd.begin(), compiled.anchoredAtEnd.begin() + compiled.numPatterns, [](const bool a_anchored) { return a_anchored; });
+	for (std::size_t i = 0; i < compiled.numPatterns && compiled.hasFinalChars; ++i) {
+		std::bitset<kMaxInstructions> visited;
+		compiled.hasFinalChars = compiled.collectFinalChars(compiled.entryPoints[i], visited);
+	}
+	*this = std::move(compiled);
+}
+
+TagMatcher::Matches TagMatcher::MatchAll(const std::string_view a_text) const noexcept
+{
+	Matches matches{};
+	if (numPatterns == 0 || a_text.size() >= kNoPosition) {
+		return matches;
+	}
+
+	// regular topics are rejected by their last character, before setting up the threads
+	if (hasFinalChars && (a_text.empty() || !finalChars.test(static_cast<unsigned char>(a_text.back())))) {
+		return matches;
+	}
+
+	const auto searchesEverywhere = std::any_of(anchoredAtEnd.begin(), anchoredAtEnd.begin() + numPatterns, [](const bool a_anchored) { return !a_anchored; });
+
+	ThreadList lists[2];
+	auto current = &lists[0];
+	auto next = &lists[1];
+
+	auto position = static_cast<std::uint32_t>(a_text.size());
+	for (std::size_t i = 0; i < numPatterns; ++i) {
+		addThread(*current, entryPoints[i], { position, kNoPosition, kNoPosition }, position, a_text, matches);
+	}
+
+	// reading the text backwards means patterns ending with $ die as soon as the last characters differ
+	while (position > 0 && (current->size > 0 || searchesEverywhere)) {
+		const auto c = static_cast<unsigned char>(a_text[position - 1]);
+		next->clear();
+		for (std::size_t i = 0; i < current->size; ++i) {
+			const auto& thread = current->threads[i];
+			if (charClasses[program[thread.pc].x].test(c)) {
+				addThread(*next, thread.pc + 1, thread.captures, position - 1, a_text, matches);
+			}
+		}
+
+		--position;
+		if (searchesEverywhere) {
+			for (std::size_t i = 0; i < numPatterns; ++i) {
+				if (!anchoredAtEnd[i]) {
+					addThread(*next, entryPoints[i], { position, kNoPosition, kNoPosition }, position, a_text, matches);
+				}
+			}
+		}
+		std::swap(current, next);
+	}
+
+	return matches;
+}
+
+bool TagMatcher::collectFinalChars(const std::uint16_t a_pc, std::bitset<kMaxInstructions>& a_visited) noexcept
+{
+	if (a_visited.test(a_pc)) {
+		return true;
+	}
+	a_visited.set(a_pc);
+
+	// assertions are assumed to hold, which can only add characters
+	const auto& instruction = program[a_pc];
+	switch (instruction.op) {
+	case OPCODE::kClass:
+		finalChars |= charClasses[instruction.x];
+		return true;
+	case OPCODE::kSplit:
+		return collectFinalChars(instruction.x, a_visited) && collectFinalChars(instruction.y, a_visited);
+	case OPCODE::kJump:
+		return collectFinalChars(instruction.x, a_visited);
+	case OPCODE::kSave:
+	case OPCODE::kAssert:
+		return collectFinalChars(a_pc + 1, a_visited);
+	default:
+		return false;
+	}
+}
+
+void TagMatcher::addThread(ThreadList& a_list, const std::uint16_t a_pc, Captures a_captures, const std::uint32_t a_position, const std::string_view a_text, Matches& a_matches) const noexcept
+{
+	if (a_list.visited.test(a_pc)) {
+		return;
+	}
+	a_list.visited.set(a_pc);
+
+	const auto& instruction = program[a_pc];
+	switch (instruction.op) {
+	case OPCODE::kClass:
+		a_list.threads[a_list.size++] = { a_pc, a_captures };
+		break;
+	case OPCODE::kSplit:
+		addThread(a_list, instruction.x, a_captures, a_position, a_text, a_matches);
+		addThread(a_list, instruction.y, a_captures, a_position, a_text, a_matches);
+		break;
+	case OPCODE::kJump:
+		addThread(a_list, instruction.x, a_captures, a_position, a_text, a_matches);
+		break;
+	case OPCODE::kSave:
+		a_captures[instruction.arg] = a_position;
+		addThread(a_list, a_pc + 1, a_captures, a_position, a_text, a_matches);
+		break;
+	case OPCODE::kAssert:
+		{
+			bool holds;
+			switch (instruction.arg) {
+			case kBegin:
+				holds = a_position == 0;
+				break;
+			case kEnd:
+				holds = a_position == a_text.size();
+				break;
+			default:
+				{
+					const auto wordBefore = a_position > 0 && IsWordChar(static_cast<unsigned char>(a_text[a_position - 1]));
+					const auto wordAfter = a_position < a_text.size() && IsWordChar(static_cast<unsigned char>(a_text[a_position]));
+					holds = (wordBefore != wordAfter) == (instruction.arg == kWordBoundary);
+				}
+			}
+			if (holds) {
+				addThread(a_list, a_pc + 1, a_captures, a_position, a_text, a_matches);
+			}
+			break;
+		}
+	case OPCODE::kMatch:
+		{
+			// the text is read backwards, so the last match found has the leftmost start like std::regex_search
+			auto& match = a_matches[instruction.arg];
+			if (!match.matched || a_position < match.start) {
+				match = { true, a_position, a_captures[kMatchEnd], a_captures[kGroupStart], a_captures[kGroupEnd] };
+			}
+			break;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+
+// Matches the speech check tag patterns from the [TagRegex] section without std::regex.
+// All patterns are compiled into a single reversed Thompson NFA that is simulated from the end of the topic text,
+// so regular topics are usually rejected after reading a single character and matching time is linear in the text length.
+class TagMatcher final
+{
+public:
+	static constexpr std::size_t kMaxPatterns = 4;
+	static constexpr std::size_t kMaxInstructions = 256;
+	static constexpr std::uint32_t kNoPosition = UINT32_MAX;
+
+	struct Match final
+	{
+		bool matched = false;
+		std::uint32_t start = kNoPosition;
+		std::uint32_t end = kNoPosition;
+		std::uint32_t groupStart = kNoPosition;  // first capturing group
+		std::uint32_t groupEnd = kNoPosition;
+
+		constexpr std::uint32_t Length() const noexcept { return matched ? end - start : 0; }
+		std::string_view Group(const std::string_view a_text) const noexcept;
+	};
+
+	using Matches = std::array<Match, kMaxPatterns>;
+
+	// Supports literals, escapes, character classes, groups, alternation, quantifiers and ^ $ \b \B assertions.
+	// Throws std::invalid_argument for invalid patterns or unsupported constructs such as backreferences and lookaheads.
+	void Compile(std::span<const std::string_view> a_patterns);
+
+	// Finds the leftmost match of every pattern in a single pass, without allocating memory.
+	Matches MatchAll(const std::string_view a_text) const noexcept;
+
+private:
+	enum class OPCODE : std::uint8_t
+	{
+		kClass,
+		kSplit,
+		kJump,
+		kSave,
+		kAssert,
+		kMatch,
+	};
+
+	struct Instruction final
+	{
+		OPCODE op;
+		std::uint8_t arg;  // capture slot, assertion type or pattern index
+		std::uint16_t x;   // character class index or first (preferred) jump target
+		std::uint16_t y;   // second jump target
+	};
+
+	using Captures = std::array<std::uint32_t, 3>;  // match end, group start, group end
+
+	struct ThreadList;
+
+	void addThread(ThreadList& a_list, std::uint16_t a_pc, Captures a_captures, std::uint32_t a_position, const std::string_view a_text, Matches& a_matches) const noexcept;
+	// adds the characters that the instructions reachable from a_pc without reading a character can read, returns false if a match is reachable
+	bool collectFinalChars(std::uint16_t a_pc, std::bitset<kMaxInstructions>& a_visited) noexcept;
+
+	std::vector<Instruction> program;
+	std::vector<std::bitset<256>> charClasses;
+	std::array<std::uint16_t, kMaxPatterns> entryPoints{};
+	std::array<bool, kMaxPatterns> anchoredAtEnd{};
+	std::size_t numPatterns = 0;
+	// the characters that every match ends with, if all patterns end with $ and can't match an empty text
+	std::bitset<256> finalChars;
+	bool hasFinalChars = false;
+
+	friend class TagPatternCompiler;
+};
\ No newline at end of file
@@ -0,0 +1,99 @@
+/*
+Copyright (C) 2025 Jonathan Feenstra
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+See EXCEPTIONS for additional permissions.
+*/
+
+#include "TagPresets.h"
+
+namespace
+{
+	// From the string files of each localization. Non-ASCII characters are escaped, because MSVC reads sources without a BOM in the system code page.
+	constexpr std::array kPresets{
+		TagPreset{ "ENGLISH", "Persuade", "Intimidate", " gold" },
+		// Überreden, Einschüchtern
+		TagPreset{ "GERMAN", "\xC3\x9C" "berreden", "Einsch\xC3\xBC" "chtern", " Gold" },
+		// pièces d'or
+		TagPreset{ "FRENCH", "Persuasion", "Intimidation", " pi\xC3\xA8" "ces d'or" },
+		// Persuasión, Intimidación
+		TagPreset{ "SPANISH", "Persuasi\xC3\xB3n", "Intimidaci\xC3\xB3n", " monedas de oro" },
+		TagPreset{ "ITALIAN", "Persuasione", "Intimidazione", " monete d'oro" },
+		// złota
+		TagPreset{ "POLISH", "Perswazja", "Zastraszenie", " szt. z\xC5\x82ota" },
+		// Убеждение, Запугивание, зол.
+		TagPreset{ "RUSSIAN", "\xD0\xA3\xD0\xB1\xD0\xB5\xD0\xB6\xD0\xB4\xD0\xB5\xD0\xBD\xD0\xB8\xD0\xB5", "\xD0\x97\xD0\xB0\xD0\xBF\xD1\x83\xD0\xB3\xD0\xB8\xD0\xB2\xD0\xB0\xD0\xBD\xD0\xB8\xD0\xB5", " \xD0\xB7\xD0\xBE\xD0\xBB." },
+		// 説得, 威圧, ゴールド
+		TagPreset{ "JAPANESE", "\xE8\xAA\xAC\xE5\xBE\x97", "\xE5\xA8\x81\xE5\x9C\xA7", "\xE3\x82\xB4\xE3\x83\xBC\xE3\x83\xAB\xE3\x83\x89" },
+		// 說服, 威嚇, 金幣
+		TagPreset{ "CHINESE", "\xE8\xAA\xAA\xE6\x9C\x8D", "\xE5\xA8\x81\xE5\x9A\x87", " \xE9\x87\x91\xE5\xB9\xA3" },
+	};
+
+	constexpr const TagPreset& kEnglish = kPresets.front();
+
+	// the preset matches like the default patterns
+	static_assert(kEnglish.MatchAll("I'll succeed here. (Persuade)")[0].groupStart == 20);
+	static_assert(kEnglish.MatchAll("Hand it over. (Intimidate)")[1].Length() == 13);
+	static_assert(kEnglish.MatchAll("Take it. (100 gold)")[2].start == 8);
+	static_assert(!kEnglish.MatchAll("Take it. ( gold)")[2].matched);
+	static_assert(!kEnglish.MatchAll("(Persuade)")[0].matched);
+
+	void AppendEscaped(std::string& a_pattern, const std::string_view a_literal)
+	{
+		for (const auto c : a_literal) {
+			if ("\\^$.|?*+()[]{}"sv.find(c) != std::string_view::npos) {
+				a_pattern += '\\';
+			}
+			a_pattern += c;
+		}
+	}
+}
+
+std::string TagPreset::GetPattern(const TopicProcessor::SPEECH_CHECK_TYPE a_checkType) const
+{
+	using SPEECH_CHECK_TYPE = TopicProcessor::SPEECH_CHECK_TYPE;
+
+	std::string pattern = " \\((";
+	switch (a_checkType) {
+	case SPEECH_CHECK_TYPE::kPersuade:
+		AppendEscaped(pattern, persuadeTag);
+		break;
+	case SPEECH_CHECK_TYPE::kIntimidate:
+		AppendEscaped(pattern, intimidateTag);
+		break;
+	default:
+		pattern += "\\d+";
+		AppendEscaped(pattern, bribeUnit);
+		break;
+	}
+	pattern += ")\\)$";
+	return pattern;
+}
+
+namespace TagPresets
+{
+	const TagPreset* Find(const std::string_view a_language) noexcept
+	{
+		const auto it = std::ranges::find_if(kPresets, [&](const TagPreset& a_preset) {
+			return std::ranges::equal(a_preset.language, a_language, [](const char a, const char b) { return a == std::toupper(static_cast<unsigned char>(b)); });
+		});
+		return it != kPresets.end() ? &*it : nullptr;
+	}
+
+	const TagPreset& GetEnglish() noexcept
+	{
+		return kEnglish;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "TagMatcher.h"
+#include "TopicDescriptor.h"
+
+// The speech check tags of a game language, which are matched by comparing suffixes instead of running TagMatcher.
+// Tags are " (<tag>)" at the end of the topic text, where the bribe tag is the amount of gold followed by bribeUnit.
+// The strings are UTF-8, with the same bytes as the game's string files.
+struct TagPreset final
+{
+	std::string_view language;  // the game's sLanguage
+	std::string_view persuadeTag;
+	std::string_view intimidateTag;
+	std::string_view bribeUnit;
+
+	// Matches the same texts and groups as GetPattern, indexed by SPEECH_CHECK_TYPE.
+	constexpr TagMatcher::Matches MatchAll(const std::string_view a_text) const noexcept;
+
+	// the equivalent [TagRegex] pattern, for combining the preset with custom patterns
+	std::string GetPattern(const TopicProcessor::SPEECH_CHECK_TYPE a_checkType) const;
+};
+
+namespace TagPresets
+{
+	// nullptr if there's no preset for a_language, which is compared case-insensitively
+	const TagPreset* Find(const std::string_view a_language) noexcept;
+	const TagPreset& GetEnglish() noexcept;
+}
+
+constexpr TagMatcher::Matches TagPreset::MatchAll(const std::string_view a_text) const noexcept
+{
+	using SPEECH_CHECK_TYPE = TopicProcessor::SPEECH_CHECK_TYPE;
+
+	TagMatcher::Matches matches{};
+	// every tag ends with a closing parenthesis, which rules out regular topics with a single comparison
+	if (a_text.size() >= TagMatcher::kNoPosition || !a_text.ends_with(')')) {
+		return matches;
+	}
+
+	const auto end = static_cast<std::uint32_t>(a_text.size());
+	const auto inner = a_text.substr(0, a_text.size() - 1);
+	const auto matchTag = [&](const SPEECH_CHECK_TYPE a_checkType, const std::size_t a_groupStart) {
+		if (a_groupStart >= 2 && inner.substr(a_groupStart - 2, 2) == " ("sv) {
+			matches[static_cast<std::size_t>(a_checkType)] = { true, static_cast<std::uint32_t>(a_groupStart - 2), end, static_cast<std::uint32_t>(a_groupStart), end - 1 };
+		}
+	};
+
+	if (inner.ends_with(persuadeTag)) {
+		matchTag(SPEECH_CHECK_TYPE::kPersuade, inner.size() - persuadeTag.size());
+	}
+	if (inner.ends_with(intimidateTag)) {
+		matchTag(SPEECH_CHECK_TYPE::kIntimidate, inner.size() - intimidateTag.size());
+	}
+	if (inner.ends_with(bribeUnit)) {
+		const auto amountEnd = inner.size() - bribeUnit.size();
+		auto amountStart = amountEnd;
+		while (amountStart > 0 && inner[amountStart - 1] >= '0' && inner[amountStart - 1] <= '9') {
+			--amountStart;
+		}
+		if (amountStart < amountEnd) {
+			matchTag(SPEECH_CHECK_TYPE::kBribe, amountStart);
+		}
+	}
+	return matches;
+}
\ No newline at end of file
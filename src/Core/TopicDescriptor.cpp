@@ -0,0 +1,108 @@
+/*
+Copyright (C) 2025 Jonathan Feenstra
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+See EXCEPTIONS for additional permissions.
+*/
+
+#include "TopicDescriptor.h"
+
+#include "StringUtil.h"
+
+namespace TopicProcessor
+{
+	namespace
+	{
+		using Dialogue::CONDITION_FUNCTION;
+
+		SPEECH_CHECK_TYPE GetCheckType(const Dialogue::ConditionData& a_data) noexcept
+		{
+			switch (a_data.function) {
+			case CONDITION_FUNCTION::kGetActorValue:
+				// e.g. a Speech condition on the speaker isn't a check of the player's speech level
+				return a_data.isSpeech && a_data.opCode == Dialogue::OPCODE::kGreaterThanOrEqualTo && a_data.RunsOnPlayer() ? SPEECH_CHECK_TYPE::kPersuade : SPEECH_CHECK_TYPE::kNone;
+			case CONDITION_FUNCTION::kGetBribeSuccess:
+				return SPEECH_CHECK_TYPE::kBribe;
+			case CONDITION_FUNCTION::kGetIntimidateSuccess:
+				return SPEECH_CHECK_TYPE::kIntimidate;
+			default:
+				return SPEECH_CHECK_TYPE::kNone;
+			}
+		}
+
+		// The response that is chosen after a failed speech check if none of the responses between them is:
+		// the first one without conditions, or the last one.
+		std::uint16_t FindFallbackInfo(const Dialogue::Engine& a_engine, const Dialogue::TopicHandle a_topic, const std::uint32_t a_checkInfoIndex, const std::uint32_t a_numInfos) noexcept
+		{
+			for (auto index = a_checkInfoIndex + 1; index < a_numInfos; ++index) {
+				const auto responseInfo = a_engine.topics.GetInfo(a_topic, index);
+				if (responseInfo && (!a_engine.topicInfos.GetFirstCondition(responseInfo) || index + 1 == a_numInfos)) {
+					return static_cast<std::uint16_t>(index);
+				}
+			}
+			return TopicDescriptor::kNoInfo;
+		}
+	}
+
+	TopicDescriptor DescribeTopic(const Dialogue::Engine& a_engine, const Dialogue::TopicHandle a_topic) noexcept
+	{
+		auto result = kRegularTopic;
+		if (StringUtil::LowerCaseContains(a_engine.topics.GetName(a_topic), "<bribecost>")) {
+			result.flags |= TopicDescriptor::kBribeCost;
+		}
+
+		// responses are chosen in order, so a response without conditions hides the speech checks after it
+		const auto numInfos = std::min<std::uint32_t>(a_engine.topics.GetNumInfos(a_topic), TopicDescriptor::kNoInfo);
+		for (std::uint32_t infoIndex = 0; infoIndex < numInfos; ++infoIndex) {
+			const auto responseInfo = a_engine.topics.GetInfo(a_topic, infoIndex);
+			if (!responseInfo)
+				continue;
+
+			auto conditionItem = a_engine.topicInfos.GetFirstCondition(responseInfo);
+			if (!conditionItem)
+				return result;
+
+			for (std::uint16_t conditionIndex = 0; conditionItem && conditionIndex < UINT16_MAX; ++conditionIndex) {
+				const auto data = a_engine.conditionItems.GetData(conditionItem);
+				const auto checkType = GetCheckType(data);
+				if (checkType == SPEECH_CHECK_TYPE::kNone) {
+					conditionItem = a_engine.conditionItems.GetNext(conditionItem);
+					continue;
+				}
+
+				result.checkType = checkType;
+				result.checkInfoIndex = static_cast<std::uint16_t>(infoIndex);
+				result.conditionIndex = conditionIndex;
+				result.fallbackInfoIndex = FindFallbackInfo(a_engine, a_topic, infoIndex, numInfos);
+				if (checkType == SPEECH_CHECK_TYPE::kPersuade) {
+					if (data.global) {
+						result.requiredSpeechLevelGlobalFormID = a_engine.globals.GetFormID(data.global);
+					} else {
+						result.requiredSpeechLevel = data.comparisonValue;
+					}
+
+					// persuasion checks are usually followed by checking if the Amulet of Articulation is equipped
+					const auto next = a_engine.conditionItems.GetNext(conditionItem);
+					if (data.isOR && next && a_engine.conditionItems.GetData(next).function == CONDITION_FUNCTION::kGetEquipped) {
+						result.flags |= TopicDescriptor::kAmuletOfArticulation;
+					}
+				}
+				return result;
+			}
+		}
+
+		return result;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "DialogueEngine.h"
+
+namespace TopicProcessor
+{
+	enum class SPEECH_CHECK_TYPE : std::uint8_t
+	{
+		kPersuade,
+		kIntimidate,
+		kBribe,
+		kNone,
+	};
+
+	// The parts of a topic's speech check that only depend on the load order, so they can be found once after loading
+	// instead of walking all responses and conditions of the topic at dialogue time.
+	struct TopicDescriptor final
+	{
+		static constexpr std::uint16_t kNoInfo = UINT16_MAX;
+
+		enum FLAG : std::uint8_t
+		{
+			kNone = 0,
+			kBribeCost = 1 << 0,           // the topic name contains the <BribeCost> placeholder
+			kAmuletOfArticulation = 1 << 1,  // the speech check is ORed with a GetEquipped condition
+		};
+
+		std::uint32_t requiredSpeechLevelGlobalFormID;  // 0 if the persuasion check compares with a constant
+		float requiredSpeechLevel;                      // the constant, the value of a global is read at dialogue time
+		std::uint16_t checkInfoIndex;                   // the first response with a speech check
+		std::uint16_t conditionIndex;                   // the speech check in the conditions of that response
+		std::uint16_t fallbackInfoIndex;                // the response after it that is chosen if no response in between is
+		SPEECH_CHECK_TYPE checkType;
+		std::uint8_t flags;
+
+		bool HasFlag(const FLAG a_flag) const noexcept { return (flags & a_flag) != 0; }
+	};
+	static_assert(sizeof(TopicDescriptor) == 16 && std::is_trivially_copyable_v<TopicDescriptor>);
+
+	// for topics without a speech check
+	inline constexpr TopicDescriptor kRegularTopic{ 0, 0.0F, TopicDescriptor::kNoInfo, 0, TopicDescriptor::kNoInfo, SPEECH_CHECK_TYPE::kNone, TopicDescriptor::kNone };
+
+	// Only reads the static data of the topic, so it can run on several topics in parallel.
+	TopicDescriptor DescribeTopic(const Dialogue::Engine& a_engine, const Dialogue::TopicHandle a_topic) noexcept;
+}
\ No newline at end of file
@@ -0,0 +1,184 @@
+/*
+Copyright (C) 2025 Jonathan Feenstra
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+See EXCEPTIONS for additional permissions.
+*/
+
+#include "TopicDisplayTable.h"
+
+#include "HashUtil.h"
+
+namespace Scaleform
+{
+	TopicDisplayTable::TopicDisplayTable(std::pmr::memory_resource* a_resource) noexcept :
+		resource(a_resource),
+		strings(a_resource),
+		entries(a_resource),
+		slots(a_resource),
+		deferredEntries(a_resource),
+		generation(0)
+	{}
+
+	void TopicDisplayTable::Clear() noexcept
+	{
+		strings.clear();
+		entries.clear();
+		slots.clear();
+		deferredEntries.clear();
+		++generation;
+	}
+
+	void TopicDisplayTable::Release() noexcept
+	{
+		// swapped with empty containers, because moving an empty string into one may keep its buffer;
+		// deallocating the old memory when the temporaries are destroyed does nothing in an arena
+		std::pmr::string(resource).swap(strings);
+		std::pmr::vector<Entry>(resource).swap(entries);
+		std::pmr::vector<std::uint32_t>(resource).swap(slots);
+		std::pmr::vector<DeferredEntry>(resource).swap(deferredEntries);
+		++generation;
+	}
+
+	void TopicDisplayTable::Insert(const std::string_view a_text, const TopicDisplayData& a_displayData, const std::string_view a_sourceText)
+	{
+		Entry entry{
+			HashUtil::Hash(a_text),
+			appendString(a_text),
+			static_cast<std::uint32_t>(a_text.size()),
+			appendString(a_displayData.subtitle),
+			static_cast<std::uint32_t>(a_displayData.subtitle.size()),
+			a_displayData.oldColor,
+			a_displayData.newColor,
+			kNoDeferredSubtitle
+		};
+		if (const auto& subtitle = a_displayData.deferredSubtitle) {
+			const auto mainText = a_sourceText.substr(0, subtitle->mainTextLength);
+			const auto tagText = subtitle->tagPlaceholder ? *subtitle->tagPlaceholder : a_sourceText.substr(subtitle->tagTextOffset, subtitle->tagTextLength);
+			entry.deferredIndex = static_cast<std::uint32_t>(deferredEntries.size());
+			deferredEntries.push_back({ subtitle->format,
+				subtitle->responseInfo,
+				appendString(mainText),
+				static_cast<std::uint32_t>(mainText.size()),
+				appendString(tagText),
+				static_cast<std::uint32_t>(tagText.size()),
+				appendString(subtitle->resultText),
+				static_cast<std::uint32_t>(subtitle->resultText.size()),
+				subtitle->requiredSpeechLevel,
+				subtitle->playerSpeechLevel,
+				false,
+				std::pmr::string(resource) });
+		}
+		entries.push_back(entry);
+	}
+
+	std::uint32_t TopicDisplayTable::appendString(const std::string_view a_string)
+	{
+		const auto offset = static_cast<std::uint32_t>(strings.size());
+		strings.append(a_string);
+		strings.push_back('\0');
+		return offset;
+	}
+
+	void TopicDisplayTable::Build()
+	{
+		const auto capacity = std::bit_ceil(std::max<std::size_t>(entries.size() * 2, 8));
+		const auto mask = capacity - 1;
+		slots.assign(capacity, kEmptySlot);
+		for (std::uint32_t i = 0; i < entries.size(); ++i) {
+			const auto& entry = entries[i];
+			for (auto slot = static_cast<std::size_t>(entry.hash) & mask;; slot = (slot + 1) & mask) {
+				const auto index = slots[slot];
+				if (index == kEmptySlot || (entries[index].hash == entry.hash && getText(entries[index]) == getText(entry))) {
+					// later entries replace earlier ones with the same text
+					slots[slot] = i;
+					break;
+				}
+			}
+		}
+	}
+
+	const char* TopicDisplayTable::GetSubtitle(const Entry& a_entry) const noexcept
+	{
+		if (a_entry.deferredIndex == kNoDeferredSubtitle) {
+			return strings.data() + a_entry.subtitleOffset;
+		}
+		const auto& deferredEntry = deferredEntries[a_entry.deferredIndex];
+		return deferredEntry.isResolved ? deferredEntry.resolvedSubtitle.c_str() : "";
+	}
+
+	bool TopicDisplayTable::HasSubtitle(const Entry& a_entry) const noexcept
+	{
+		if (a_entry.deferredIndex == kNoDeferredSubtitle) {
+			return a_entry.subtitleLength > 0;
+		}
+		const auto& deferredEntry = deferredEntries[a_entry.deferredIndex];
+		return deferredEntry.isResolved && !deferredEntry.resolvedSubtitle.empty();
+	}
+
+	Dialogue::TopicInfoHandle TopicDisplayTable::GetUnresolvedResponseInfo(const Entry& a_entry) const noexcept
+	{
+		if (a_entry.deferredIndex == kNoDeferredSubtitle) {
+			return nullptr;
+		}
+		const auto& deferredEntry = deferredEntries[a_entry.deferredIndex];
+		return deferredEntry.isResolved ? nullptr : deferredEntry.responseInfo;
+	}
+
+	void TopicDisplayTable::ResolveSubtitle(const Entry& a_entry, const std::string_view a_predictedResponseText) const
+	{
+		if (a_entry.deferredIndex == kNoDeferredSubtitle) {
+			return;
+		}
+
+		// the arguments point into strings, which doesn't change until the table is cleared
+		auto& deferredEntry = deferredEntries[a_entry.deferredIndex];
+		deferredEntry.format->Format(
+			deferredEntry.resolvedSubtitle,
+			{ getString(deferredEntry.mainTextOffset, deferredEntry.mainTextLength),
+				getString(deferredEntry.tagTextOffset, deferredEntry.tagTextLength),
+				getString(deferredEntry.resultTextOffset, deferredEntry.resultTextLength),
+				deferredEntry.requiredSpeechLevel,
+				a_predictedResponseText,
+				deferredEntry.playerSpeechLevel });
+		deferredEntry.isResolved = true;
+	}
+
+	const TopicDisplayTable::Entry* TopicDisplayTable::Find(const std::string_view a_text) const noexcept
+	{
+		const auto index = FindIndex(a_text);
+		return index != kNoEntry ? &entries[index] : nullptr;
+	}
+
+	std::uint32_t TopicDisplayTable::FindIndex(const std::string_view a_text) const noexcept
+	{
+		if (slots.empty()) {
+			return kNoEntry;
+		}
+
+		const auto hash = HashUtil::Hash(a_text);
+		const auto mask = slots.size() - 1;
+		for (auto slot = static_cast<std::size_t>(hash) & mask;; slot = (slot + 1) & mask) {
+			const auto index = slots[slot];
+			if (index == kEmptySlot) {
+				return kNoEntry;
+			}
+			const auto& entry = entries[index];
+			if (entry.hash == hash && getText(entry) == a_text) {
+				return index;
+			}
+		}
+	}
+}
\ No newline at end of file
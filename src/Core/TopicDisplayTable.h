@@ -0,0 +1,117 @@
+#pragma once
+
+#include "DialogueEngine.h"
+#include "FormatProgram.h"
+
+namespace Scaleform
+{
+	// A subtitle whose format shows the predicted response ({4}). Looking up the response text is expensive and it's only
+	// seen once the topic is highlighted, so the subtitle is formatted then instead of when the topic is processed.
+	struct DeferredSubtitle final
+	{
+		std::shared_ptr<const FormatProgram> format;  // keeps the settings snapshot it belongs to alive, so reloading the settings doesn't invalidate it
+		Dialogue::TopicInfoHandle responseInfo;
+		// The main text and the tag are parts of the topic text the subtitle was processed from. The owner of the display data keeps
+		// that text anyway and passes it to TopicDisplayTable::Insert, so only their positions are stored instead of copies.
+		std::uint32_t mainTextLength;  // the main text starts the topic text
+		std::uint32_t tagTextOffset;
+		std::uint32_t tagTextLength;
+		std::optional<std::string_view> tagPlaceholder;  // replaces the tag, points into the settings snapshot like resultText
+		std::string_view resultText;                     // points into the settings snapshot that format keeps alive
+		float requiredSpeechLevel;
+		float playerSpeechLevel;
+	};
+
+	// the ActionScript 2 code of the dialogue menu only has access to the text of the topics, so additional data needs to be passed
+	struct TopicDisplayData final
+	{
+		std::uint32_t oldColor;
+		std::uint32_t newColor;
+		std::string subtitle;
+		std::optional<DeferredSubtitle> deferredSubtitle;  // replaces subtitle if set
+	};
+
+	// Display data of the topics in the dialogue menu, looked up by topic text from the Scaleform function handlers.
+	// Entries are collected during kShow/kUpdate and then built into a flat open addressing table,
+	// so lookups with the const char* from a GFxValue don't need to allocate a std::string.
+	// Entries also have a stable index until the table is cleared, which handlers can remember instead of the text.
+	// All memory comes from a_resource, which is usually the SessionArena of the dialogue menu.
+	class TopicDisplayTable final
+	{
+	public:
+		struct Entry final
+		{
+			std::uint64_t hash;
+			std::uint32_t textOffset;
+			std::uint32_t textLength;
+			std::uint32_t subtitleOffset;
+			std::uint32_t subtitleLength;
+			std::uint32_t oldColor;
+			std::uint32_t newColor;
+			std::uint32_t deferredIndex;  // kNoDeferredSubtitle if the subtitle is already formatted
+		};
+
+		static constexpr std::uint32_t kNoEntry = UINT32_MAX;
+
+		explicit TopicDisplayTable(std::pmr::memory_resource* a_resource = std::pmr::get_default_resource()) noexcept;
+
+		// keeps the memory, so rebuilding the table during a session doesn't need to allocate again
+		void Clear() noexcept;
+		// Gives up all memory without freeing it, so the arena can be reset afterwards.
+		void Release() noexcept;
+		// a_sourceText is the topic text a_displayData was processed from, which a deferred subtitle takes its main text and tag from
+		void Insert(const std::string_view a_text, const TopicDisplayData& a_displayData, const std::string_view a_sourceText = {});
+		void Build();
+
+		const Entry* Find(const std::string_view a_text) const noexcept;
+		const Entry* Find(const char* a_text) const noexcept { return a_text ? Find(std::string_view(a_text)) : nullptr; }
+		// kNoEntry if there's no entry with a_text
+		std::uint32_t FindIndex(const std::string_view a_text) const noexcept;
+
+		const Entry& GetEntry(const std::uint32_t a_index) const noexcept { return entries[a_index]; }
+		std::uint32_t Size() const noexcept { return static_cast<std::uint32_t>(entries.size()); }
+		// changes whenever the table is cleared, which invalidates the indices of its entries
+		std::uint32_t GetGeneration() const noexcept { return generation; }
+
+		// null-terminated, so it can be passed to a GFxValue directly
+		const char* GetSubtitle(const Entry& a_entry) const noexcept;
+		bool HasSubtitle(const Entry& a_entry) const noexcept;
+
+		// the response whose text the subtitle still needs, nullptr if the subtitle doesn't need the predicted response or it's already resolved
+		Dialogue::TopicInfoHandle GetUnresolvedResponseInfo(const Entry& a_entry) const noexcept;
+		// Formats a deferred subtitle with the predicted response. Only caches the result, so it's allowed on a const table.
+		void ResolveSubtitle(const Entry& a_entry, const std::string_view a_predictedResponseText) const;
+
+	private:
+		static constexpr std::uint32_t kEmptySlot = UINT32_MAX;
+		static constexpr std::uint32_t kNoDeferredSubtitle = UINT32_MAX;
+
+		// the texts are stored in strings, like the topic texts
+		struct DeferredEntry final
+		{
+			std::shared_ptr<const FormatProgram> format;
+			Dialogue::TopicInfoHandle responseInfo;
+			std::uint32_t mainTextOffset;
+			std::uint32_t mainTextLength;
+			std::uint32_t tagTextOffset;
+			std::uint32_t tagTextLength;
+			std::uint32_t resultTextOffset;
+			std::uint32_t resultTextLength;
+			float requiredSpeechLevel;
+			float playerSpeechLevel;
+			bool isResolved;
+			std::pmr::string resolvedSubtitle;
+		};
+
+		std::pmr::memory_resource* resource;
+		std::pmr::string strings;
+		std::pmr::vector<Entry> entries;
+		std::pmr::vector<std::uint32_t> slots;
+		mutable std::pmr::vector<DeferredEntry> deferredEntries;
+		std::uint32_t generation;
+
+		std::string_view getText(const Entry& a_entry) const noexcept { return getString(a_entry.textOffset, a_entry.textLength); }
+		std::string_view getString(const std::uint32_t a_offset, const std::uint32_t a_length) const noexcept { return { strings.data() + a_offset, a_length }; }
+		std::uint32_t appendString(const std::string_view a_string);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+/*
+Copyright (C) 2025 Jonathan Feenstra
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+See EXCEPTIONS for additional permissions.
+*/
+
+#include "TopicListColors.h"
+
+#include "Profiler.h"
+
+namespace Scaleform
+{
+	bool ColorEntry(ITopicListView& a_view, const TopicDisplayTable& a_topicDisplayData, const std::uint32_t a_clipIndex) noexcept
+	{
+		const auto displayData = a_topicDisplayData.Find(a_view.GetEntryText(a_clipIndex));
+		if (!displayData)
+			return false;
+
+		a_view.SetEntryColor(a_clipIndex, a_view.IsEntryNew(a_clipIndex) ? displayData->newColor : displayData->oldColor);
+		return true;
+	}
+
+	std::uint32_t ColorEntries(ITopicListView& a_view, const TopicDisplayTable& a_topicDisplayData) noexcept
+	{
+		PROFILE_STAGE(kColorEntries);
+		std::uint32_t numColored = 0;
+		const auto numClips = a_view.GetNumEntryClips();
+		for (std::uint32_t clipIndex = 0; clipIndex < numClips; ++clipIndex) {
+			numColored += ColorEntry(a_view, a_topicDisplayData, clipIndex);
+		}
+		return numColored;
+	}
+
+	std::uint32_t ColorSelection(ITopicListView& a_view, const TopicDisplayTable& a_topicDisplayData, const std::int32_t a_previousIndex) noexcept
+	{
+		const auto selectedIndex = a_view.GetSelectedIndex();
+		if (selectedIndex == a_previousIndex)
+			return 0;
+
+		PROFILE_STAGE(kColorEntries);
+		std::uint32_t numColored = 0;
+		for (const auto entryIndex : { a_previousIndex, selectedIndex }) {
+			if (entryIndex < 0)
+				continue;
+
+			if (const auto clipIndex = a_view.GetEntryClipIndex(static_cast<std::uint32_t>(entryIndex)); clipIndex != ITopicListView::kNoClip) {
+				numColored += ColorEntry(a_view, a_topicDisplayData, clipIndex);
+			}
+		}
+		return numColored;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "TopicDisplayTable.h"
+
+namespace Scaleform
+{
+	// The entry clips of the topic list. The plugin implements this with GFx values, MemoryTopicListView with plain data.
+	// Every call crosses from native code into the movie at least once.
+	class ITopicListView
+	{
+	public:
+		static constexpr std::uint32_t kNoClip = UINT32_MAX;
+
+		virtual ~ITopicListView() = default;
+
+		virtual std::uint32_t GetNumEntryClips() noexcept = 0;
+		// nullptr if the clip doesn't show an entry
+		virtual const char* GetEntryText(std::uint32_t a_clipIndex) noexcept = 0;
+		virtual bool IsEntryNew(std::uint32_t a_clipIndex) noexcept = 0;
+		virtual void SetEntryColor(std::uint32_t a_clipIndex, std::uint32_t a_color) noexcept = 0;
+		// the clip that shows the entry at a_entryIndex of EntriesA, kNoClip if it's scrolled out of view
+		virtual std::uint32_t GetEntryClipIndex(std::uint32_t a_entryIndex) noexcept = 0;
+		// the index in EntriesA of the selected entry, -1 if there is none
+		virtual std::int32_t GetSelectedIndex() noexcept = 0;
+	};
+
+	// Colours the entry of one clip, as SetEntryText does every time the list draws an entry. Returns whether it was coloured.
+	bool ColorEntry(ITopicListView& a_view, const TopicDisplayTable& a_topicDisplayData, std::uint32_t a_clipIndex) noexcept;
+
+	// Colours all entry clips after the list was drawn, so drawing the list doesn't need to call native code for every entry.
+	// Returns the number of coloured entries.
+	std::uint32_t ColorEntries(ITopicListView& a_view, const TopicDisplayTable& a_topicDisplayData) noexcept;
+
+	// Colours the previous and new selection after doSetSelectedIndex, which redraws only these two entries with the colours of the game
+	// unless it scrolls the list, which redraws it with UpdateList. a_previousIndex is the selected index before the call.
+	// Returns the number of coloured entries.
+	std::uint32_t ColorSelection(ITopicListView& a_view, const TopicDisplayTable& a_topicDisplayData, std::int32_t a_previousIndex) noexcept;
+}
\ No newline at end of file
@@ -0,0 +1,360 @@
+/*
+Copyright (C) 2025 Jonathan Feenstra
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+See EXCEPTIONS for additional permissions.
+*/
+
+#include "TopicProcessor.h"
+
+#include "Profiler.h"
+#include "Settings.h"
+#include "SpeechFormulas.h"
+
+namespace TopicProcessor
+{
+	namespace
+	{
+		// formats straight into the string that ends up in the cache, which is only reallocated if it's too small
+		void ApplyFormat(
+			std::string& a_destination,
+			const FormatProgram& a_format,
+			const SpeechCheckData& a_speechCheckData,
+			const std::string_view a_resultText,
+			const float a_playerSpeechLevel) noexcept
+		{
+			PROFILE_STAGE(kFormat);
+			a_format.Format(
+				a_destination,
+				{ a_speechCheckData.mainText,
+					a_speechCheckData.tagText,
+					a_resultText,
+					a_speechCheckData.requiredSpeechLevel,
+					a_speechCheckData.predictedResponseText,
+					a_playerSpeechLevel });
+		}
+
+		void ApplyTagPlaceholder(SpeechCheckData& a_speechCheckData, const Settings& a_settings) noexcept
+		{
+			if (a_speechCheckData.checkType != SPEECH_CHECK_TYPE::kNone) {
+				a_speechCheckData.tagText = a_settings.GetProfile(a_speechCheckData.checkType).tagPlaceholder;
+			}
+		}
+
+		void HydrateTextData(SpeechCheckData& a_speechCheckData, const TopicDescriptor& a_descriptor, const std::string_view a_topicText, const Settings& a_settings) noexcept
+		{
+			PROFILE_STAGE(kTagMatch);
+			const auto tagMatches = a_settings.tagPreset ? a_settings.tagPreset->MatchAll(a_topicText) : a_settings.tagMatcher.MatchAll(a_topicText);
+			TagMatcher::Match tagMatch;
+			if (const auto& persuadeMatch = tagMatches[static_cast<std::size_t>(SPEECH_CHECK_TYPE::kPersuade)]; persuadeMatch.matched) {
+				a_speechCheckData.tagType = SPEECH_CHECK_TYPE::kPersuade;
+				tagMatch = persuadeMatch;
+			} else if (const auto& intimidateMatch = tagMatches[static_cast<std::size_t>(SPEECH_CHECK_TYPE::kIntimidate)]; intimidateMatch.matched) {
+				a_speechCheckData.tagType = SPEECH_CHECK_TYPE::kIntimidate;
+				tagMatch = intimidateMatch;
+			} else if (const auto& bribeMatch = tagMatches[static_cast<std::size_t>(SPEECH_CHECK_TYPE::kBribe)]; bribeMatch.matched) {
+				tagMatch = bribeMatch;
+				if (a_descriptor.HasFlag(TopicDescriptor::kBribeCost)) {
+					a_speechCheckData.tagType = SPEECH_CHECK_TYPE::kBribe;
+				}
+			}
+
+			a_speechCheckData.mainText = a_topicText.substr(0, a_topicText.size() - tagMatch.Length());
+			a_speechCheckData.tagText = tagMatch.Group(a_topicText);
+		}
+
+		bool EvaluateSpeechCheck(const Dialogue::Engine& a_engine, const Dialogue::ConditionItemHandle a_conditionItem, const bool a_checkForAmuletOfArticulation) noexcept
+		{
+			const auto& conditionItems = a_engine.conditionItems;
+			if (conditionItems.IsTrue(a_conditionItem))
+				return true;
+			// persuasion checks are usually followed by checking if the Amulet of Articulation is equipped
+			if (!a_checkForAmuletOfArticulation)
+				return false;
+			// the following forms should be the same here:
+			//const auto formToCheck = std::bit_cast<RE::TESForm*>(a_conditionItem->next->data.functionData.params[0]);
+			//const auto amuletOfArticulationFormList = RE::TESForm::LookupByEditorID("TGAmuletOfArticulationList");
+			return conditionItems.IsTrue(conditionItems.GetNext(a_conditionItem));
+		}
+
+		// Intimidation and bribes, whose required speech level or amount of gold is computed for {3} with every evaluator.
+		// kEngine only uses it for {3}, kDifferential still returns the result of the game's condition function, but records whether the computed one differs.
+		bool EvaluateIntimidationOrBribe(
+			SpeechCheckData& a_speechCheckData,
+			const Dialogue::Engine& a_engine,
+			const Dialogue::ConditionItemHandle a_conditionItem,
+			const bool a_checkForAmuletOfArticulation,
+			const Settings::SPEECH_CHECK_EVALUATOR a_evaluator) noexcept
+		{
+			const auto inputs = a_engine.actorValues.GetSpeechCheckInputs();
+			SpeechFormulas::Mismatch comparison{ a_speechCheckData.checkType, false, false, 0.0F, 0.0F };
+			if (a_speechCheckData.checkType == SPEECH_CHECK_TYPE::kIntimidate) {
+				comparison.requiredValue = SpeechFormulas::GetRequiredIntimidationSpeechLevel(inputs);
+				comparison.playerValue = a_engine.actorValues.GetPlayerSpeechLevel();
+			} else if (const auto bribeAmount = a_speechCheckData.tagType == SPEECH_CHECK_TYPE::kBribe ? SpeechFormulas::ParseBribeAmount(a_speechCheckData.tagText) : std::nullopt) {
+				comparison.requiredValue = *bribeAmount;
+				comparison.playerValue = inputs.playerGold;
+			} else if (a_evaluator != Settings::SPEECH_CHECK_EVALUATOR::kEngine) {
+				return a_engine.conditionItems.IsTrue(a_conditionItem);  // the bribe amount isn't known
+			}
+			a_speechCheckData.requiredSpeechLevel = comparison.requiredValue;
+			if (a_evaluator == Settings::SPEECH_CHECK_EVALUATOR::kEngine) {
+				return EvaluateSpeechCheck(a_engine, a_conditionItem, a_checkForAmuletOfArticulation);
+			}
+
+			// the condition compares the result of the function, e.g. GetIntimidateSuccess == 1
+			const auto data = a_engine.conditionItems.GetData(a_conditionItem);
+			const auto functionResult = comparison.playerValue >= comparison.requiredValue ? 1.0F : 0.0F;
+			comparison.nativeResult = Dialogue::Compare(functionResult, data.opCode, data.comparisonValue);
+			if (a_evaluator == Settings::SPEECH_CHECK_EVALUATOR::kNative) {
+				return comparison.nativeResult;
+			}
+			comparison.engineResult = a_engine.conditionItems.IsTrue(a_conditionItem);
+			SpeechFormulas::RecordComparison(comparison);
+			return comparison.engineResult;
+		}
+
+		// The first response in [a_first, a_last) whose conditions are true.
+		// Evaluating all conditions of a response sometimes returns false negatives, so this is only used when the speech check can't decide.
+		bool PredictResponse(SpeechCheckData& a_speechCheckData, const Dialogue::Engine& a_engine, const Dialogue::TopicHandle a_topic, const std::uint32_t a_first, const std::uint32_t a_last) noexcept
+		{
+			for (auto index = a_first; index < a_last; ++index) {
+				const auto responseInfo = a_engine.topics.GetInfo(a_topic, index);
+				if (responseInfo && a_engine.topicInfos.AreConditionsTrue(responseInfo)) {
+					a_speechCheckData.predictedResponseInfo = responseInfo;
+					return true;
+				}
+			}
+			return false;
+		}
+
+		// a_predictResponse is false if no format shows the predicted response, which skips evaluating responses that only serve to predict it
+		void HydrateCheckData(
+			SpeechCheckData& a_speechCheckData,
+			const Dialogue::Engine& a_engine,
+			const Dialogue::TopicHandle a_topic,
+			const TopicDescriptor& a_descriptor,
+			const Settings::SPEECH_CHECK_EVALUATOR a_evaluator,
+			const bool a_predictResponse) noexcept
+		{
+			PROFILE_STAGE(kConditions);
+			// based on: https://github.com/Scrabx3/Dynamic-Dialogue-Replacer/blob/3ffe893f741a9e1530c9bcb5577465b6e9ccad0b/src/Hooks/Hooks.cpp#L96-L105
+			const auto numInfos = a_engine.topics.GetNumInfos(a_topic);
+			if (a_descriptor.checkType == SPEECH_CHECK_TYPE::kNone) {
+				// the predicted response is only shown for tagged topics
+				if (a_predictResponse && a_speechCheckData.tagType != SPEECH_CHECK_TYPE::kNone) {
+					for (std::uint32_t index = 0; index < numInfos; ++index) {
+						const auto responseInfo = a_engine.topics.GetInfo(a_topic, index);
+						if (responseInfo && (!a_engine.topicInfos.GetFirstCondition(responseInfo) || index + 1 == numInfos || a_engine.topicInfos.AreConditionsTrue(responseInfo))) {
+							a_speechCheckData.predictedResponseInfo = responseInfo;
+							return;
+						}
+					}
+				}
+				return;
+			}
+
+			// the responses before the speech check all have conditions, and for tagged topics they take precedence over the speech check
+			if (a_speechCheckData.tagType != SPEECH_CHECK_TYPE::kNone && PredictResponse(a_speechCheckData, a_engine, a_topic, 0, a_descriptor.checkInfoIndex)) {
+				return;
+			}
+
+			const auto checkInfo = a_descriptor.checkInfoIndex < numInfos ? a_engine.topics.GetInfo(a_topic, a_descriptor.checkInfoIndex) : nullptr;
+			auto conditionItem = checkInfo ? a_engine.topicInfos.GetFirstCondition(checkInfo) : nullptr;
+			for (std::uint32_t index = 0; conditionItem && index < a_descriptor.conditionIndex; ++index) {
+				conditionItem = a_engine.conditionItems.GetNext(conditionItem);
+			}
+			if (!conditionItem) {
+				return;  // the descriptor doesn't match the topic
+			}
+
+			a_speechCheckData.checkType = a_descriptor.checkType;
+			const auto checkForAmuletOfArticulation = a_descriptor.HasFlag(TopicDescriptor::kAmuletOfArticulation);
+			if (a_descriptor.checkType != SPEECH_CHECK_TYPE::kPersuade) {
+				a_speechCheckData.passesCheck = EvaluateIntimidationOrBribe(a_speechCheckData, a_engine, conditionItem, checkForAmuletOfArticulation, a_evaluator);
+			} else {
+				// the global isn't constant, so its value is read now
+				const auto data = a_engine.conditionItems.GetData(conditionItem);
+				a_speechCheckData.requiredSpeechLevel = data.comparisonValue;
+				a_speechCheckData.requiredSpeechLevelGlobal = data.global;
+				a_speechCheckData.passesCheck = EvaluateSpeechCheck(a_engine, conditionItem, checkForAmuletOfArticulation);
+			}
+			if (!a_predictResponse) {
+				return;
+			}
+
+			if (a_speechCheckData.passesCheck || a_descriptor.checkInfoIndex + 1u == numInfos || a_engine.topicInfos.AreConditionsTrue(checkInfo)) {
+				a_speechCheckData.predictedResponseInfo = checkInfo;
+				return;
+			}
+
+			// The speech check didn't pass, so one of the following responses is chosen, at the latest the fallback response.
+			// The fallback response either has no conditions, or is the last option left, in which case the conditions would actually still need to be evaluated,
+			// but sometimes this returns false negatives. Therefore, it is the most likely one to be chosen based on the available information.
+			const auto fallbackInfoIndex = std::min<std::uint32_t>(a_descriptor.fallbackInfoIndex, numInfos);
+			if (PredictResponse(a_speechCheckData, a_engine, a_topic, a_descriptor.checkInfoIndex + 1u, fallbackInfoIndex)) {
+				return;
+			}
+			if (fallbackInfoIndex < numInfos) {
+				a_speechCheckData.predictedResponseInfo = a_engine.topics.GetInfo(a_topic, fallbackInfoIndex);
+			}
+		}
+
+		void LookUpPredictedResponse(SpeechCheckData& a_speechCheckData, const Dialogue::Engine& a_engine) noexcept
+		{
+			if (a_speechCheckData.predictedResponseInfo && a_speechCheckData.predictedResponseText.empty()) {
+				PROFILE_STAGE(kResponseText);
+				a_speechCheckData.predictedResponseText = a_engine.responseTexts.GetResponseText(a_speechCheckData.predictedResponseInfo);
+			}
+		}
+
+		// GetSpeechCheckData without looking up the text of the predicted response
+		SpeechCheckData CollectSpeechCheckData(
+			const Dialogue::Engine& a_engine,
+			const Dialogue::TopicHandle a_topic,
+			const TopicDescriptor* a_descriptor,
+			const std::string_view a_topicText,
+			const Settings& a_settings,
+			const bool a_predictResponse) noexcept
+		{
+			SpeechCheckData result{ {}, {}, SPEECH_CHECK_TYPE::kNone, SPEECH_CHECK_TYPE::kNone, false, 0.0F, nullptr, nullptr, {} };
+			if (!a_topic)
+				return result;
+
+			const auto descriptor = a_descriptor ? *a_descriptor : DescribeTopic(a_engine, a_topic);
+			HydrateTextData(result, descriptor, a_topicText, a_settings);
+			HydrateCheckData(result, a_engine, a_topic, descriptor, a_settings.speechCheckEvaluator, a_predictResponse);
+			if (result.tagType == SPEECH_CHECK_TYPE::kNone) {
+				ApplyTagPlaceholder(result, a_settings);
+			}
+			return result;
+		}
+	}
+
+	ProcessedTopic ProcessTopic(
+		const Dialogue::Engine& a_engine,
+		const Dialogue::TopicHandle a_topic,
+		const TopicDescriptor* a_descriptor,
+		const std::string_view a_topicText,
+		const Settings& a_settings) noexcept
+	{
+		PROFILE_STAGE(kProcessTopic);
+		auto speechCheckData = CollectSpeechCheckData(a_engine, a_topic, a_descriptor, a_topicText, a_settings, a_settings.showsPredictedResponse);
+		// the topic text is only copied if it isn't formatted, so each output string is written once
+		ProcessedTopic result{
+			{},
+			std::nullopt,
+			SPEECH_DEPENDENCY::kNone,
+			speechCheckData.requiredSpeechLevel,
+			speechCheckData.requiredSpeechLevelGlobal,
+			true
+		};
+		SPEECH_CHECK_TYPE impliedCheckType;
+		Scaleform::TopicDisplayData displayData;
+		std::string_view resultText;  // points into a_settings
+
+		if (speechCheckData.checkType != SPEECH_CHECK_TYPE::kNone) {
+			impliedCheckType = speechCheckData.checkType;
+			if (speechCheckData.passesCheck) {
+				resultText = a_settings.checkSuccessText;
+				displayData.newColor = a_settings.successColor;
+				displayData.oldColor = a_settings.successColor;
+			} else {
+				resultText = a_settings.checkFailureText;
+				displayData.newColor = a_settings.failureColorNew;
+				displayData.oldColor = a_settings.failureColorOld;
+			}
+		} else if (speechCheckData.tagType != SPEECH_CHECK_TYPE::kNone) {
+			impliedCheckType = speechCheckData.tagType;
+			resultText = a_settings.noCheckText;
+			displayData.newColor = a_settings.noCheckColorNew;
+			displayData.oldColor = a_settings.noCheckColorOld;
+		} else {
+			if (a_settings.applyTopicColors) {
+				displayData.newColor = a_settings.regularColorNew;
+				displayData.oldColor = a_settings.regularColorOld;
+				result.displayData = displayData;
+			}
+
+			result.topicText = a_topicText;
+			result.dependsOnConditions = false;
+			return result;  // regular topics don't need topic formatting or subtitles
+		}
+
+		const auto playerSpeechLevel = a_engine.actorValues.GetPlayerSpeechLevel();
+		auto showsPlayerSpeechLevel = false;
+		const auto& profile = a_settings.GetProfile(impliedCheckType);
+
+		if (a_settings.applyTopicFormatting) {
+			const auto& topicFormat = profile.topicFormat;
+			if (topicFormat.UsesArgument(4)) {
+				LookUpPredictedResponse(speechCheckData, a_engine);
+			}
+			ApplyFormat(result.topicText, topicFormat, speechCheckData, resultText, playerSpeechLevel);
+			showsPlayerSpeechLevel = topicFormat.UsesArgument(5);
+		} else {
+			result.topicText = a_topicText;
+		}
+
+		if (a_settings.showSubtitles == Settings::SHOW_SUBTITLES::kForAllSpeechChecks || (a_settings.showSubtitles == Settings::SHOW_SUBTITLES::kOnlyForNoCheck && speechCheckData.checkType == SPEECH_CHECK_TYPE::kNone)) {
+			const auto& subtitleFormat = profile.subtitleFormat;
+			if (subtitleFormat.UsesArgument(4) && speechCheckData.predictedResponseInfo && speechCheckData.predictedResponseText.empty()) {
+				// Topics without a tag of their own have the tag placeholder (see ApplyTagPlaceholder), the other tags are in a_topicText.
+				const auto& tagText = speechCheckData.tagText;
+				const auto hasTagPlaceholder = speechCheckData.tagType == SPEECH_CHECK_TYPE::kNone;
+				displayData.deferredSubtitle = Scaleform::DeferredSubtitle{
+					std::shared_ptr<const FormatProgram>(a_settings.shared_from_this(), &subtitleFormat),
+					speechCheckData.predictedResponseInfo,
+					static_cast<std::uint32_t>(speechCheckData.mainText.size()),
+					hasTagPlaceholder || tagText.empty() ? 0 : static_cast<std::uint32_t>(tagText.data() - a_topicText.data()),
+					hasTagPlaceholder ? 0 : static_cast<std::uint32_t>(tagText.size()),
+					hasTagPlaceholder ? std::optional(tagText) : std::nullopt,
+					resultText,
+					speechCheckData.requiredSpeechLevel,
+					playerSpeechLevel
+				};
+			} else {
+				ApplyFormat(displayData.subtitle, subtitleFormat, speechCheckData, resultText, playerSpeechLevel);
+			}
+			showsPlayerSpeechLevel = showsPlayerSpeechLevel || subtitleFormat.UsesArgument(5);
+			result.displayData = displayData;
+		} else if (a_settings.applyTopicColors) {
+			result.displayData = displayData;
+		}
+
+		// Bribes depend on the speech level through the amount in the topic text, and the game's intimidation check can't be reduced to a threshold.
+		// The native intimidation formula can, because its other inputs (the player's level and the speaker) invalidate the cache anyway.
+		const auto hasIntimidationThreshold = speechCheckData.checkType == SPEECH_CHECK_TYPE::kIntimidate && a_settings.speechCheckEvaluator == Settings::SPEECH_CHECK_EVALUATOR::kNative;
+		if (showsPlayerSpeechLevel || (speechCheckData.checkType == SPEECH_CHECK_TYPE::kIntimidate && !hasIntimidationThreshold) || speechCheckData.checkType == SPEECH_CHECK_TYPE::kBribe) {
+			result.speechDependency = SPEECH_DEPENDENCY::kAlways;
+		} else if (speechCheckData.checkType == SPEECH_CHECK_TYPE::kPersuade || hasIntimidationThreshold) {
+			result.speechDependency = SPEECH_DEPENDENCY::kThreshold;
+		}
+
+		return result;
+	}
+
+	SpeechCheckData GetSpeechCheckData(
+		const Dialogue::Engine& a_engine,
+		const Dialogue::TopicHandle a_topic,
+		const TopicDescriptor* a_descriptor,
+		const std::string_view a_topicText,
+		const Settings& a_settings) noexcept
+	{
+		auto result = CollectSpeechCheckData(a_engine, a_topic, a_descriptor, a_topicText, a_settings, true);
+		LookUpPredictedResponse(result, a_engine);
+		return result;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "DialogueEngine.h"
+#include "FormatProgram.h"
+#include "Settings.h"
+#include "TopicDescriptor.h"
+#include "TopicDisplayTable.h"
+
+// Classifies a dialogue topic as a speech check, predicts its outcome and formats its text and display data.
+namespace TopicProcessor
+{
+	// Only views into the topic text, the settings snapshot and the response text of the engine, so it's trivially copyable.
+	// It's valid as long as the topic text and the settings are, and predictedResponseText until the engine looks up another response text.
+	struct SpeechCheckData final
+	{
+		std::string_view mainText;
+		std::string_view tagText;  // the tag in the topic text, or the tag placeholder of the settings
+		SPEECH_CHECK_TYPE tagType;
+		SPEECH_CHECK_TYPE checkType;
+		bool passesCheck;
+		float requiredSpeechLevel;  // for persuasion and intimidation, the amount of gold for bribes (see SpeechFormulas.h)
+		Dialogue::GlobalHandle requiredSpeechLevelGlobal;
+		Dialogue::TopicInfoHandle predictedResponseInfo;  // nullptr if no response is predicted
+		std::string_view predictedResponseText;           // only looked up if a format shows it
+	};
+	static_assert(std::is_trivially_copyable_v<SpeechCheckData>);
+
+	// how the result of processing a topic depends on the player's speech level
+	enum class SPEECH_DEPENDENCY : std::uint8_t
+	{
+		kNone,
+		kThreshold,  // a persuasion check or natively evaluated intimidation, which only changes when the speech level crosses the required speech level
+		kAlways,     // other intimidation, bribes, and topics whose format shows the player's speech level
+	};
+
+	struct ProcessedTopic final
+	{
+		std::string topicText;
+		std::optional<Scaleform::TopicDisplayData> displayData;
+		SPEECH_DEPENDENCY speechDependency;
+		float requiredSpeechLevel;
+		Dialogue::GlobalHandle requiredSpeechLevelGlobal;  // for persuasion checks that compare with a global such as SpeechAverage
+		bool dependsOnConditions;                          // false for regular topics, whose result only depends on their text and the settings
+	};
+
+	// a_descriptor can be nullptr if the topic isn't indexed, it's then described on the fly.
+	// A deferred subtitle in the result refers to parts of a_topicText, which has to be passed to TopicDisplayTable::Insert with it.
+	ProcessedTopic ProcessTopic(
+		const Dialogue::Engine& a_engine,
+		const Dialogue::TopicHandle a_topic,
+		const TopicDescriptor* a_descriptor,
+		const std::string_view a_topicText,
+		const Settings& a_settings) noexcept;
+
+	SpeechCheckData GetSpeechCheckData(
+		const Dialogue::Engine& a_engine,
+		const Dialogue::TopicHandle a_topic,
+		const TopicDescriptor* a_descriptor,
+		const std::string_view a_topicText,
+		const Settings& a_settings) noexcept;
+}
\ No newline at end of file
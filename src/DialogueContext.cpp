@@ -0,0 +1,64 @@
+/*
+Copyright (C) 2025 Jonathan Feenstra
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+See EXCEPTIONS for additional permissions.
+*/
+
+
+#include "DialogueContext.h"
+
+DialogueContext::DialogueContext(RE::NiPointer<RE::TESObjectREFR> a_speaker, std::shared_ptr<const Settings> a_settings) noexcept :
+	speaker(std::move(a_speaker)),
+	speakerActor(speaker ? speaker->As<RE::Actor>() : nullptr),
+	speakerFormID(speaker ? speaker->GetFormID() : 0),
+	player(RE::PlayerCharacter::GetSingleton()),
+	checkParams(speaker.get(), player),
+	playerSpeechLevel(player->AsActorValueOwner()->GetActorValue(RE::ActorValue::kSpeech)),
+	settings(std::move(a_settings))
+{
+}
+
+bool DialogueContext::IsEquippedConditionTrue(const RE::TESConditionItem* a_conditionItem) const noexcept
+{
+	const auto& data = a_conditionItem->data;
+	// other references than the speaker and the player aren't part of the key, and globals can change
+	const auto isSubjectOrTarget = data.object == RE::CONDITIONITEMOBJECT::kSelf || data.object == RE::CONDITIONITEMOBJECT::kTarget;
+	if (!isSubjectOrTarget || data.flags.global) {
+		auto params = checkParams;
+		return a_conditionItem->IsTrue(params);
+	}
+
+	const EquippedCondition key{
+		data.functionData.params[0],
+		static_cast<std::uint8_t>(data.object),
+		static_cast<bool>(data.flags.swapTarget),
+		static_cast<std::uint8_t>(data.flags.opCode),
+		data.comparisonValue.f,
+		false
+	};
+	const auto it = std::ranges::find_if(equippedConditions, [&](const EquippedCondition& a_condition) {
+		return a_condition.item == key.item && a_condition.object == key.object && a_condition.swapsSubjectAndTarget == key.swapsSubjectAndTarget && a_condition.opCode == key.opCode &&
+			a_condition.comparisonValue == key.comparisonValue;
+	});
+	if (it != equippedConditions.end()) {
+		return it->isTrue;
+	}
+
+	auto params = checkParams;
+	auto& condition = equippedConditions.emplace_back(key);
+	condition.isTrue = a_conditionItem->IsTrue(params);
+	return condition.isTrue;
+}
\ No newline at end of file
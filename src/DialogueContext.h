@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Settings.h"
+
+// What processing a dialogue list reads from the game that can't change while the list is processed, resolved once per kShow/kUpdate
+// (and prefetch step), so the topics don't look up the same singletons, references and actor values again.
+struct DialogueContext final
+{
+	DialogueContext(RE::NiPointer<RE::TESObjectREFR> a_speaker, std::shared_ptr<const Settings> a_settings) noexcept;
+
+	// A GetEquipped condition, such as the check for the Amulet of Articulation that follows most persuasion checks.
+	// The first one is evaluated, identical conditions of other topics are answered with its result.
+	bool IsEquippedConditionTrue(const RE::TESConditionItem* a_conditionItem) const noexcept;
+
+	RE::NiPointer<RE::TESObjectREFR> speaker;
+	RE::Actor* speakerActor;  // nullptr if the speaker isn't an actor
+	RE::FormID speakerFormID;
+	RE::PlayerCharacter* player;
+	RE::ConditionCheckParams checkParams;  // the speaker is the subject and the player the target
+	float playerSpeechLevel;
+	std::shared_ptr<const Settings> settings;  // the same snapshot for the whole list, even if the settings are reloaded meanwhile
+
+private:
+	struct EquippedCondition final
+	{
+		void* item;  // the form or form list parameter
+		std::uint8_t object;
+		bool swapsSubjectAndTarget;  // runs on the other one of the speaker and the player
+		std::uint8_t opCode;
+		float comparisonValue;
+		bool isTrue;
+	};
+
+	mutable std::vector<EquippedCondition> equippedConditions;
+};
\ No newline at end of file
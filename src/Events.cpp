@@ -19,12 +19,14 @@ See EXCEPTIONS for additional permissions.
 
 #include "Events.h"
 
+#include "Hooks.h"
 #include "Requirements.h"
 #include "Scaleform.h"
+#include "Settings.h"
 
 namespace Events
 {
-	void MenuOpenCloseEventSink::Install(const std::unordered_map<std::string, Scaleform::TopicDisplayData>* a_topicDisplayData) noexcept
+	void MenuOpenCloseEventSink::Install(const Scaleform::TopicDisplayTable* a_topicDisplayData) noexcept
 	{
 		const auto singleton = GetSingleton();
 		singleton->topicDisplayData = a_topicDisplayData;
@@ -41,8 +43,80 @@ namespace Events
 
 	RE::BSEventNotifyControl MenuOpenCloseEventSink::ProcessEvent(const RE::MenuOpenCloseEvent* a_event, RE::BSTEventSource<RE::MenuOpenCloseEvent>*)
 	{
-		if (a_event->menuName == RE::DialogueMenu::MENU_NAME && a_event->opening && Requirements::AreRequirementsMet()) {
-			Scaleform::InstallHooks(topicDisplayData);
+		if (a_event->menuName == RE::DialogueMenu::MENU_NAME && a_event->opening) {
+			if (Requirements::AreRequirementsMet()) {
+				Scaleform::InstallHooks(topicDisplayData);
+			}
+		}
+		return RE::BSEventNotifyControl::kContinue;
+	}
+
+	void CrosshairRefEventSink::Install() noexcept
+	{
+		if (const auto crosshairRefEventSource = SKSE::GetCrosshairRefEventSource()) {
+			crosshairRefEventSource->AddEventSink(GetSingleton());
+		}
+	}
+
+	CrosshairRefEventSink* CrosshairRefEventSink::GetSingleton() noexcept
+	{
+		static CrosshairRefEventSink singleton;
+		return &singleton;
+	}
+
+	RE::BSEventNotifyControl CrosshairRefEventSink::ProcessEvent(const SKSE::CrosshairRefEvent* a_event, RE::BSTEventSource<SKSE::CrosshairRefEvent>*)
+	{
+		if (!a_event || !a_event->crosshairRef)
+			return RE::BSEventNotifyControl::kContinue;
+
+		if (!Settings::Get()->prefetchTopics)
+			return RE::BSEventNotifyControl::kContinue;
+
+		const auto actor = a_event->crosshairRef->As<RE::Actor>();
+		if (actor && !actor->IsPlayerRef() && !actor->IsDead() && Requirements::AreRequirementsMet()) {
+			Hooks::DialogueMenuEx::Prefetch(actor);
+		}
+		return RE::BSEventNotifyControl::kContinue;
+	}
+
+	void CacheInvalidationEventSink::Install() noexcept
+	{
+		const auto singleton = GetSingleton();
+		if (const auto scriptEventSourceHolder = RE::ScriptEventSourceHolder::GetSingleton()) {
+			scriptEventSourceHolder->AddEventSink<RE::TESEquipEvent>(singleton);
+			scriptEventSourceHolder->AddEventSink<RE::TESLoadGameEvent>(singleton);
+		}
+		if (const auto ui = RE::UI::GetSingleton()) {
+			ui->AddEventSink<RE::MenuOpenCloseEvent>(singleton);
+		}
+	}
+
+	CacheInvalidationEventSink* CacheInvalidationEventSink::GetSingleton() noexcept
+	{
+		static CacheInvalidationEventSink singleton;
+		return &singleton;
+	}
+
+	RE::BSEventNotifyControl CacheInvalidationEventSink::ProcessEvent(const RE::TESEquipEvent* a_event, RE::BSTEventSource<RE::TESEquipEvent>*)
+	{
+		// e.g. the Amulet of Articulation
+		if (a_event && a_event->actor && a_event->actor->IsPlayerRef()) {
+			++changeCount;
+		}
+		return RE::BSEventNotifyControl::kContinue;
+	}
+
+	RE::BSEventNotifyControl CacheInvalidationEventSink::ProcessEvent(const RE::TESLoadGameEvent*, RE::BSTEventSource<RE::TESLoadGameEvent>*)
+	{
+		++changeCount;
+		return RE::BSEventNotifyControl::kContinue;
+	}
+
+	RE::BSEventNotifyControl CacheInvalidationEventSink::ProcessEvent(const RE::MenuOpenCloseEvent* a_event, RE::BSTEventSource<RE::MenuOpenCloseEvent>*)
+	{
+		// perks are normally only added in the stats menu
+		if (a_event && a_event->menuName == RE::StatsMenu::MENU_NAME && !a_event->opening) {
+			++changeCount;
 		}
 		return RE::BSEventNotifyControl::kContinue;
 	}
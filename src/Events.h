@@ -7,7 +7,7 @@ namespace Events
 	class MenuOpenCloseEventSink final : public RE::BSTEventSink<RE::MenuOpenCloseEvent>
 	{
 	public:
-		static void Install(const std::unordered_map<std::string, Scaleform::TopicDisplayData>* a_topicDisplayData) noexcept;
+		static void Install(const Scaleform::TopicDisplayTable* a_topicDisplayData) noexcept;
 
 		static MenuOpenCloseEventSink* GetSingleton() noexcept;
 		RE::BSEventNotifyControl ProcessEvent(const RE::MenuOpenCloseEvent* a_event, RE::BSTEventSource<RE::MenuOpenCloseEvent>*) override;
@@ -20,6 +20,51 @@ namespace Events
 	private:
 		MenuOpenCloseEventSink() {};
 
-		const std::unordered_map<std::string, Scaleform::TopicDisplayData>* topicDisplayData;
+		const Scaleform::TopicDisplayTable* topicDisplayData;
+	};
+
+	// Starts prefetching the topics of NPCs the crosshair targets, so they're ready before the dialogue menu opens.
+	class CrosshairRefEventSink final : public RE::BSTEventSink<SKSE::CrosshairRefEvent>
+	{
+	public:
+		static void Install() noexcept;
+
+		static CrosshairRefEventSink* GetSingleton() noexcept;
+		RE::BSEventNotifyControl ProcessEvent(const SKSE::CrosshairRefEvent* a_event, RE::BSTEventSource<SKSE::CrosshairRefEvent>*) override;
+
+		CrosshairRefEventSink(const CrosshairRefEventSink&) = delete;
+		CrosshairRefEventSink(CrosshairRefEventSink&&) = delete;
+		void operator=(const CrosshairRefEventSink&) = delete;
+		void operator=(CrosshairRefEventSink&&) = delete;
+
+	private:
+		CrosshairRefEventSink() {};
+	};
+
+	// Counts changes to the player's perks, equipment and save game that can change speech check results without being sampled directly.
+	class CacheInvalidationEventSink final :
+		public RE::BSTEventSink<RE::TESEquipEvent>,
+		public RE::BSTEventSink<RE::TESLoadGameEvent>,
+		public RE::BSTEventSink<RE::MenuOpenCloseEvent>
+	{
+	public:
+		static void Install() noexcept;
+
+		static CacheInvalidationEventSink* GetSingleton() noexcept;
+		RE::BSEventNotifyControl ProcessEvent(const RE::TESEquipEvent* a_event, RE::BSTEventSource<RE::TESEquipEvent>*) override;
+		RE::BSEventNotifyControl ProcessEvent(const RE::TESLoadGameEvent* a_event, RE::BSTEventSource<RE::TESLoadGameEvent>*) override;
+		RE::BSEventNotifyControl ProcessEvent(const RE::MenuOpenCloseEvent* a_event, RE::BSTEventSource<RE::MenuOpenCloseEvent>*) override;
+
+		std::uint32_t GetChangeCount() const noexcept { return changeCount; }
+
+		CacheInvalidationEventSink(const CacheInvalidationEventSink&) = delete;
+		CacheInvalidationEventSink(CacheInvalidationEventSink&&) = delete;
+		void operator=(const CacheInvalidationEventSink&) = delete;
+		void operator=(CacheInvalidationEventSink&&) = delete;
+
+	private:
+		CacheInvalidationEventSink() {};
+
+		std::uint32_t changeCount = 0;
 	};
 }
\ No newline at end of file
@@ -20,9 +20,14 @@ See EXCEPTIONS for additional permissions.
 #include "Hooks.h"
 
 #include "Events.h"
+#include "HashUtil.h"
+#include "Profiler.h"
 #include "Requirements.h"
+#include "SessionRecorder.h"
 #include "Settings.h"
-#include "StringUtil.h"
+#include "SpeechFormulas.h"
+#include "TopicIndex.h"
+#include "TopicProcessor.h"
 
 namespace Hooks
 {
@@ -35,9 +40,8 @@ namespace Hooks
 	{
 		REL::Relocation<uintptr_t> vtbl(RE::VTABLE_DialogueMenu[0]);
 		_ProcessMessageFn = vtbl.write_vfunc(0x4, &ProcessMessageEx);
-		if (Settings::applyTopicColors || Settings::showSubtitles != Settings::SHOW_SUBTITLES::kNever) {
-			Events::MenuOpenCloseEventSink::Install(&topicDisplayData);
-		}
+		// installed regardless of the settings, which may enable colours or subtitles after a reload
+		Events::MenuOpenCloseEventSink::Install(&topicDisplayData);
 	}
 
 	RE::UI_MESSAGE_RESULTS DialogueMenuEx::ProcessMessageEx(RE::UIMessage& a_message) noexcept
@@ -46,259 +50,518 @@ namespace Hooks
 			return _ProcessMessageFn(this, a_message);
 		}
 
-		static std::unordered_map<const cache_key_t, std::string, cache_key_hash> cache;
 		switch (*a_message.type) {
 		case RE::UI_MESSAGE_TYPE::kShow:
 		case RE::UI_MESSAGE_TYPE::kUpdate:
 			if (const auto dialogueList = RE::MenuTopicManager::GetSingleton()->dialogueList) {
+				PROFILE_STAGE(kProcessMessage);
+				const DialogueContext context(RE::MenuTopicManager::GetSingleton()->speaker.get(), Settings::Get());
+				const auto speakerFormID = context.speakerFormID;
+				if (*a_message.type == RE::UI_MESSAGE_TYPE::kShow) {
+					beginDialogueEpoch(speakerFormID);
+				}
+				updateCacheEpoch(context);
+				// the entries of the previous list are still valid if no cached topics were invalidated since
+				const auto canSkipUnchanged = *a_message.type == RE::UI_MESSAGE_TYPE::kUpdate && snapshotSpeakerFormID == speakerFormID && snapshotCacheGeneration == cacheGeneration;
+				const CommonLibEngine engine(context);
+				const auto previousMisses = sessionCacheStats.misses;
+				const auto previousPrefetchHits = sessionCacheStats.prefetchHits;
+				std::uint32_t numProcessed = 0;
+				std::uint32_t numSkipped = 0;
+				auto isReordered = false;
+				nextSnapshot.Clear();
 				for (auto it = dialogueList->begin(); it != dialogueList->end(); ++it) {
 					const auto dialogue = *it;
 					if (!dialogue)
 						continue;
-					const auto parentTopic = dialogue->parentTopic;
-					// topics can be reused with a different text (e.g. when selling multiple carcasses with Simple Hunting Overhaul)
-					const auto cacheKey = std::make_tuple(parentTopic->formID, parentTopic->GetFullName());
-					auto where = cache.find(cacheKey);
-					if (where != cache.end()) {
-						dialogue->topicText = where->second;
-						continue;
+					const auto topicFormID = dialogue->parentTopic->formID;
+					const auto textHash = HashUtil::Hash({ dialogue->topicText.c_str(), dialogue->topicText.size() });
+					if (canSkipUnchanged) {
+						if (const auto previous = snapshot.FindUnchanged(nextSnapshot.Size(), dialogue, topicFormID, textHash)) {
+							++numSkipped;
+							isReordered = isReordered || previous != snapshot.GetEntries().data() + nextSnapshot.Size();
+							nextSnapshot.Add(*previous);
+							continue;
+						}
 					}
-					processTopic(dialogue);
-					cache[cacheKey] = dialogue->topicText;
+
+					++numProcessed;
+					const auto fingerprint = processDialogue(dialogue, context, engine);
+					nextSnapshot.Add({ dialogue, topicFormID, HashUtil::Hash({ dialogue->topicText.c_str(), dialogue->topicText.size() }), fingerprint });
+				}
+
+				// the table doesn't depend on the order of the entries, but rebuilding it tells the subtitles that the positions in EntriesA changed
+				if (!canSkipUnchanged || numProcessed > 0 || isReordered || nextSnapshot.Size() != snapshot.Size()) {
+					buildTopicDisplayData(nextSnapshot);
 				}
+				if (SessionRecorder::IsRecording()) {
+					recordDialogueList(*a_message.type, nextSnapshot, context, engine);
+				}
+				snapshot.Swap(nextSnapshot);
+				snapshotSpeakerFormID = speakerFormID;
+				snapshotCacheGeneration = cacheGeneration;
+
+				sessionCacheStats.processedEntries += numProcessed;
+				sessionCacheStats.skippedEntries += numSkipped;
+				if (*a_message.type == RE::UI_MESSAGE_TYPE::kShow) {
+					++sessionCacheStats.shows;
+					if (sessionCacheStats.misses == previousMisses) {
+						++sessionCacheStats.showsServedFromCache;
+						if (sessionCacheStats.prefetchHits > previousPrefetchHits) {
+							++sessionCacheStats.showsServedWithPrefetch;
+						}
+					}
+				}
+				logger::debug("Dialogue list {}: {} entries processed, {} skipped", *a_message.type == RE::UI_MESSAGE_TYPE::kShow ? "shown" : "updated", numProcessed, numSkipped);
 			}
 			break;
 		case RE::UI_MESSAGE_TYPE::kHide:
-			cache.clear();
-			if (Settings::applyTopicColors || Settings::showSubtitles != Settings::SHOW_SUBTITLES::kNever) {
-				topicDisplayData.clear();
-			}
+			rememberSpeakerTopics();
+			logCacheStats();
+			trimCaches();
+			logNativeCalls();
+			logProfile();
+			logSpeechCheckComparisons();
+			SessionRecorder::EndSession();
+			Scaleform::ReleaseMovieValues();
+			snapshot.Clear();
+			topicDisplayData.Release();
+			sessionArena.Reset();
 			break;
 		}
 
 		return _ProcessMessageFn(this, a_message);
 	}
 
-	void DialogueMenuEx::processTopic(RE::MenuTopicManager::Dialogue* a_dialogue) noexcept
+	std::uint64_t DialogueMenuEx::processDialogue(
+		RE::MenuTopicManager::Dialogue* a_dialogue,
+		const DialogueContext& a_context,
+		const CommonLibEngine& a_engine) noexcept
 	{
-		const auto speechCheckData = getSpeechCheckData(a_dialogue);
-		SPEECH_CHECK_TYPE impliedCheckType;
-		Scaleform::TopicDisplayData displayData;
-		std::string resultText;
-
-		if (speechCheckData.checkType != SPEECH_CHECK_TYPE::kNone) {
-			impliedCheckType = speechCheckData.checkType;
-			if (speechCheckData.passesCheck) {
-				resultText = Settings::checkSuccessText;
-				displayData.newColor = Settings::successColor;
-				displayData.oldColor = Settings::successColor;
-			} else {
-				resultText = Settings::checkFailureText;
-				displayData.newColor = Settings::failureColorNew;
-				displayData.oldColor = Settings::failureColorOld;
+		const auto parentTopic = a_dialogue->parentTopic;
+		const auto speakerFormID = a_context.speakerFormID;
+		// topics can be reused with a different text (e.g. when selling multiple carcasses with Simple Hunting Overhaul)
+		const std::string_view topicName(parentTopic->GetFullName());
+		const auto fingerprint = HashUtil::Fingerprint(parentTopic->formID, speakerFormID, HashUtil::Hash(topicName));
+		const auto cachedTopic = cache.Find(fingerprint);
+		const auto isSameTopic = cachedTopic && cachedTopic->topicFormID == parentTopic->formID && cachedTopic->speakerFormID == speakerFormID && cachedTopic->topicName == topicName;
+		if (isSameTopic && isCurrent(*cachedTopic)) {
+			++sessionCacheStats.hits;
+			if (cachedTopic->prefetched) {
+				cachedTopic->prefetched = false;
+				++sessionCacheStats.prefetchHits;
 			}
-		} else if (speechCheckData.tagType != SPEECH_CHECK_TYPE::kNone) {
-			impliedCheckType = speechCheckData.tagType;
-			resultText = Settings::noCheckText;
-			displayData.newColor = Settings::noCheckColorNew;
-			displayData.oldColor = Settings::noCheckColorOld;
-		} else {
-			if (Settings::applyTopicColors) {
-				displayData.newColor = Settings::regularColorNew;
-				displayData.oldColor = Settings::regularColorOld;
-				topicDisplayData[a_dialogue->topicText.c_str()] = displayData;
+			applyCachedTopic(a_dialogue, *cachedTopic);
+			return fingerprint;
+		}
+
+		++sessionCacheStats.misses;
+		std::string_view topicText(a_dialogue->topicText.c_str(), a_dialogue->topicText.size());
+		auto rawTopicTextEpoch = cacheEpoch;
+		if (isSameTopic && topicText == cachedTopic->topicText) {
+			// the dialogue still shows the text the topic was formatted to, so the game's text is only known from the cache
+			if (!canReuseRawTopicText(*cachedTopic)) {
+				applyCachedTopic(a_dialogue, passThroughTopic(fingerprint, *cachedTopic));
+				return fingerprint;
 			}
+			topicText = cachedTopic->rawTopicText;
+			rawTopicTextEpoch = cachedTopic->rawTopicTextEpoch;
+		}
+		applyCachedTopic(a_dialogue, processTopic(fingerprint, parentTopic, topicText, rawTopicTextEpoch, cachedTopic, a_context, a_engine));
+		return fingerprint;
+	}
 
-			return;  // regular topics don't need topic formatting or subtitles
+	DialogueMenuEx::CachedTopic& DialogueMenuEx::processTopic(
+		const std::uint64_t a_fingerprint,
+		const RE::TESTopic* a_topic,
+		const std::string_view a_topicText,
+		const std::uint32_t a_rawTopicTextEpoch,
+		const CachedTopic* a_oldTopic,
+		const DialogueContext& a_context,
+		const CommonLibEngine& a_engine) noexcept
+	{
+		const auto descriptor = TopicIndex::Get().Find(a_topic->formID);
+		auto processedTopic = TopicProcessor::ProcessTopic(a_engine.GetEngine(), CommonLibEngine::ToHandle(a_topic), descriptor, a_topicText, *a_context.settings);
+		if (processedTopic.requiredSpeechLevelGlobal) {
+			trackCacheEpochGlobal(CommonLibEngine::ToGlobal(processedTopic.requiredSpeechLevelGlobal));
 		}
+		CachedTopic newCachedTopic{
+			a_topic->formID,
+			a_context.speakerFormID,
+			std::string(a_topic->GetFullName()),
+			std::string(a_topicText),
+			a_rawTopicTextEpoch,
+			std::move(processedTopic.topicText),
+			std::move(processedTopic.displayData),
+			processedTopic.speechDependency,
+			processedTopic.requiredSpeechLevel,
+			cacheEpoch,
+			a_context.settings->generation,
+			processedTopic.dependsOnConditions,
+			false
+		};
+		// a_topicText may point into a_oldTopic, which is replaced here
+		updateSpeechThresholds(a_fingerprint, a_oldTopic, newCachedTopic);
+		return cache.InsertOrAssign(a_fingerprint, std::move(newCachedTopic));
+	}
 
-		const auto playerSpeechLevel = RE::PlayerCharacter::GetSingleton()->AsActorValueOwner()->GetActorValue(RE::ActorValue::kSpeech);
+	DialogueMenuEx::CachedTopic& DialogueMenuEx::passThroughTopic(const std::uint64_t a_fingerprint, CachedTopic& a_cachedTopic) noexcept
+	{
+		auto newCachedTopic = a_cachedTopic;
+		newCachedTopic.topicText = a_cachedTopic.rawTopicText;
+		newCachedTopic.displayData.reset();
+		newCachedTopic.speechDependency = TopicProcessor::SPEECH_DEPENDENCY::kNone;
+		newCachedTopic.requiredSpeechLevel = 0.0F;
+		newCachedTopic.epoch = cacheEpoch;
+		newCachedTopic.prefetched = false;
+		updateSpeechThresholds(a_fingerprint, &a_cachedTopic, newCachedTopic);
+		a_cachedTopic = std::move(newCachedTopic);
+		return a_cachedTopic;
+	}
 
-		if (Settings::applyTopicFormatting) {
-			std::string topicFormat;
-			switch (impliedCheckType) {
-			case SPEECH_CHECK_TYPE::kPersuade:
-				topicFormat = Settings::persuadeTopicFormat;
-				break;
-			case SPEECH_CHECK_TYPE::kIntimidate:
-				topicFormat = Settings::intimidateTopicFormat;
-				break;
-			case SPEECH_CHECK_TYPE::kBribe:
-				topicFormat = Settings::bribeTopicFormat;
-				break;
-			}
+	void DialogueMenuEx::Prefetch(RE::TESObjectREFR* a_speaker) noexcept
+	{
+		// a new epoch would make the topics of an open dialogue stale
+		if (const auto ui = RE::UI::GetSingleton(); ui && ui->IsMenuOpen(RE::DialogueMenu::MENU_NAME)) {
+			return;
+		}
 
-			a_dialogue->topicText = applyFormat(topicFormat, &speechCheckData, resultText, playerSpeechLevel);
+		const auto speakerFormID = a_speaker->GetFormID();
+		const auto hasCurrentEpoch = prefetchState.hasEpoch && std::chrono::steady_clock::now() - prefetchState.epochStart < kPrefetchedEpochLifetime;
+		if (prefetchState.speakerFormID == speakerFormID && (prefetchState.isScheduled || hasCurrentEpoch)) {
+			return;
 		}
 
-		if (Settings::showSubtitles == Settings::SHOW_SUBTITLES::kForAllSpeechChecks || (Settings::showSubtitles == Settings::SHOW_SUBTITLES::kOnlyForNoCheck && speechCheckData.checkType == SPEECH_CHECK_TYPE::kNone)) {
-			std::string subtitleFormat;
-			switch (impliedCheckType) {
-			case SPEECH_CHECK_TYPE::kPersuade:
-				subtitleFormat = Settings::persuadeSubtitleFormat;
-				break;
-			case SPEECH_CHECK_TYPE::kIntimidate:
-				subtitleFormat = Settings::intimidateSubtitleFormat;
-				break;
-			case SPEECH_CHECK_TYPE::kBribe:
-				subtitleFormat = Settings::bribeSubtitleFormat;
+		const auto topics = speakerTopics.Find(speakerFormID);
+		if (!topics) {
+			return;  // nothing is known about the topics of a speaker before the first dialogue with them
+		}
+
+		prefetchState.speaker = a_speaker->GetHandle();
+		prefetchState.speakerFormID = speakerFormID;
+		prefetchState.fingerprints = *topics;
+		prefetchState.nextIndex = 0;
+		// The topics are prefetched in the epoch of the dialogue that's about to open. Aiming at a speaker doesn't change anything the
+		// cached topics depend on, so the current epoch is kept unless an input of the cache changed since it began.
+		updateCacheEpoch(DialogueContext(RE::NiPointer<RE::TESObjectREFR>(a_speaker), Settings::Get()));
+		prefetchState.hasEpoch = true;
+		prefetchState.epochStart = std::chrono::steady_clock::now();
+		if (!prefetchState.isScheduled) {
+			prefetchState.isScheduled = true;
+			SKSE::GetTaskInterface()->AddTask([] { prefetchStep(); });
+		}
+	}
+
+	void DialogueMenuEx::prefetchStep() noexcept
+	{
+		prefetchState.isScheduled = false;
+		const auto ui = RE::UI::GetSingleton();
+		const auto speaker = prefetchState.speaker.get();
+		if (!speaker || (ui && ui->IsMenuOpen(RE::DialogueMenu::MENU_NAME))) {
+			prefetchState.fingerprints.clear();  // the dialogue menu processes its topics itself
+			return;
+		}
+
+		PROFILE_STAGE(kPrefetch);
+		const DialogueContext context(speaker, Settings::Get());
+		updateCacheEpoch(context);
+		const CommonLibEngine engine(context);
+		const auto start = std::chrono::steady_clock::now();
+		const auto budget = std::chrono::microseconds(context.settings->prefetchBudgetMicroseconds);
+		while (prefetchState.nextIndex < prefetchState.fingerprints.size()) {
+			const auto fingerprint = prefetchState.fingerprints[prefetchState.nextIndex++];
+			// the dialogue will show the text the game gives the topic then, which the stored text may not match
+			const auto cachedTopic = cache.Find(fingerprint);
+			if (!cachedTopic || isCurrent(*cachedTopic) || !canReuseRawTopicText(*cachedTopic)) {
+				continue;
+			}
+
+			// the topic may have been renamed since, then the dialogue menu will process it under another fingerprint
+			const auto topic = RE::TESForm::LookupByID<RE::TESTopic>(cachedTopic->topicFormID);
+			if (!topic || cachedTopic->topicName != topic->GetFullName()) {
+				continue;
+			}
+
+			processTopic(fingerprint, topic, cachedTopic->rawTopicText, cachedTopic->rawTopicTextEpoch, cachedTopic, context, engine).prefetched = true;
+			++sessionCacheStats.prefetchedTopics;
+			if (std::chrono::steady_clock::now() - start >= budget) {
 				break;
 			}
+		}
 
-			displayData.subtitle = applyFormat(subtitleFormat, &speechCheckData, resultText, playerSpeechLevel);
-			topicDisplayData[a_dialogue->topicText.c_str()] = displayData;
-		} else if (Settings::applyTopicColors) {
-			topicDisplayData[a_dialogue->topicText.c_str()] = displayData;
+		if (prefetchState.nextIndex < prefetchState.fingerprints.size()) {
+			prefetchState.isScheduled = true;
+			SKSE::GetTaskInterface()->AddTask([] { prefetchStep(); });
 		}
 	}
 
-	DialogueMenuEx::SpeechCheckData DialogueMenuEx::getSpeechCheckData(const RE::MenuTopicManager::Dialogue* a_dialogue) noexcept
+	void DialogueMenuEx::rememberSpeakerTopics() noexcept
 	{
-		SpeechCheckData result{ {}, {}, SPEECH_CHECK_TYPE::kNone, SPEECH_CHECK_TYPE::kNone, false, 0.0F, "" };
-		const auto topic = a_dialogue->parentTopic;
-		if (!topic)
-			return result;
+		if (!Settings::Get()->prefetchTopics || snapshot.Size() == 0) {
+			return;
+		}
 
-		hydrateTextData(result, a_dialogue);
-		hydrateCheckData(result, topic);
-		if (result.tagType == SPEECH_CHECK_TYPE::kNone) {
-			applyTagPlaceholder(result);
+		auto& fingerprints = speakerTopics[snapshotSpeakerFormID];
+		fingerprints.clear();
+		for (const auto& entry : snapshot.GetEntries()) {
+			fingerprints.push_back(entry.fingerprint);
 		}
-		return result;
 	}
 
-	void DialogueMenuEx::applyTagPlaceholder(Hooks::DialogueMenuEx::SpeechCheckData& result)
+	void DialogueMenuEx::buildTopicDisplayData(const DialogueListSnapshot& a_snapshot) noexcept
 	{
-		switch (result.checkType) {
-		case SPEECH_CHECK_TYPE::kPersuade:
-			result.tagText = Settings::persuadeTagPlaceholder;
-			break;
-		case SPEECH_CHECK_TYPE::kIntimidate:
-			result.tagText = Settings::intimidateTagPlaceholder;
-			break;
-		case SPEECH_CHECK_TYPE::kBribe:
-			result.tagText = Settings::bribeTagPlaceholder;
-			break;
+		topicDisplayData.Clear();
+		for (const auto& entry : a_snapshot.GetEntries()) {
+			if (const auto cachedTopic = cache.Find(entry.fingerprint); cachedTopic && cachedTopic->displayData) {
+				topicDisplayData.Insert(cachedTopic->topicText, *cachedTopic->displayData, cachedTopic->rawTopicText);
+			}
 		}
+		topicDisplayData.Build();
 	}
 
-	std::string DialogueMenuEx::applyFormat(
-		const std::string& a_format,
-		const DialogueMenuEx::SpeechCheckData* a_speechCheckData,
-		const std::string& a_resultText,
-		const float a_playerSpeechLevel) noexcept
+	void DialogueMenuEx::recordDialogueList(
+		const RE::UI_MESSAGE_TYPE a_messageType,
+		const DialogueListSnapshot& a_snapshot,
+		const DialogueContext& a_context,
+		const CommonLibEngine& a_engine) noexcept
 	{
-		return std::vformat(
-			a_format,
-			std::make_format_args(
-				a_speechCheckData->mainText,
-				a_speechCheckData->tagText,
-				a_resultText,
-				a_speechCheckData->requiredSpeechLevel,
-				a_speechCheckData->predictedResponseText,
-				a_playerSpeechLevel));
+		// the trace records the topics of every entry, including the ones served from the cache, so the replay processes all of them
+		SessionTrace::DialogueList list{
+			a_messageType == RE::UI_MESSAGE_TYPE::kShow ? SessionTrace::MESSAGE::kShow : SessionTrace::MESSAGE::kUpdate,
+			a_context.speakerFormID,
+			a_context.playerSpeechLevel,
+			{},
+			{}
+		};
+		for (const auto& entry : a_snapshot.GetEntries()) {
+			const auto dialogue = static_cast<const RE::MenuTopicManager::Dialogue*>(entry.dialogue);
+			const auto cachedTopic = cache.Find(entry.fingerprint);
+			if (!cachedTopic) {
+				continue;
+			}
+
+			const auto topicIndex = SessionRecorder::RecordTopic(a_engine.GetEngine(), CommonLibEngine::ToHandle(dialogue->parentTopic), entry.topicFormID, a_context.settings->showsPredictedResponse);
+			list.entries.emplace_back(topicIndex, cachedTopic->rawTopicText, std::string(dialogue->topicText.c_str(), dialogue->topicText.size()));
+		}
+		SessionRecorder::RecordDialogueList(list);
 	}
 
-	void DialogueMenuEx::hydrateTextData(DialogueMenuEx::SpeechCheckData& a_speechCheckData, const RE::MenuTopicManager::Dialogue* a_dialogue) noexcept
+	void DialogueMenuEx::updateCacheEpoch(const DialogueContext& a_context) noexcept
 	{
-		const std::string topicText(a_dialogue->topicText.c_str(), a_dialogue->topicText.size());
-		std::smatch tagMatch;
-		try {
-			if (std::regex_search(topicText, tagMatch, Settings::persuadeTagRegex)) {
-				a_speechCheckData.tagType = SPEECH_CHECK_TYPE::kPersuade;
-			} else if (std::regex_search(topicText, tagMatch, Settings::intimidateTagRegex)) {
-				a_speechCheckData.tagType = SPEECH_CHECK_TYPE::kIntimidate;
-			} else if (std::regex_search(topicText, tagMatch, Settings::bribeTagRegex) && StringUtil::LowerCaseContains(a_dialogue->parentTopic->fullName, "<bribecost>")) {
-				a_speechCheckData.tagType = SPEECH_CHECK_TYPE::kBribe;
+		const auto player = a_context.player;
+		invalidateForSpeechLevel(a_context.playerSpeechLevel);
+
+		const CacheEpochInputs inputs{
+			player->GetGoldAmount(),
+			player->GetLevel(),
+			Events::CacheInvalidationEventSink::GetSingleton()->GetChangeCount(),
+			a_context.settings->generation
+		};
+
+		auto changed = inputs != cacheEpochInputs;
+		for (auto& [global, value] : cacheEpochGlobals) {
+			if (global->value != value) {
+				value = global->value;
+				changed = true;
 			}
-		} catch (const std::regex_error& e) {
-			logger::error("Failed to match regex: {}", e.what());
 		}
 
-		a_speechCheckData.mainText = topicText.substr(0, topicText.size() - tagMatch.length());
-		a_speechCheckData.tagText = tagMatch.str(1);
+		if (changed) {
+			cacheEpochInputs = inputs;
+			beginEpoch();
+		}
 	}
 
-	void DialogueMenuEx::hydrateCheckData(DialogueMenuEx::SpeechCheckData& a_speechCheckData, const RE::TESTopic* a_topic) noexcept
+	void DialogueMenuEx::beginEpoch() noexcept
 	{
-		const auto speaker = RE::MenuTopicManager::GetSingleton()->speaker.get().get();
-		const auto player = RE::PlayerCharacter::GetSingleton();
-		// based on: https://github.com/Scrabx3/Dynamic-Dialogue-Replacer/blob/3ffe893f741a9e1530c9bcb5577465b6e9ccad0b/src/Hooks/Hooks.cpp#L96-L105
-		auto infoPtr = a_topic->topicInfos;
-		for (auto i = a_topic->numTopicInfos; i > 0; --i) {
-			if (!infoPtr)
-				return;
-			if (const auto responseInfo = *infoPtr) {
-				auto conditionItem = responseInfo->objConditions.head;
-				if (!conditionItem || (a_speechCheckData.checkType != SPEECH_CHECK_TYPE::kNone && i == 1)) {
-					// This response either has no conditions, or the speech check was found in a previous iteration, didn't pass, and the current response is the last option left.
-					// In the latter case, the conditions would actually still need to be evaluated to confirm this response would be chosen, but sometimes this returns false negatives.
-					// Therefore, the current response is the most likely one to be chosen based on the available information.
-					a_speechCheckData.predictedResponseText = getResponseText(responseInfo, speaker);
-					return;
-				}
+		++cacheEpoch;
+		++cacheGeneration;
+		CommonLibEngine::ClearResponseTexts();
+	}
 
-				while (conditionItem && a_speechCheckData.checkType == SPEECH_CHECK_TYPE::kNone) {
-					const auto data = conditionItem->data;
-					const auto function = data.functionData.function;
-					// evaluating the full responseInfo->objConditions sometimes returns false negatives, so only the speech checks are evaluated here.
-					if (function == RE::FUNCTION_DATA::FunctionID::kGetActorValue) {
-						const auto actorValue = static_cast<RE::ActorValue>(reinterpret_cast<intptr_t>(data.functionData.params[0]));
-						if (actorValue == RE::ActorValue::kSpeech && data.flags.opCode == RE::CONDITION_ITEM_DATA::OpCode::kGreaterThanOrEqualTo) {
-							a_speechCheckData.checkType = SPEECH_CHECK_TYPE::kPersuade;
-							a_speechCheckData.requiredSpeechLevel = data.flags.global ? data.comparisonValue.g->value : data.comparisonValue.f;
-							a_speechCheckData.passesCheck = evaluateSpeechCheck(conditionItem, true);
-						}
-					} else if (function == RE::FUNCTION_DATA::FunctionID::kGetBribeSuccess) {
-						a_speechCheckData.checkType = SPEECH_CHECK_TYPE::kBribe;
-						a_speechCheckData.passesCheck = evaluateSpeechCheck(conditionItem, false);
-					} else if (function == RE::FUNCTION_DATA::FunctionID::kGetIntimidateSuccess) {
-						a_speechCheckData.checkType = SPEECH_CHECK_TYPE::kIntimidate;
-						a_speechCheckData.passesCheck = evaluateSpeechCheck(conditionItem, false);
-					}
+	void DialogueMenuEx::beginDialogueEpoch(const RE::FormID a_speakerFormID) noexcept
+	{
+		const auto isPrefetchedEpoch = prefetchState.hasEpoch && prefetchState.speakerFormID == a_speakerFormID && std::chrono::steady_clock::now() - prefetchState.epochStart < kPrefetchedEpochLifetime;
+		prefetchState.hasEpoch = false;
+		if (!isPrefetchedEpoch) {
+			beginEpoch();
+		}
+	}
 
-					conditionItem = conditionItem->next;
-				}
+	bool DialogueMenuEx::isCurrent(const CachedTopic& a_cachedTopic) noexcept
+	{
+		// a regular topic from another dialogue is only current if the game didn't substitute anything into its text
+		return a_cachedTopic.epoch == cacheEpoch || (!a_cachedTopic.dependsOnConditions && a_cachedTopic.settingsGeneration == cacheEpochInputs.settingsGeneration && a_cachedTopic.rawTopicText == a_cachedTopic.topicName);
+	}
 
-				if (a_speechCheckData.passesCheck || ((a_speechCheckData.checkType != SPEECH_CHECK_TYPE::kNone || a_speechCheckData.tagType != SPEECH_CHECK_TYPE::kNone) && (i == 1 || responseInfo->objConditions.IsTrue(speaker, player)))) {
-					a_speechCheckData.predictedResponseText = getResponseText(responseInfo, speaker);
-					return;
-				}
+	bool DialogueMenuEx::canReuseRawTopicText(const CachedTopic& a_cachedTopic) noexcept
+	{
+		// the topic name is read again for every lookup, only the text the game substituted into may be outdated
+		return a_cachedTopic.rawTopicText == a_cachedTopic.topicName || a_cachedTopic.rawTopicTextEpoch == cacheEpoch;
+	}
+
+	void DialogueMenuEx::trimCaches() noexcept
+	{
+		if (cache.Size() > kMaxCachedTopics) {
+			logger::info("Topic cache: cleared {} entries", cache.Size());
+			cache.Clear();
+			speechThresholds.Clear();
+			++cacheGeneration;
+		}
+		if (speakerTopics.Size() > kMaxRememberedSpeakers) {
+			speakerTopics.Clear();
+		}
+	}
+
+	void DialogueMenuEx::trackCacheEpochGlobal(const RE::TESGlobal* a_global) noexcept
+	{
+		// e.g. SpeechAverage, which may be changed by mods that rebalance speech checks
+		if (std::ranges::find(cacheEpochGlobals, a_global, &std::pair<const RE::TESGlobal*, float>::first) == cacheEpochGlobals.end()) {
+			cacheEpochGlobals.emplace_back(a_global, a_global->value);
+		}
+	}
+
+	void DialogueMenuEx::invalidateForSpeechLevel(const float a_playerSpeechLevel) noexcept
+	{
+		if (a_playerSpeechLevel == cacheSpeechLevel) {
+			return;
+		}
+
+		// e.g. after drinking a potion, only the persuasion checks whose required speech level was crossed change their outcome
+		speechThresholds.ForEachAffected(cacheSpeechLevel, a_playerSpeechLevel, [](const std::uint64_t a_fingerprint) {
+			if (const auto cachedTopic = cache.Find(a_fingerprint); cachedTopic && cachedTopic->epoch == cacheEpoch) {
+				cachedTopic->epoch = cacheEpoch - 1;  // any epoch other than the current one
+				++sessionCacheStats.speechLevelInvalidations;
+				++cacheGeneration;
+			}
+		});
+		cacheSpeechLevel = a_playerSpeechLevel;
+	}
+
+	void DialogueMenuEx::updateSpeechThresholds(const std::uint64_t a_fingerprint, const CachedTopic* a_oldTopic, const CachedTopic& a_newTopic) noexcept
+	{
+		using SPEECH_DEPENDENCY = TopicProcessor::SPEECH_DEPENDENCY;
+		if (a_oldTopic) {
+			if (a_oldTopic->speechDependency == SPEECH_DEPENDENCY::kThreshold) {
+				speechThresholds.EraseThreshold(a_fingerprint, a_oldTopic->requiredSpeechLevel);
+			} else if (a_oldTopic->speechDependency == SPEECH_DEPENDENCY::kAlways) {
+				speechThresholds.EraseDependent(a_fingerprint);
 			}
-			++infoPtr;
+		}
+
+		if (a_newTopic.speechDependency == SPEECH_DEPENDENCY::kThreshold) {
+			speechThresholds.InsertThreshold(a_fingerprint, a_newTopic.requiredSpeechLevel);
+		} else if (a_newTopic.speechDependency == SPEECH_DEPENDENCY::kAlways) {
+			speechThresholds.InsertDependent(a_fingerprint);
+		}
+	}
+
+	void DialogueMenuEx::applyCachedTopic(RE::MenuTopicManager::Dialogue* a_dialogue, const CachedTopic& a_cachedTopic) noexcept
+	{
+		// kUpdate applies the same text again to most topics, which doesn't need to be copied into the BSString
+		if (std::string_view(a_dialogue->topicText.c_str(), a_dialogue->topicText.size()) != a_cachedTopic.topicText) {
+			a_dialogue->topicText = a_cachedTopic.topicText;
 		}
 	}
 
-	bool DialogueMenuEx::evaluateSpeechCheck(const RE::TESConditionItem* a_conditionItem, bool a_checkForAmuletOfArticulation) noexcept
+	void DialogueMenuEx::logCacheStats() noexcept
 	{
-		const auto speaker = RE::MenuTopicManager::GetSingleton()->speaker.get().get();
-		const auto player = RE::PlayerCharacter::GetSingleton();
-		auto checkParams = RE::ConditionCheckParams(speaker, player);
-		const auto result = a_conditionItem->IsTrue(checkParams);
-		if (result)
-			return true;
-		// persuasion checks are usually followed by checking if the Amulet of Articulation is equipped
-		if (!a_checkForAmuletOfArticulation || !a_conditionItem->data.flags.isOR || !a_conditionItem->next || a_conditionItem->next->data.functionData.function != RE::FUNCTION_DATA::FunctionID::kGetEquipped)
-			return false;
-		// the following forms should be the same here:
-		//const auto formToCheck = std::bit_cast<RE::TESForm*>(a_conditionItem->next->data.functionData.params[0]);
-		//const auto amuletOfArticulationFormList = RE::TESForm::LookupByEditorID("TGAmuletOfArticulationList");
-		return a_conditionItem->next->IsTrue(checkParams);
+		totalCacheStats.hits += sessionCacheStats.hits;
+		totalCacheStats.misses += sessionCacheStats.misses;
+		totalCacheStats.speechLevelInvalidations += sessionCacheStats.speechLevelInvalidations;
+		totalCacheStats.processedEntries += sessionCacheStats.processedEntries;
+		totalCacheStats.skippedEntries += sessionCacheStats.skippedEntries;
+		totalCacheStats.shows += sessionCacheStats.shows;
+		totalCacheStats.showsServedFromCache += sessionCacheStats.showsServedFromCache;
+		totalCacheStats.showsServedWithPrefetch += sessionCacheStats.showsServedWithPrefetch;
+		totalCacheStats.prefetchedTopics += sessionCacheStats.prefetchedTopics;
+		totalCacheStats.prefetchHits += sessionCacheStats.prefetchHits;
+		logger::info(
+			"Topic cache: {} hits and {} misses in this dialogue, {} hits and {} misses in total (epoch {}, {} entries)",
+			sessionCacheStats.hits,
+			sessionCacheStats.misses,
+			totalCacheStats.hits,
+			totalCacheStats.misses,
+			cacheEpoch,
+			cache.Size());
+		logger::info(
+			"Speech level changes invalidated {} topics in this dialogue and {} in total ({} persuasion thresholds, {} other dependent topics)",
+			sessionCacheStats.speechLevelInvalidations,
+			totalCacheStats.speechLevelInvalidations,
+			speechThresholds.NumThresholds(),
+			speechThresholds.NumDependents());
+		logger::info(
+			"Dialogue list: {} entries processed and {} unchanged entries skipped in this dialogue, {} processed and {} skipped in total",
+			sessionCacheStats.processedEntries,
+			sessionCacheStats.skippedEntries,
+			totalCacheStats.processedEntries,
+			totalCacheStats.skippedEntries);
+		if (Settings::Get()->prefetchTopics) {
+			logger::info(
+				"Prefetch: {} topics prefetched before this dialogue and {} of them shown, {} of {} dialogue menus opened without processing topics ({} of them with prefetched topics)",
+				sessionCacheStats.prefetchedTopics,
+				sessionCacheStats.prefetchHits,
+				totalCacheStats.showsServedFromCache,
+				totalCacheStats.shows,
+				totalCacheStats.showsServedWithPrefetch);
+		}
+		sessionCacheStats = {};
+	}
+
+	void DialogueMenuEx::logNativeCalls() noexcept
+	{
+		const auto& counts = Scaleform::GetNativeCallCounts();
+		logger::debug(
+			"Scaleform: {} calls between the movie and the plugin in this dialogue ({} SetEntryText, {} UpdateList, {} selection, {} ShowDialogueText, {} into the topic list)",
+			counts.Total(),
+			counts.setEntryText,
+			counts.updateList,
+			counts.selection,
+			counts.showDialogueText,
+			counts.topicListView);
+		Scaleform::ResetNativeCallCounts();
 	}
 
-	std::string DialogueMenuEx::getResponseText(RE::TESTopicInfo* a_responseInfo, RE::TESObjectREFR* a_speaker) noexcept
+	void DialogueMenuEx::logProfile() noexcept
 	{
-		RE::NiPointer<RE::Actor> actor;
-		RE::RefHandle handle;
-		RE::CreateRefHandle(handle, a_speaker);
-		if (RE::LookupReferenceByHandle(handle, actor)) {
-			auto dialogueData = a_responseInfo->GetDialogueData(actor.get());
-			if (!dialogueData.responses.empty()) {
-				const auto response = dialogueData.responses.front();
-				return response->text.c_str();
+		if (!Profiler::IsRecording()) {
+			return;
+		}
+
+		for (std::size_t stage = 0; stage < static_cast<std::size_t>(Profiler::STAGE::kTotal); ++stage) {
+			const auto percentiles = Profiler::GetSessionPercentiles(static_cast<Profiler::STAGE>(stage));
+			if (percentiles.count > 0) {
+				logger::info(
+					"Profile {}: {} calls, p50 {} us, p99 {} us, max {} us",
+					Profiler::GetStageName(static_cast<Profiler::STAGE>(stage)),
+					percentiles.count,
+					percentiles.p50Nanoseconds / 1000.0,
+					percentiles.p99Nanoseconds / 1000.0,
+					percentiles.maxNanoseconds / 1000.0);
 			}
 		}
+		if (const auto numDroppedEvents = Profiler::GetNumDroppedEvents()) {
+			logger::warn("Profile: {} trace events dropped in total, the trace writer couldn't keep up", numDroppedEvents);
+		}
+		Profiler::ResetSession();
+	}
+
+	void DialogueMenuEx::logSpeechCheckComparisons() noexcept
+	{
+		const auto stats = SpeechFormulas::TakeDifferentialStats();
+		if (stats.comparisons == 0) {
+			return;
+		}
 
-		return "";
+		logger::info("Speech formulas: {} of {} intimidation and bribe checks in this dialogue differed from the game", stats.mismatches, stats.comparisons);
+		if (const auto& mismatch = stats.firstMismatch) {
+			logger::warn(
+				"Speech formulas: {} check predicted {} but the game returned {} (required {}, player has {})",
+				mismatch->checkType == TopicProcessor::SPEECH_CHECK_TYPE::kIntimidate ? "intimidation"sv : "bribe"sv,
+				mismatch->nativeResult,
+				mismatch->engineResult,
+				mismatch->requiredValue,
+				mismatch->playerValue);
+		}
 	}
 }
\ No newline at end of file
@@ -1,6 +1,12 @@
 #pragma once
 
+#include "CommonLibEngine.h"
+#include "DialogueListSnapshot.h"
+#include "FlatHashMap.h"
+#include "SessionArena.h"
 #include "Scaleform.h"
+#include "SpeechThresholdIndex.h"
+#include "TopicProcessor.h"
 
 namespace Hooks
 {
@@ -12,63 +18,150 @@ namespace Hooks
 		static void Install() noexcept;
 		RE::UI_MESSAGE_RESULTS ProcessMessageEx(RE::UIMessage& a_message) noexcept;
 
+		// Processes the stale cached topics that a_speaker showed in the last dialogue with them, spread over frames,
+		// so they don't need to be processed on the frame the dialogue menu opens.
+		static void Prefetch(RE::TESObjectREFR* a_speaker) noexcept;
+
 	private:
 		using ProcessMessageFn = decltype(&RE::DialogueMenu::ProcessMessage);
 
 		static inline REL::Relocation<ProcessMessageFn> _ProcessMessageFn;
 
-		// https://stackoverflow.com/a/21439212
-		typedef std::tuple<RE::FormID, std::string> cache_key_t;
+		// Processed topics are cached until one of the inputs of the speech checks changes. Perks added by scripts, quest stages,
+		// factions and relationships don't send events, so results that evaluated conditions only last for the epoch of one dialogue.
+		// Regular topics don't evaluate conditions, so unless the game substituted tokens into their text, they're kept across dialogues
+		// until the settings change.
+		struct CachedTopic final
+		{
+			// the cache is keyed by a fingerprint of these, which are compared to rule out collisions
+			RE::FormID topicFormID;
+			RE::FormID speakerFormID;
+			std::string topicName;
+
+			// Needed to process the topic again if the dialogue still shows the formatted text of a stale entry. The game substitutes
+			// tokens such as <BribeCost> into it, so unless it's just the topic name, it's only reused in the epoch it was read in.
+			std::string rawTopicText;
+			std::uint32_t rawTopicTextEpoch;
+			std::string topicText;
+			std::optional<Scaleform::TopicDisplayData> displayData;
+			TopicProcessor::SPEECH_DEPENDENCY speechDependency;
+			float requiredSpeechLevel;
+			std::uint32_t epoch;
+			std::uint32_t settingsGeneration;
+			bool dependsOnConditions;
+			bool prefetched;  // processed by Prefetch and not shown since
+		};
 
-		struct cache_key_hash
+		// the player's speech level is handled separately by speechThresholds, so it only invalidates the topics that depend on it
+		struct CacheEpochInputs final
 		{
-			size_t
-			operator()(cache_key_t const& key) const
-			{
-				size_t seed = 0;
-				const auto& formID = get<0>(key);
-				const auto& text = get<1>(key);
-				seed ^= std::hash<RE::FormID>()(formID) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-				seed ^= std::hash<std::string>()(text) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-				return seed;
-			}
+			std::int32_t playerGold;
+			std::uint16_t playerLevel;
+			std::uint32_t eventChangeCount;
+			std::uint32_t settingsGeneration;  // reloading the settings can change the text and display data of every topic
+
+			bool operator==(const CacheEpochInputs&) const = default;
 		};
 
-		enum class SPEECH_CHECK_TYPE
+		struct CacheStats final
 		{
-			kPersuade,
-			kIntimidate,
-			kBribe,
-			kNone,
+			std::uint64_t hits;
+			std::uint64_t misses;
+			std::uint64_t speechLevelInvalidations;
+			std::uint64_t processedEntries;
+			std::uint64_t skippedEntries;
+			std::uint64_t shows;
+			std::uint64_t showsServedFromCache;     // without processing any topic
+			std::uint64_t showsServedWithPrefetch;  // of those, the ones that showed prefetched topics
+			std::uint64_t prefetchedTopics;
+			std::uint64_t prefetchHits;
 		};
 
-		struct SpeechCheckData final
+		struct PrefetchState final
 		{
-			std::string mainText;
-			std::string tagText;
-			SPEECH_CHECK_TYPE tagType;
-			SPEECH_CHECK_TYPE checkType;
-			bool passesCheck;
-			float requiredSpeechLevel;  // only applicable for persuasion (bribes and intimidation are more complicated: https://en.uesp.net/wiki/Skyrim:Speech#Bribe_Formula)
-			std::string predictedResponseText;
+			RE::ObjectRefHandle speaker;
+			RE::FormID speakerFormID;
+			std::vector<std::uint64_t> fingerprints;
+			std::size_t nextIndex;
+			bool isScheduled;
+			bool hasEpoch;  // the current epoch was checked for the dialogue with the speaker, which it's kept for if that opens soon
+			std::chrono::steady_clock::time_point epochStart;
 		};
 
-		static inline std::unordered_map<std::string, Scaleform::TopicDisplayData> topicDisplayData;
+		// how long after a prefetch began the dialogue with its speaker keeps the epoch the topics were prefetched in
+		static constexpr auto kPrefetchedEpochLifetime = std::chrono::seconds(3);
+		// The caches that outlive the dialogues are cleared as a whole after a dialogue in which they grew past these sizes.
+		static constexpr std::size_t kMaxCachedTopics = 4096;
+		static constexpr std::size_t kMaxRememberedSpeakers = 256;
+
+		static inline FlatHashMap<std::uint64_t, CachedTopic, FlatIdentityHash> cache;
+		static inline std::uint32_t cacheEpoch = 0;
+		static inline CacheEpochInputs cacheEpochInputs{};
+		static inline std::vector<std::pair<const RE::TESGlobal*, float>> cacheEpochGlobals;
+		static inline float cacheSpeechLevel = 0.0F;
+		static inline SpeechThresholdIndex speechThresholds;
+		static inline std::uint32_t cacheGeneration = 0;  // changes whenever cached topics are invalidated
+		static inline CacheStats sessionCacheStats{};
+		static inline CacheStats totalCacheStats{};
+
+		// the working data of the open dialogue menu, which is released all at once on kHide
+		static inline SessionArena sessionArena;
+		static inline Scaleform::TopicDisplayTable topicDisplayData{ &sessionArena };
+
+		static inline DialogueListSnapshot snapshot;
+		static inline DialogueListSnapshot nextSnapshot;
+		static inline RE::FormID snapshotSpeakerFormID = 0;
+		static inline std::uint32_t snapshotCacheGeneration = 0;
 
-		static void processTopic(RE::MenuTopicManager::Dialogue* a_dialogue) noexcept;
+		// the fingerprints of the topics each speaker showed in the last dialogue with them
+		static inline FlatHashMap<RE::FormID, std::vector<std::uint64_t>> speakerTopics;
+		static inline PrefetchState prefetchState{};
 
-		static SpeechCheckData getSpeechCheckData(const RE::MenuTopicManager::Dialogue* a_dialogue) noexcept;
-		static void applyTagPlaceholder(Hooks::DialogueMenuEx::SpeechCheckData& result);
-		static std::string applyFormat(
-			const std::string& a_format,
-			const SpeechCheckData* a_speechCheckData,
-			const std::string& a_resultText,
-			const float a_playerSpeechLevel) noexcept;
+		// processes the topic of a_dialogue or applies the cached result, returns the fingerprint of the cached topic
+		static std::uint64_t processDialogue(
+			RE::MenuTopicManager::Dialogue* a_dialogue,
+			const DialogueContext& a_context,
+			const CommonLibEngine& a_engine) noexcept;
+		// Processes a_topicText of a_topic for the speaker of a_context and caches the result under a_fingerprint, replacing a_oldTopic.
+		// a_rawTopicTextEpoch is the epoch in which the game gave the topic a_topicText.
+		static CachedTopic& processTopic(
+			const std::uint64_t a_fingerprint,
+			const RE::TESTopic* a_topic,
+			const std::string_view a_topicText,
+			const std::uint32_t a_rawTopicTextEpoch,
+			const CachedTopic* a_oldTopic,
+			const DialogueContext& a_context,
+			const CommonLibEngine& a_engine) noexcept;
+		// Shows the raw text of a stale entry unformatted, when it can't be processed again because its substitutions may be outdated.
+		static CachedTopic& passThroughTopic(const std::uint64_t a_fingerprint, CachedTopic& a_cachedTopic) noexcept;
+		static void buildTopicDisplayData(const DialogueListSnapshot& a_snapshot) noexcept;
+		// writes the entries of a_snapshot to the session trace, with their topics as the speaker of a_context sees them
+		static void recordDialogueList(
+			const RE::UI_MESSAGE_TYPE a_messageType,
+			const DialogueListSnapshot& a_snapshot,
+			const DialogueContext& a_context,
+			const CommonLibEngine& a_engine) noexcept;
 
-		static void hydrateTextData(SpeechCheckData& a_speechCheckData, const RE::MenuTopicManager::Dialogue* a_dialogue) noexcept;
-		static void hydrateCheckData(SpeechCheckData& a_speechCheckData, const RE::TESTopic* a_topic) noexcept;
+		// runs as an SKSE task, and schedules itself for the next frame until all fingerprints are checked
+		static void prefetchStep() noexcept;
+		static void rememberSpeakerTopics() noexcept;
 
-		static bool evaluateSpeechCheck(const RE::TESConditionItem* a_conditionItem, bool a_checkForAmuletOfArticulation) noexcept;
-		static std::string getResponseText(RE::TESTopicInfo* a_responseInfo, RE::TESObjectREFR* a_speaker) noexcept;
+		static void beginEpoch() noexcept;
+		// every dialogue begins a new epoch, unless it's the one a prefetch just began an epoch for
+		static void beginDialogueEpoch(const RE::FormID a_speakerFormID) noexcept;
+		static void updateCacheEpoch(const DialogueContext& a_context) noexcept;
+		static bool isCurrent(const CachedTopic& a_cachedTopic) noexcept;
+		static bool canReuseRawTopicText(const CachedTopic& a_cachedTopic) noexcept;
+		static void trimCaches() noexcept;
+		static void trackCacheEpochGlobal(const RE::TESGlobal* a_global) noexcept;
+		static void invalidateForSpeechLevel(const float a_playerSpeechLevel) noexcept;
+		static void updateSpeechThresholds(const std::uint64_t a_fingerprint, const CachedTopic* a_oldTopic, const CachedTopic& a_newTopic) noexcept;
+		static void applyCachedTopic(RE::MenuTopicManager::Dialogue* a_dialogue, const CachedTopic& a_cachedTopic) noexcept;
+		static void logCacheStats() noexcept;
+		static void logNativeCalls() noexcept;
+		// the latency of each stage in this dialogue, if the profiler is recording
+		static void logProfile() noexcept;
+		// how often SpeechFormulas differed from the game, if uSpeechCheckEvaluator is the differential mode
+		static void logSpeechCheckComparisons() noexcept;
 	};
 }
\ No newline at end of file
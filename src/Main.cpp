@@ -17,13 +17,53 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 See EXCEPTIONS for additional permissions.
 */
 
+#include "Events.h"
 #include "Hooks.h"
+#include "Profiler.h"
+#include "SessionRecorder.h"
 #include "Settings.h"
+#include "TopicIndex.h"
+
+namespace
+{
+	void OnMessage(SKSE::MessagingInterface::Message* a_message)
+	{
+		if (a_message->type == SKSE::MessagingInterface::kDataLoaded) {
+			// again, now that the game's language is known
+			Settings::Load();
+			Events::CacheInvalidationEventSink::Install();
+			Events::CrosshairRefEventSink::Install();
+			TopicIndex::Build();
+		}
+	}
+}
 
 SKSEPluginLoad(const SKSE::LoadInterface* skse)
 {
 	Init(skse);
 	Settings::Load();
+	if (Settings::Get()->reloadOnChange) {
+		Settings::StartWatching();
+	}
+#ifdef PP_ENABLE_PROFILING
+	if (Settings::Get()->enableProfiling) {
+		if (auto path = logger::log_directory()) {
+			*path /= "PredictablePersuasion.trace.json";
+			if (!Profiler::Start(*path)) {
+				logger::error("Failed to open the trace file {}", path->string());
+			}
+		}
+	}
+#endif
+	if (Settings::Get()->recordSessions) {
+		if (auto path = logger::log_directory()) {
+			*path /= "PredictablePersuasion.sessions.bin";
+			if (!SessionRecorder::Start(*path)) {
+				logger::error("Failed to open the session trace {}", path->string());
+			}
+		}
+	}
 	Hooks::Install();
+	SKSE::GetMessagingInterface()->RegisterListener(OnMessage);
 	return true;
 }
\ No newline at end of file
@@ -3,5 +3,12 @@
 #include "RE/Skyrim.h"
 #include "SKSE/SKSE.h"
 
+#include <chrono>
+#include <condition_variable>
+#include <execution>
+#include <memory_resource>
+#include <mutex>
+#include <thread>
+
 using namespace std::literals;
 namespace logger = SKSE::log;
\ No newline at end of file
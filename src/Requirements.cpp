@@ -23,10 +23,104 @@ See EXCEPTIONS for additional permissions.
 
 namespace Requirements
 {
+	namespace
+	{
+		struct ResolvedRequirement final
+		{
+			Requirement::TYPE type;
+			RE::TESForm* form;          // the perk, global or quest
+			RE::ActorValue actorValue;  // kNone for the player's level
+			Dialogue::OPCODE opCode;
+			float value;
+		};
+
+		// the requirements of the settings with this generation, looked up once instead of on every check
+		std::uint32_t resolvedGeneration = 0;
+		bool hasMissingForm = false;
+		std::vector<ResolvedRequirement> resolvedRequirements;
+
+		RE::TESForm* LookUpForm(const Requirement& a_requirement) noexcept
+		{
+			if (a_requirement.plugin.empty()) {
+				return RE::TESForm::LookupByID(a_requirement.formID);
+			}
+			const auto dataHandler = RE::TESDataHandler::GetSingleton();
+			return dataHandler ? dataHandler->LookupForm(a_requirement.formID, a_requirement.plugin) : nullptr;
+		}
+
+		std::pair<RE::FormType, std::string_view> GetFormType(const Requirement::TYPE a_type) noexcept
+		{
+			switch (a_type) {
+			case Requirement::TYPE::kPerk:
+				return { RE::FormType::Perk, "perk"sv };
+			case Requirement::TYPE::kGlobal:
+				return { RE::FormType::Global, "global"sv };
+			case Requirement::TYPE::kQuestStage:
+				return { RE::FormType::Quest, "quest"sv };
+			default:
+				return { RE::FormType::None, "form"sv };
+			}
+		}
+
+		void Resolve(const Settings& a_settings) noexcept
+		{
+			resolvedGeneration = a_settings.generation;
+			hasMissingForm = false;
+			resolvedRequirements.clear();
+
+			for (const auto& requirement : a_settings.requirements) {
+				ResolvedRequirement resolved{ requirement.type, nullptr, RE::ActorValue::kNone, requirement.opCode, requirement.value };
+				if (requirement.type == Requirement::TYPE::kActorValue) {
+					if (_stricmp(requirement.actorValue.c_str(), "Level") != 0) {
+						resolved.actorValue = RE::ActorValueList::GetSingleton()->LookupActorValueByName(requirement.actorValue.c_str());
+						if (resolved.actorValue == RE::ActorValue::kNone) {
+							logger::error("{} is not an actor value", requirement.actorValue);
+							hasMissingForm = true;
+							continue;
+						}
+					}
+					resolvedRequirements.push_back(resolved);
+					continue;
+				}
+
+				resolved.form = LookUpForm(requirement);
+				const auto [formType, formTypeName] = GetFormType(requirement.type);
+				if (!resolved.form) {
+					logger::error("Failed to find form with Form ID {:08X}{}{}", requirement.formID, requirement.plugin.empty() ? "" : " in ", requirement.plugin);
+					hasMissingForm = true;
+				} else if (resolved.form->GetFormType() != formType) {
+					logger::error("Form ID {:08X} is not a {}", resolved.form->GetFormID(), formTypeName);
+					hasMissingForm = true;
+				} else {
+					resolvedRequirements.push_back(resolved);
+				}
+			}
+		}
+
+		bool IsMet(const ResolvedRequirement& a_requirement, RE::PlayerCharacter* a_player) noexcept
+		{
+			switch (a_requirement.type) {
+			case Requirement::TYPE::kPerk:
+				return a_player->HasPerk(static_cast<RE::BGSPerk*>(a_requirement.form));
+			case Requirement::TYPE::kActorValue:
+				{
+					const auto value = a_requirement.actorValue == RE::ActorValue::kNone ? static_cast<float>(a_player->GetLevel()) : a_player->AsActorValueOwner()->GetActorValue(a_requirement.actorValue);
+					return Dialogue::Compare(value, a_requirement.opCode, a_requirement.value);
+				}
+			case Requirement::TYPE::kGlobal:
+				return Dialogue::Compare(static_cast<const RE::TESGlobal*>(a_requirement.form)->value, a_requirement.opCode, a_requirement.value);
+			case Requirement::TYPE::kQuestStage:
+				return Dialogue::Compare(static_cast<const RE::TESQuest*>(a_requirement.form)->GetCurrentStageID(), a_requirement.opCode, a_requirement.value);
+			}
+			return false;
+		}
+	}
+
 	bool AreRequirementsMet() noexcept
 	{
-		if (!Settings::requirePerk) {
-			return true;
+		const auto settings = Settings::Get();
+		if (settings->requirements.empty()) {
+			return !settings->hasInvalidRequirements;
 		}
 
 		const auto player = RE::PlayerCharacter::GetSingleton();
@@ -34,17 +128,13 @@ namespace Requirements
 			return false;
 		}
 
-		if (const auto requiredPerkForm = RE::TESForm::LookupByID(Settings::requiredPerkFormID)) {
-			const auto requiredPerk = requiredPerkForm->As<RE::BGSPerk>();
-			if (!requiredPerk) {
-				logger::error("Form ID {} is not a perk", Settings::requiredPerkFormID);
-				return false;
-			}
-
-			return player->HasPerk(requiredPerk);
+		// reloading the settings publishes a new generation, whose forms are looked up on the main thread that checks them
+		if (resolvedGeneration != settings->generation) {
+			Resolve(*settings);
 		}
-
-		logger::error("Failed to find form with Form ID {}", Settings::requiredPerkFormID);
-		return false;
+		if (hasMissingForm || settings->hasInvalidRequirements) {
+			return false;
+		}
+		return std::ranges::all_of(resolvedRequirements, [&](const ResolvedRequirement& a_requirement) { return IsMet(a_requirement, player); });
 	}
 }
\ No newline at end of file
@@ -1,5 +1,8 @@
 #pragma once
 
+// Whether the player meets the [Requirements] of the settings. Only the forms and actor values are cached, they're looked up once
+// for every load of the settings. The requirements themselves are checked every time, as scripts can add perks and set quest stages
+// without an event, and checking them is as cheap as checking whether they changed.
 namespace Requirements
 {
 	bool AreRequirementsMet() noexcept;
@@ -19,11 +19,56 @@ See EXCEPTIONS for additional permissions.
 
 #include "Scaleform.h"
 
+#include "CommonLibEngine.h"
+#include "Profiler.h"
 #include "Settings.h"
 
+namespace
+{
+	Scaleform::NativeCallCounts nativeCallCounts{};
+
+	// What ShowModSubtitle keeps of the dialogue menu movie, so moving the selection reads little more than the highlighted index.
+	// Only the function handlers change the colour of the subtitle and whether it's a game subtitle, which the presenter tracks.
+	struct SubtitleState final
+	{
+		RE::GPtr<RE::GFxMovieView> movie;
+		RE::GFxValue entriesA;  // the list only empties and refills this array, so it's the same one while the menu is open
+		RE::GFxValue subtitleColor;
+		bool hasHighlightedIndex;
+		std::vector<RE::GFxValue> subtitles;  // the strings created in the movie, by the slots of the presenter
+		Scaleform::SubtitlePresenter presenter;
+
+		void Install(const RE::DialogueMenu* a_dialogueMenu, RE::GFxValue a_topicList, const Settings& a_settings) noexcept
+		{
+			movie = a_dialogueMenu->uiMovie;
+			a_topicList.GetMember("EntriesA", &entriesA);
+			subtitleColor.SetNumber(a_settings.subtitleColor);
+			hasHighlightedIndex = a_topicList.HasMember("iHighlightedIndex");
+			presenter.Reset();
+		}
+
+		void Release() noexcept
+		{
+			presenter.Reset();
+			subtitles.clear();
+			subtitleColor.SetUndefined();
+			entriesA.SetUndefined();
+			movie.reset();
+		}
+	} subtitleState{};
+
+	// Handlers are created once and never released, only the function objects that call them are created for each movie.
+	template <class T>
+	T* GetHandler() noexcept
+	{
+		static const auto handler = new T();
+		return handler;
+	}
+}
+
 namespace Scaleform
 {
-	void InstallHooks(const std::unordered_map<std::string, TopicDisplayData>* a_topicDisplayData) noexcept
+	void InstallHooks(const TopicDisplayTable* a_topicDisplayData) noexcept
 	{
 		const auto ui = RE::UI::GetSingleton();
 		if (!ui) {
@@ -55,13 +100,26 @@ namespace Scaleform
 			return;
 		}
 
-		if (Settings::applyTopicColors) {
+		// the handlers are installed for each movie, so settings that are reloaded take effect the next time the menu opens
+		const auto settings = Settings::Get();
+		// The list redraws the old and new selected entry without UpdateList, so batched colours need doSetSelectedIndex as well.
+		// The movie can't read colours that are pushed into it, so batching only saves the calls into the plugin, but each
+		// redraw still has to read and colour every clip from here.
+		const auto batchTopicColors = settings->applyTopicColors && settings->batchTopicColors && topicList.HasMember("UpdateList");
+		if (batchTopicColors) {
+			UpdateListFunctionHandler::Install(dialogueMenu, topicList, a_topicDisplayData);
+		} else if (settings->applyTopicColors) {
 			SetEntryTextFunctionHandler::Install(dialogueMenu, topicList, a_topicDisplayData);
 		}
 
-		if (Settings::showSubtitles != Settings::SHOW_SUBTITLES::kNever) {
+		const auto showSubtitles = settings->showSubtitles != Settings::SHOW_SUBTITLES::kNever;
+		if (batchTopicColors || showSubtitles) {
+			DoSetSelectedIndexFunctionHandler::Install(dialogueMenu, dialogueMenu_mc, subtitleText, topicList, a_topicDisplayData, batchTopicColors, showSubtitles);
+		}
+
+		if (showSubtitles) {
+			subtitleState.Install(dialogueMenu, topicList, *settings);
 			ShowDialogueTextFunctionHandler::Install(dialogueMenu, dialogueMenu_mc, subtitleText);
-			DoSetSelectedIndexFunctionHandler::Install(dialogueMenu, dialogueMenu_mc, subtitleText, topicList, a_topicDisplayData);
 			if (topicList.HasMember("iHighlightedIndex")) {
 				// Better Dialogue Controls and mods based on it decouple mouse highlighting from the selected item:
 				// See: https://github.com/fabd/skyrimui/commit/e5f0d8d719acd2d2545357d4415882f54084d74d
@@ -71,45 +129,41 @@ namespace Scaleform
 		}
 	}
 
+	void ReleaseMovieValues() noexcept
+	{
+		GetHandler<ShowDialogueTextFunctionHandler>()->ReleaseMovieValues();
+		GetHandler<DoSetSelectedIndexFunctionHandler>()->ReleaseMovieValues();
+		GetHandler<MoveSelectionUpFunctionHandler>()->ReleaseMovieValues();
+		GetHandler<MoveSelectionDownFunctionHandler>()->ReleaseMovieValues();
+		subtitleState.Release();
+	}
+
+	const NativeCallCounts& GetNativeCallCounts() noexcept
+	{
+		return nativeCallCounts;
+	}
+
+	void ResetNativeCallCounts() noexcept
+	{
+		nativeCallCounts = {};
+	}
+
 	void ShowModSubtitle(
 		RE::GFxValue a_dialogueMenu_mc,
 		RE::GFxValue a_topicList,
 		RE::GFxValue a_subtitleText,
-		const std::unordered_map<std::string, TopicDisplayData>* a_topicDisplayData) noexcept
+		const TopicDisplayTable* a_topicDisplayData) noexcept
 	{
-		if (!IsTopicListShown(a_dialogueMenu_mc))
-			return;
-
-		RE::GFxValue highlightedEntry = GetHiglightedEntry(a_topicList);
-		RE::GFxValue text;
-		highlightedEntry.GetMember("text", &text);
-		const auto textStr = std::string(text.GetString());
-		if (textStr.empty())
+		auto& state = subtitleState;
+		if (!state.movie || !IsTopicListShown(a_dialogueMenu_mc))
 			return;
 
-		const auto where = a_topicDisplayData->find(textStr);
-		if (where == a_topicDisplayData->end())
+		const auto highlightedIndex = GetHighlightedIndex(a_topicList);
+		if (highlightedIndex < 0)
 			return;
 
-		const auto& displayData = where->second;
-		if (displayData.subtitle.empty()) {
-			// prevent hiding game subtitles by overwriting them with empty strings
-			RE::GFxValue isGameSubtitle;
-			if (a_dialogueMenu_mc.GetMember("bIsGameSubtitle", &isGameSubtitle) && isGameSubtitle.GetBool()) {
-				RE::GFxValue currentSubtitle;
-				if (a_subtitleText.GetMember("text", &currentSubtitle)) {
-					std::string currentSubtitleStr(currentSubtitle.GetString());
-					if (!currentSubtitleStr.empty() && currentSubtitleStr != " ") {
-						return;
-					}
-				}
-			}
-		}
-
-		RE::GFxValue subtitle(displayData.subtitle);
-		a_subtitleText.SetMember("textColor", Settings::subtitleColor);
-		a_subtitleText.Invoke("SetText", nullptr, &subtitle, RE::UPInt(1));
-		a_dialogueMenu_mc.SetMember("bIsGameSubtitle", false);
+		GFxSubtitleView view(a_subtitleText);
+		state.presenter.Show(view, *a_topicDisplayData, static_cast<std::uint32_t>(highlightedIndex));
 	}
 
 	bool IsTopicListShown(RE::GFxValue a_dialogueMenu_mc) noexcept
@@ -120,27 +174,191 @@ namespace Scaleform
 		return eMenuState.GetNumber() == 1;  // eMenuState == TOPIC_LIST_SHOWN
 	}
 
-	RE::GFxValue GetHiglightedEntry(RE::GFxValue a_topicList) noexcept
+	std::int32_t GetHighlightedIndex(RE::GFxValue a_topicList) noexcept
 	{
-		RE::GFxValue highlightedEntry;
-		RE::GFxValue iHighlightedIndex;
-		if (a_topicList.GetMember("iHighlightedIndex", &iHighlightedIndex) && iHighlightedIndex.GetNumber() != -1) {
-			RE::GFxValue entriesA;
-			a_topicList.GetMember("EntriesA", &entriesA);
-			entriesA.GetElement(iHighlightedIndex.GetNumber(), &highlightedEntry);
-		} else {
-			a_topicList.Invoke("__get__selectedEntry", &highlightedEntry);
+		RE::GFxValue index;
+		if (subtitleState.hasHighlightedIndex && a_topicList.GetMember("iHighlightedIndex", &index) && index.IsNumber() && index.GetNumber() != -1) {
+			return static_cast<std::int32_t>(index.GetNumber());
+		}
+		// selectedEntry is EntriesA[iSelectedIndex], without the call to its getter
+		if (!a_topicList.GetMember("iSelectedIndex", &index) || !index.IsNumber())
+			return -1;
+		return static_cast<std::int32_t>(index.GetNumber());
+	}
+
+	GFxTopicListView::GFxTopicListView(RE::GFxValue a_topicList) noexcept :
+		topicList(a_topicList),
+		itemIndex(-1)
+	{}
+
+	std::uint32_t GFxTopicListView::GetNumEntryClips() noexcept
+	{
+		++nativeCallCounts.topicListView;
+		RE::GFxValue maxItemsShown;
+		if (!topicList.GetMember("iMaxItemsShown", &maxItemsShown) || !maxItemsShown.IsNumber())
+			return 0;
+		return static_cast<std::uint32_t>(maxItemsShown.GetNumber());
+	}
+
+	const char* GFxTopicListView::GetEntryText(const std::uint32_t a_clipIndex) noexcept
+	{
+		++nativeCallCounts.topicListView;
+		itemIndex = -1;
+		textField.SetUndefined();
+		text.SetUndefined();
+
+		const RE::GFxValue clipIndex(static_cast<double>(a_clipIndex));
+		RE::GFxValue entryClip;
+		if (!topicList.Invoke("GetClipByIndex", &entryClip, &clipIndex, RE::UPInt(1)) || entryClip.IsUndefined())
+			return nullptr;
+
+		// UpdateList leaves the item index of clips without an entry undefined
+		RE::GFxValue clipItemIndex;
+		if (!entryClip.GetMember("itemIndex", &clipItemIndex) || !clipItemIndex.IsNumber())
+			return nullptr;
+
+		if (!entryClip.GetMember("textField", &textField) || textField.IsUndefined())
+			return nullptr;
+
+		if (!textField.GetMember("text", &text) || !text.IsString())
+			return nullptr;
+
+		itemIndex = clipItemIndex.GetNumber();
+		return text.GetString();
+	}
+
+	bool GFxTopicListView::IsEntryNew(std::uint32_t) noexcept
+	{
+		++nativeCallCounts.topicListView;
+		if (entriesA.IsUndefined()) {
+			topicList.GetMember("EntriesA", &entriesA);
+		}
+		RE::GFxValue entryObject;
+		RE::GFxValue topicIsNew;
+		return !entriesA.GetElement(static_cast<std::uint32_t>(itemIndex), &entryObject) || !entryObject.GetMember("topicIsNew", &topicIsNew) || topicIsNew.GetBool();
+	}
+
+	void GFxTopicListView::SetEntryColor(std::uint32_t, const std::uint32_t a_color) noexcept
+	{
+		++nativeCallCounts.topicListView;
+		textField.SetMember("textColor", a_color);
+	}
+
+	std::uint32_t GFxTopicListView::GetEntryClipIndex(const std::uint32_t a_entryIndex) noexcept
+	{
+		++nativeCallCounts.topicListView;
+		if (entriesA.IsUndefined()) {
+			topicList.GetMember("EntriesA", &entriesA);
+		}
+		// UpdateList leaves the clip index of entries that are scrolled out of view undefined
+		RE::GFxValue entryObject;
+		RE::GFxValue clipIndex;
+		if (!entriesA.GetElement(a_entryIndex, &entryObject) || !entryObject.GetMember("clipIndex", &clipIndex) || !clipIndex.IsNumber())
+			return kNoClip;
+		return static_cast<std::uint32_t>(clipIndex.GetNumber());
+	}
+
+	std::int32_t GFxTopicListView::GetSelectedIndex() noexcept
+	{
+		++nativeCallCounts.topicListView;
+		RE::GFxValue selectedIndex;
+		if (!topicList.GetMember("iSelectedIndex", &selectedIndex) || !selectedIndex.IsNumber())
+			return -1;
+		return static_cast<std::int32_t>(selectedIndex.GetNumber());
+	}
+
+	GFxEntryClipView::GFxEntryClipView(RE::GFxValue a_entryClip, RE::GFxValue a_entryObject) noexcept :
+		entryClip(a_entryClip),
+		entryObject(a_entryObject)
+	{}
+
+	std::uint32_t GFxEntryClipView::GetNumEntryClips() noexcept
+	{
+		return 1;
+	}
+
+	const char* GFxEntryClipView::GetEntryText(std::uint32_t) noexcept
+	{
+		++nativeCallCounts.topicListView;
+		if (!entryClip.GetMember("textField", &textField) || textField.IsUndefined() || !textField.GetMember("text", &text) || !text.IsString())
+			return nullptr;
+		return text.GetString();
+	}
+
+	bool GFxEntryClipView::IsEntryNew(std::uint32_t) noexcept
+	{
+		++nativeCallCounts.topicListView;
+		RE::GFxValue topicIsNew;
+		return !entryObject.GetMember("topicIsNew", &topicIsNew) || topicIsNew.GetBool();
+	}
+
+	void GFxEntryClipView::SetEntryColor(std::uint32_t, const std::uint32_t a_color) noexcept
+	{
+		++nativeCallCounts.topicListView;
+		textField.SetMember("textColor", a_color);
+	}
+
+	std::uint32_t GFxEntryClipView::GetEntryClipIndex(std::uint32_t) noexcept
+	{
+		return 0;
+	}
+
+	std::int32_t GFxEntryClipView::GetSelectedIndex() noexcept
+	{
+		return -1;
+	}
+
+	GFxSubtitleView::GFxSubtitleView(RE::GFxValue a_subtitleText) noexcept :
+		subtitleText(a_subtitleText)
+	{}
+
+	const char* GFxSubtitleView::GetEntryText(const std::uint32_t a_entryIndex) noexcept
+	{
+		RE::GFxValue entry;
+		if (!subtitleState.entriesA.GetElement(a_entryIndex, &entry) || !entry.GetMember("text", &text) || !text.IsString())
+			return nullptr;
+		return text.GetString();
+	}
+
+	const char* GFxSubtitleView::GetSubtitleText() noexcept
+	{
+		if (!subtitleText.GetMember("text", &text) || !text.IsString())
+			return nullptr;
+		return text.GetString();
+	}
+
+	std::string_view GFxSubtitleView::GetResponseText(const Dialogue::TopicInfoHandle a_responseInfo) noexcept
+	{
+		const DialogueContext context(RE::MenuTopicManager::GetSingleton()->speaker.get(), Settings::Get());
+		const CommonLibEngine engine(context);
+		return engine.GetResponseText(a_responseInfo);
+	}
+
+	void GFxSubtitleView::CreateSubtitle(const std::uint32_t a_slot, const char* a_text) noexcept
+	{
+		auto& subtitles = subtitleState.subtitles;
+		if (a_slot >= subtitles.size()) {
+			subtitles.resize(a_slot + 1);
 		}
+		subtitleState.movie->CreateString(&subtitles[a_slot], a_text);
+	}
+
+	void GFxSubtitleView::ShowSubtitle(const std::uint32_t a_slot) noexcept
+	{
+		subtitleText.Invoke("SetText", nullptr, &subtitleState.subtitles[a_slot], RE::UPInt(1));
+	}
 
-		return highlightedEntry;
+	void GFxSubtitleView::ApplySubtitleColor() noexcept
+	{
+		subtitleText.SetMember("textColor", subtitleState.subtitleColor);
 	}
 
 	void SetEntryTextFunctionHandler::Install(
 		const RE::DialogueMenu* a_dialogueMenu,
 		RE::GFxValue a_topicList,
-		const std::unordered_map<std::string, TopicDisplayData>* a_topicDisplayData) noexcept
+		const TopicDisplayTable* a_topicDisplayData) noexcept
 	{
-		auto handler = RE::make_gptr<Scaleform::SetEntryTextFunctionHandler>();
+		const auto handler = GetHandler<SetEntryTextFunctionHandler>();
 		handler->topicDisplayData = a_topicDisplayData;
 
 		RE::GFxValue setEntryTextOriginal;
@@ -148,7 +366,7 @@ namespace Scaleform
 		a_topicList.SetMember("SetEntryTextOriginal", setEntryTextOriginal);
 
 		RE::GFxValue setEntryTextNew;
-		a_dialogueMenu->uiMovie->CreateFunction(&setEntryTextNew, handler.get());
+		a_dialogueMenu->uiMovie->CreateFunction(&setEntryTextNew, handler);
 		a_topicList.SetMember("SetEntryText", setEntryTextNew);
 	}
 
@@ -160,39 +378,48 @@ namespace Scaleform
 			return;
 		}
 
-		auto thisPtr = a_params.thisPtr;
-		auto& aEntryClip = a_params.args[0];
-		auto& aEntryObject = a_params.args[1];
+		++nativeCallCounts.setEntryText;
 
-		thisPtr->Invoke("SetEntryTextOriginal", nullptr, a_params.args, a_params.argCount);
+		a_params.thisPtr->Invoke("SetEntryTextOriginal", nullptr, a_params.args, a_params.argCount);
 
 		// new part of the function
-		RE::GFxValue textField;
-		if (!aEntryClip.GetMember("textField", &textField) || textField.IsUndefined())
-			return;
+		PROFILE_STAGE(kColorEntries);
+		GFxEntryClipView view(a_params.args[0], a_params.args[1]);
+		ColorEntry(view, *topicDisplayData, 0);
+	}
 
-		RE::GFxValue topicIsNew;
-		const auto newTopic = !aEntryObject.GetMember("topicIsNew", &topicIsNew) || topicIsNew.GetBool();
-		colorText(textField, newTopic);
+	void UpdateListFunctionHandler::Install(
+		const RE::DialogueMenu* a_dialogueMenu,
+		RE::GFxValue a_topicList,
+		const TopicDisplayTable* a_topicDisplayData) noexcept
+	{
+		const auto handler = GetHandler<UpdateListFunctionHandler>();
+		handler->topicDisplayData = a_topicDisplayData;
+
+		RE::GFxValue updateListOriginal;
+		a_topicList.GetMember("UpdateList", &updateListOriginal);
+		a_topicList.SetMember("UpdateListOriginal", updateListOriginal);
+
+		RE::GFxValue updateListNew;
+		a_dialogueMenu->uiMovie->CreateFunction(&updateListNew, handler);
+		a_topicList.SetMember("UpdateList", updateListNew);
 	}
 
-	void SetEntryTextFunctionHandler::colorText(RE::GFxValue a_textField, bool a_topicIsNew) noexcept
+	// replaces: https://github.com/Mardoxx/skyrimui/blob/425aa8a31de31fb11fe78ee6cec799f4ba31af03/src/common/Shared/BSScrollingList.as (UpdateList)
+	void UpdateListFunctionHandler::Call(Params& a_params)
 	{
-		RE::GFxValue text;
-		a_textField.GetMember("text", &text);
-		const auto textStr = std::string(text.GetString());
-		const auto where = topicDisplayData->find(textStr);
-		if (where == topicDisplayData->end())
-			return;
+		++nativeCallCounts.updateList;
+
+		a_params.thisPtr->Invoke("UpdateListOriginal", nullptr, a_params.args, a_params.argCount);
 
-		const auto& displayData = where->second;
-		a_textField.SetMember("textColor", a_topicIsNew ? displayData.newColor : displayData.oldColor);
+		// new part of the function
+		GFxTopicListView view(*a_params.thisPtr);
+		ColorEntries(view, *topicDisplayData);
 	}
 
 	void ShowDialogueTextFunctionHandler::Install(const RE::DialogueMenu* a_dialogueMenu, RE::GFxValue a_dialogueMenu_mc, RE::GFxValue a_subtitleText) noexcept
 	{
-		auto handler = RE::make_gptr<Scaleform::ShowDialogueTextFunctionHandler>();
-		handler->dialogueMenu_mc = a_dialogueMenu_mc;
+		const auto handler = GetHandler<ShowDialogueTextFunctionHandler>();
 		handler->subtitleText = a_subtitleText;
 
 		if (!handler->subtitleText.GetMember("textColor", &handler->defaultSubtitleColor)) {
@@ -200,10 +427,8 @@ namespace Scaleform
 			return;
 		}
 
-		a_dialogueMenu_mc.SetMember("bIsGameSubtitle", false);
-
 		RE::GFxValue showDialogueText;
-		a_dialogueMenu->uiMovie->CreateFunction(&showDialogueText, handler.get());
+		a_dialogueMenu->uiMovie->CreateFunction(&showDialogueText, handler);
 		a_dialogueMenu_mc.SetMember("ShowDialogueText", showDialogueText);
 	}
 
@@ -215,11 +440,19 @@ namespace Scaleform
 			return;
 		}
 
+		++nativeCallCounts.showDialogueText;
+
 		const auto& astrText = a_params.args[0];
 
 		subtitleText.SetMember("textColor", defaultSubtitleColor);
 		subtitleText.Invoke("SetText", nullptr, &astrText, RE::UPInt(1));
-		dialogueMenu_mc.SetMember("bIsGameSubtitle", true);
+		subtitleState.presenter.OnGameSubtitleShown();
+	}
+
+	void ShowDialogueTextFunctionHandler::ReleaseMovieValues() noexcept
+	{
+		subtitleText.SetUndefined();
+		defaultSubtitleColor.SetUndefined();
 	}
 
 	void DoSetSelectedIndexFunctionHandler::Install(
@@ -227,10 +460,14 @@ namespace Scaleform
 		RE::GFxValue a_dialogueMenu_mc,
 		RE::GFxValue a_subtitleText,
 		RE::GFxValue a_topicList,
-		const std::unordered_map<std::string, TopicDisplayData>* a_topicDisplayData) noexcept
+		const TopicDisplayTable* a_topicDisplayData,
+		const bool a_colorEntries,
+		const bool a_showSubtitles) noexcept
 	{
-		auto handler = RE::make_gptr<Scaleform::DoSetSelectedIndexFunctionHandler>();
+		const auto handler = GetHandler<DoSetSelectedIndexFunctionHandler>();
 		handler->topicDisplayData = a_topicDisplayData;
+		handler->colorEntries = a_colorEntries;
+		handler->showSubtitles = a_showSubtitles;
 		handler->dialogueMenu_mc = a_dialogueMenu_mc;
 		handler->subtitleText = a_subtitleText;
 		handler->topicList = a_topicList;
@@ -240,15 +477,37 @@ namespace Scaleform
 		handler->topicList.SetMember("doSetSelectedIndexOriginal", doSetSelectedIndexOriginal);
 
 		RE::GFxValue doSetSelectedIndexNew;
-		a_dialogueMenu->uiMovie->CreateFunction(&doSetSelectedIndexNew, handler.get());
+		a_dialogueMenu->uiMovie->CreateFunction(&doSetSelectedIndexNew, handler);
 		handler->topicList.SetMember("doSetSelectedIndex", doSetSelectedIndexNew);
 	}
 
 	// replaces: https://github.com/Mardoxx/skyrimui/blob/425aa8a31de31fb11fe78ee6cec799f4ba31af03/src/common/Shared/BSScrollingList.as#L159-L182
 	void DoSetSelectedIndexFunctionHandler::Call(Params& a_params)
 	{
-		a_params.thisPtr->Invoke("doSetSelectedIndexOriginal", nullptr, a_params.args, a_params.argCount);
-		ShowModSubtitle(dialogueMenu_mc, topicList, subtitleText, topicDisplayData);
+		++nativeCallCounts.selection;
+
+		if (!colorEntries) {
+			a_params.thisPtr->Invoke("doSetSelectedIndexOriginal", nullptr, a_params.args, a_params.argCount);
+		} else {
+			GFxTopicListView view(topicList);
+			const auto previousIndex = view.GetSelectedIndex();
+			const auto numUpdateLists = nativeCallCounts.updateList;
+			a_params.thisPtr->Invoke("doSetSelectedIndexOriginal", nullptr, a_params.args, a_params.argCount);
+			// scrolling redraws the whole list with UpdateList, which already coloured it
+			if (nativeCallCounts.updateList == numUpdateLists) {
+				ColorSelection(view, *topicDisplayData, previousIndex);
+			}
+		}
+		if (showSubtitles) {
+			ShowModSubtitle(dialogueMenu_mc, topicList, subtitleText, topicDisplayData);
+		}
+	}
+
+	void DoSetSelectedIndexFunctionHandler::ReleaseMovieValues() noexcept
+	{
+		dialogueMenu_mc.SetUndefined();
+		subtitleText.SetUndefined();
+		topicList.SetUndefined();
 	}
 
 	void MoveSelectionUpFunctionHandler::Install(
@@ -256,9 +515,9 @@ namespace Scaleform
 		RE::GFxValue a_dialogueMenu_mc,
 		RE::GFxValue a_subtitleText,
 		RE::GFxValue a_topicList,
-		const std::unordered_map<std::string, TopicDisplayData>* a_topicDisplayData) noexcept
+		const TopicDisplayTable* a_topicDisplayData) noexcept
 	{
-		auto handler = RE::make_gptr<Scaleform::MoveSelectionUpFunctionHandler>();
+		const auto handler = GetHandler<MoveSelectionUpFunctionHandler>();
 		handler->topicDisplayData = a_topicDisplayData;
 		handler->dialogueMenu_mc = a_dialogueMenu_mc;
 		handler->subtitleText = a_subtitleText;
@@ -269,25 +528,34 @@ namespace Scaleform
 		a_topicList.SetMember("moveSelectionUpOriginal", moveSelectionUpOriginal);
 
 		RE::GFxValue moveSelectionUpNew;
-		a_dialogueMenu->uiMovie->CreateFunction(&moveSelectionUpNew, handler.get());
+		a_dialogueMenu->uiMovie->CreateFunction(&moveSelectionUpNew, handler);
 		a_topicList.SetMember("moveSelectionUp", moveSelectionUpNew);
 	}
 
 	// replaces: https://github.com/fabd/skyrimui/blob/ba35b0b559939e9b53179599f96757a46f168357/src/common/Shared/BSScrollingList.as#L443-L451
 	void MoveSelectionUpFunctionHandler::Call(Params& a_params)
 	{
+		++nativeCallCounts.selection;
+
 		a_params.thisPtr->Invoke("moveSelectionUpOriginal", nullptr, a_params.args, a_params.argCount);
 		ShowModSubtitle(dialogueMenu_mc, topicList, subtitleText, topicDisplayData);
 	}
 
+	void MoveSelectionUpFunctionHandler::ReleaseMovieValues() noexcept
+	{
+		dialogueMenu_mc.SetUndefined();
+		subtitleText.SetUndefined();
+		topicList.SetUndefined();
+	}
+
 	void MoveSelectionDownFunctionHandler::Install(
 		const RE::DialogueMenu* a_dialogueMenu,
 		RE::GFxValue a_dialogueMenu_mc,
 		RE::GFxValue a_subtitleText,
 		RE::GFxValue a_topicList,
-		const std::unordered_map<std::string, TopicDisplayData>* a_topicDisplayData) noexcept
+		const TopicDisplayTable* a_topicDisplayData) noexcept
 	{
-		auto handler = RE::make_gptr<Scaleform::MoveSelectionDownFunctionHandler>();
+		const auto handler = GetHandler<MoveSelectionDownFunctionHandler>();
 		handler->topicDisplayData = a_topicDisplayData;
 		handler->dialogueMenu_mc = a_dialogueMenu_mc;
 		handler->subtitleText = a_subtitleText;
@@ -298,14 +566,23 @@ namespace Scaleform
 		a_topicList.SetMember("moveSelectionDownOriginal", moveSelectionDownOriginal);
 
 		RE::GFxValue moveSelectionDownNew;
-		a_dialogueMenu->uiMovie->CreateFunction(&moveSelectionDownNew, handler.get());
+		a_dialogueMenu->uiMovie->CreateFunction(&moveSelectionDownNew, handler);
 		a_topicList.SetMember("moveSelectionDown", moveSelectionDownNew);
 	}
 
 	// replaces: https://github.com/fabd/skyrimui/blob/ba35b0b559939e9b53179599f96757a46f168357/src/common/Shared/BSScrollingList.as#L453-L461
 	void MoveSelectionDownFunctionHandler::Call(Params& a_params)
 	{
+		++nativeCallCounts.selection;
+
 		a_params.thisPtr->Invoke("moveSelectionDownOriginal", nullptr, a_params.args, a_params.argCount);
 		ShowModSubtitle(dialogueMenu_mc, topicList, subtitleText, topicDisplayData);
 	}
+
+	void MoveSelectionDownFunctionHandler::ReleaseMovieValues() noexcept
+	{
+		dialogueMenu_mc.SetUndefined();
+		subtitleText.SetUndefined();
+		topicList.SetUndefined();
+	}
 }
\ No newline at end of file
@@ -1,40 +1,131 @@
 #pragma once
 
+#include "SubtitlePresenter.h"
+#include "TopicDisplayTable.h"
+#include "TopicListColors.h"
+
 namespace Scaleform
 {
-	// the ActionScript 2 code of the dialogue menu only has access to the text of the topics, so additional data needs to be passed
-	struct TopicDisplayData final
+	// The calls from ActionScript into the function handlers, each of which crosses from the movie into native code,
+	// and the calls of the handlers into the topic list through ITopicListView, which cross back into the movie.
+	struct NativeCallCounts final
 	{
-		std::uint32_t oldColor;
-		std::uint32_t newColor;
-		std::string subtitle;
+		std::uint32_t setEntryText;
+		std::uint32_t updateList;
+		std::uint32_t selection;
+		std::uint32_t showDialogueText;
+		std::uint32_t topicListView;
+
+		std::uint32_t Total() const noexcept { return setEntryText + updateList + selection + showDialogueText + topicListView; }
 	};
 
-	void InstallHooks(const std::unordered_map<std::string, TopicDisplayData>* a_topicDisplayData) noexcept;
+	void InstallHooks(const TopicDisplayTable* a_topicDisplayData) noexcept;
+	// The function handlers are reused for every dialogue menu, so the values they keep of the movie have to be released
+	// while the movie still exists.
+	void ReleaseMovieValues() noexcept;
+
+	const NativeCallCounts& GetNativeCallCounts() noexcept;
+	void ResetNativeCallCounts() noexcept;
 
 	void ShowModSubtitle(
 		RE::GFxValue a_dialogueMenu_mc,
 		RE::GFxValue a_topicList,
 		RE::GFxValue a_subtitleText,
-		const std::unordered_map<std::string, TopicDisplayData>* a_topicDisplayData) noexcept;
+		const TopicDisplayTable* a_topicDisplayData) noexcept;
 
 	bool IsTopicListShown(RE::GFxValue a_dialogueMenu_mc) noexcept;
-	RE::GFxValue GetHiglightedEntry(RE::GFxValue a_topicList) noexcept;
+	// the index in EntriesA of the highlighted entry, -1 if there is none
+	std::int32_t GetHighlightedIndex(RE::GFxValue a_topicList) noexcept;
+
+	// the entry clips of the topic list movie clip
+	class GFxTopicListView final : public ITopicListView
+	{
+	public:
+		explicit GFxTopicListView(RE::GFxValue a_topicList) noexcept;
+
+		std::uint32_t GetNumEntryClips() noexcept override;
+		const char* GetEntryText(std::uint32_t a_clipIndex) noexcept override;
+		bool IsEntryNew(std::uint32_t a_clipIndex) noexcept override;
+		void SetEntryColor(std::uint32_t a_clipIndex, std::uint32_t a_color) noexcept override;
+		std::uint32_t GetEntryClipIndex(std::uint32_t a_entryIndex) noexcept override;
+		std::int32_t GetSelectedIndex() noexcept override;
+
+	private:
+		RE::GFxValue topicList;
+		RE::GFxValue entriesA;  // read when it's first needed
+
+		// of the clip last read by GetEntryText, which is the only one ColorEntries asks about until it reads the next one
+		RE::GFxValue textField;
+		RE::GFxValue text;
+		double itemIndex;
+	};
+
+	// the one entry clip SetEntryText draws, as clip 0
+	class GFxEntryClipView final : public ITopicListView
+	{
+	public:
+		GFxEntryClipView(RE::GFxValue a_entryClip, RE::GFxValue a_entryObject) noexcept;
+
+		std::uint32_t GetNumEntryClips() noexcept override;
+		const char* GetEntryText(std::uint32_t a_clipIndex) noexcept override;
+		bool IsEntryNew(std::uint32_t a_clipIndex) noexcept override;
+		void SetEntryColor(std::uint32_t a_clipIndex, std::uint32_t a_color) noexcept override;
+		std::uint32_t GetEntryClipIndex(std::uint32_t a_entryIndex) noexcept override;
+		std::int32_t GetSelectedIndex() noexcept override;
+
+	private:
+		RE::GFxValue entryClip;
+		RE::GFxValue entryObject;
+		RE::GFxValue textField;
+		RE::GFxValue text;
+	};
 
+	// the entries of EntriesA and the subtitle text field, with the strings of the subtitles kept by the dialogue menu movie
+	class GFxSubtitleView final : public ISubtitleView
+	{
+	public:
+		explicit GFxSubtitleView(RE::GFxValue a_subtitleText) noexcept;
+
+		const char* GetEntryText(std::uint32_t a_entryIndex) noexcept override;
+		const char* GetSubtitleText() noexcept override;
+		std::string_view GetResponseText(Dialogue::TopicInfoHandle a_responseInfo) noexcept override;
+		void CreateSubtitle(std::uint32_t a_slot, const char* a_text) noexcept override;
+		void ShowSubtitle(std::uint32_t a_slot) noexcept override;
+		void ApplySubtitleColor() noexcept override;
+
+	private:
+		RE::GFxValue subtitleText;
+		RE::GFxValue text;  // of the last entry or subtitle read, which keeps the returned string alive
+	};
+
+	// colours every entry with a native call for each of them
 	class SetEntryTextFunctionHandler final : public RE::GFxFunctionHandler
 	{
 	public:
 		static void Install(
 			const RE::DialogueMenu* a_dialogueMenu,
 			RE::GFxValue a_topicList,
-			const std::unordered_map<std::string, TopicDisplayData>* a_topicDisplayData) noexcept;
+			const TopicDisplayTable* a_topicDisplayData) noexcept;
 
 		void Call(Params& a_params) override;
 
 	private:
-		const std::unordered_map<std::string, TopicDisplayData>* topicDisplayData;
+		const TopicDisplayTable* topicDisplayData;
+	};
 
-		void colorText(RE::GFxValue a_textField, bool a_topicIsNew) noexcept;
+	// colours all entries with a single native call after the list is drawn
+	class UpdateListFunctionHandler final : public RE::GFxFunctionHandler
+	{
+	public:
+		static void Install(
+			const RE::DialogueMenu* a_dialogueMenu,
+			RE::GFxValue a_topicList,
+			const TopicDisplayTable* a_topicDisplayData) noexcept;
+
+		void Call(Params& a_params) override;
+
+	private:
+		const TopicDisplayTable* topicDisplayData;
 	};
 
 	class ShowDialogueTextFunctionHandler final : public RE::GFxFunctionHandler
@@ -43,9 +134,9 @@ namespace Scaleform
 		static void Install(const RE::DialogueMenu* a_dialogueMenu, RE::GFxValue a_dialogueMenu_mc, RE::GFxValue a_subtitleText) noexcept;
 
 		void Call(Params& a_params) override;
+		void ReleaseMovieValues() noexcept;
 
 	private:
-		RE::GFxValue dialogueMenu_mc;
 		RE::GFxValue subtitleText;
 		RE::GFxValue defaultSubtitleColor;
 	};
@@ -53,24 +144,29 @@ namespace Scaleform
 	class DoSetSelectedIndexFunctionHandler final : public RE::GFxFunctionHandler
 	{
 	public:
+		// a_colorEntries recolours the entries the list redraws when the selection changes, for the batched topic colours
 		static void Install(
 			const RE::DialogueMenu* a_dialogueMenu,
 			RE::GFxValue a_dialogueMenu_mc,
 			RE::GFxValue a_subtitleText,
 			RE::GFxValue a_topicList,
-			const std::unordered_map<std::string, TopicDisplayData>* a_topicDisplayData) noexcept;
+			const TopicDisplayTable* a_topicDisplayData,
+			bool a_colorEntries,
+			bool a_showSubtitles) noexcept;
 
 		void Call(Params& a_params) override;
+		void ReleaseMovieValues() noexcept;
 
 	private:
-		const std::unordered_map<std::string, TopicDisplayData>* topicDisplayData;
+		const TopicDisplayTable* topicDisplayData;
+		bool colorEntries;
+		bool showSubtitles;
 
 		RE::GFxValue dialogueMenu_mc;
 		RE::GFxValue subtitleText;
 		RE::GFxValue topicList;
 	};
 
-	
 	class MoveSelectionUpFunctionHandler final : public RE::GFxFunctionHandler
 	{
 	public:
@@ -79,12 +175,13 @@ namespace Scaleform
 			RE::GFxValue a_dialogueMenu_mc,
 			RE::GFxValue a_subtitleText,
 			RE::GFxValue a_topicList,
-			const std::unordered_map<std::string, TopicDisplayData>* a_topicDisplayData) noexcept;
+			const TopicDisplayTable* a_topicDisplayData) noexcept;
 
 		void Call(Params& a_params) override;
+		void ReleaseMovieValues() noexcept;
 
 	private:
-		const std::unordered_map<std::string, TopicDisplayData>* topicDisplayData;
+		const TopicDisplayTable* topicDisplayData;
 
 		RE::GFxValue dialogueMenu_mc;
 		RE::GFxValue subtitleText;
@@ -99,12 +196,13 @@ namespace Scaleform
 			RE::GFxValue a_dialogueMenu_mc,
 			RE::GFxValue a_subtitleText,
 			RE::GFxValue a_topicList,
-			const std::unordered_map<std::string, TopicDisplayData>* a_topicDisplayData) noexcept;
+			const TopicDisplayTable* a_topicDisplayData) noexcept;
 
 		void Call(Params& a_params) override;
+		void ReleaseMovieValues() noexcept;
 
 	private:
-		const std::unordered_map<std::string, TopicDisplayData>* topicDisplayData;
+		const TopicDisplayTable* topicDisplayData;
 
 		RE::GFxValue dialogueMenu_mc;
 		RE::GFxValue subtitleText;
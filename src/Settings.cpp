@@ -21,76 +21,267 @@ See EXCEPTIONS for additional permissions.
 
 #include "SimpleIni.h"
 
+namespace
+{
+	constexpr auto kIniPath = R"(.\Data\SKSE\Plugins\PredictablePersuasion.ini)";
+
+	std::atomic<std::uint32_t> lastGeneration{ 0 };
+
+	// Serializes reading and publishing snapshots, so a reload can't publish one with an outdated preset after a newer one.
+	std::mutex loadMutex;
+	const TagPreset* gamePreset = nullptr;  // the tags of the game's language, nullptr until Load looked it up
+
+	// the thread of Settings::StartWatching, which is detached and only told to stop
+	std::mutex watcherMutex;
+	std::condition_variable watcherWakeUp;
+	bool isWatching = false;  // guarded by watcherMutex, like hasWatcher
+	bool hasWatcher = false;  // whether the thread still runs, which it checks before it exits
+
+	// the patterns that were the defaults before the language presets, which are replaced by the preset of the game's language
+	constexpr std::array<std::array<std::string_view, 2>, 3> kEnglishTagRegexes{ {
+		{ " \\((Persuade)\\)$"sv, " (\\(Persuade\\))$"sv },
+		{ " \\((Intimidate)\\)$"sv, " (\\(Intimidate\\))$"sv },
+		{ " \\((\\d+ gold)\\)$"sv, " (\\(\\d+ gold\\))$"sv },
+	} };
+
+	std::string_view GetGameLanguage() noexcept
+	{
+		const auto iniSettings = RE::INISettingCollection::GetSingleton();
+		const auto setting = iniSettings ? iniSettings->GetSetting("sLanguage:General") : nullptr;
+		if (setting && setting->GetType() == RE::Setting::Type::kString) {
+			if (const auto language = setting->GetString()) {
+				return language;
+			}
+		}
+		return {};
+	}
+
+	FormatProgram LoadFormat(const CSimpleIniA& a_ini, const char* a_section, const char* a_key, const char* a_default)
+	{
+		const auto format = a_ini.GetValue(a_section, a_key, a_default);
+		try {
+			return FormatProgram(format);
+		} catch (const std::format_error& e) {
+			logger::error("Invalid format string for {}: {}", a_key, e.what());
+			return FormatProgram(a_default);
+		}
+	}
+
+	// Reads the INI file into a new snapshot. It doesn't touch the game, so it can run on any thread.
+	std::shared_ptr<const Settings> Read(const TagPreset& a_preset)
+	{
+		CSimpleIniA ini;
+
+		ini.SetUnicode();
+		ini.SetQuotes();
+		ini.SetSpaces();
+		ini.LoadFile(kIniPath);
+
+		const auto settings = std::make_shared<Settings>();
+		settings->generation = ++lastGeneration;
+		auto& persuadeProfile = settings->profiles[static_cast<std::size_t>(TopicProcessor::SPEECH_CHECK_TYPE::kPersuade)];
+		auto& intimidateProfile = settings->profiles[static_cast<std::size_t>(TopicProcessor::SPEECH_CHECK_TYPE::kIntimidate)];
+		auto& bribeProfile = settings->profiles[static_cast<std::size_t>(TopicProcessor::SPEECH_CHECK_TYPE::kBribe)];
+
+		// [TopicFormats]
+		settings->applyTopicFormatting = ini.GetBoolValue("TopicFormats", "bApplyTopicFormatting", true);
+		persuadeProfile.topicFormat = LoadFormat(ini, "TopicFormats", "sPersuadeTopicFormat", Settings::kDefaultTopicFormats[static_cast<std::size_t>(TopicProcessor::SPEECH_CHECK_TYPE::kPersuade)]);
+		intimidateProfile.topicFormat = LoadFormat(ini, "TopicFormats", "sIntimidateTopicFormat", Settings::kDefaultTopicFormats[static_cast<std::size_t>(TopicProcessor::SPEECH_CHECK_TYPE::kIntimidate)]);
+		bribeProfile.topicFormat = LoadFormat(ini, "TopicFormats", "sBribeTopicFormat", Settings::kDefaultTopicFormats[static_cast<std::size_t>(TopicProcessor::SPEECH_CHECK_TYPE::kBribe)]);
+
+		// [Subtitles]
+		const auto showSubtitlesValue = ini.GetLongValue("Subtitles", "uShowSubtitles", static_cast<long>(Settings::SHOW_SUBTITLES::kForAllSpeechChecks));
+		switch (showSubtitlesValue) {
+		case 0:
+			settings->showSubtitles = Settings::SHOW_SUBTITLES::kNever;
+			break;
+		case 1:
+			settings->showSubtitles = Settings::SHOW_SUBTITLES::kOnlyForNoCheck;
+			break;
+		case 2:
+			settings->showSubtitles = Settings::SHOW_SUBTITLES::kForAllSpeechChecks;
+			break;
+		default:
+			settings->showSubtitles = Settings::SHOW_SUBTITLES::kForAllSpeechChecks;
+			logger::error("Invalid value for uShowSubtitles: {}", showSubtitlesValue);
+		}
+
+		settings->subtitleColor = ini.GetLongValue("Subtitles", "uSubtitleColor", 0xA3A3A3);
+		persuadeProfile.subtitleFormat = LoadFormat(ini, "Subtitles", "sPersuadeSubtitleFormat", Settings::kDefaultSubtitleFormat);
+		intimidateProfile.subtitleFormat = LoadFormat(ini, "Subtitles", "sIntimidateSubtitleFormat", Settings::kDefaultSubtitleFormat);
+		bribeProfile.subtitleFormat = LoadFormat(ini, "Subtitles", "sBribeSubtitleFormat", Settings::kDefaultSubtitleFormat);
+
+		// [CheckResults]
+		settings->checkSuccessText = ini.GetValue("CheckResults", "sSuccessText", "Success");
+		settings->checkFailureText = ini.GetValue("CheckResults", "sFailureText", "Failure");
+		settings->noCheckText = ini.GetValue("CheckResults", "sNoCheckText", "No Check");
+
+		// [SpeechChecks]
+		const auto speechCheckEvaluatorValue = ini.GetLongValue("SpeechChecks", "uSpeechCheckEvaluator", static_cast<long>(Settings::SPEECH_CHECK_EVALUATOR::kEngine));
+		switch (speechCheckEvaluatorValue) {
+		case 0:
+			settings->speechCheckEvaluator = Settings::SPEECH_CHECK_EVALUATOR::kEngine;
+			break;
+		case 1:
+			settings->speechCheckEvaluator = Settings::SPEECH_CHECK_EVALUATOR::kNative;
+			break;
+		case 2:
+			settings->speechCheckEvaluator = Settings::SPEECH_CHECK_EVALUATOR::kDifferential;
+			break;
+		default:
+			settings->speechCheckEvaluator = Settings::SPEECH_CHECK_EVALUATOR::kEngine;
+			logger::error("Invalid value for uSpeechCheckEvaluator: {}", speechCheckEvaluatorValue);
+		}
+
+		// [TagRegex]
+		const auto preset = &a_preset;
+
+		const std::array tagRegexKeys{ "sPersuadeTagRegex", "sIntimidateTagRegex", "sBribeTagRegex" };
+		std::array<std::string, 3> tagRegexes;
+		auto usesCustomTagRegex = false;
+		for (std::size_t i = 0; i < tagRegexes.size(); ++i) {
+			tagRegexes[i] = ini.GetValue("TagRegex", tagRegexKeys[i], "");
+			if (tagRegexes[i].empty() || std::ranges::find(kEnglishTagRegexes[i], tagRegexes[i]) != kEnglishTagRegexes[i].end()) {
+				tagRegexes[i] = preset->GetPattern(static_cast<TopicProcessor::SPEECH_CHECK_TYPE>(i));
+			} else {
+				usesCustomTagRegex = true;
+			}
+		}
+
+		// the runtime matcher is only needed for custom patterns, the presets are matched by comparing suffixes
+		if (usesCustomTagRegex) {
+			try {
+				const std::array<std::string_view, 3> tagPatterns{ tagRegexes[0], tagRegexes[1], tagRegexes[2] };
+				settings->tagMatcher.Compile(tagPatterns);
+			} catch (const std::invalid_argument& e) {
+				settings->tagPreset = preset;
+				logger::error("Failed to compile regex: {}", e.what());
+			}
+		} else {
+			settings->tagPreset = preset;
+		}
+
+		// [TagPlaceholders]
+		persuadeProfile.tagPlaceholder = ini.GetValue("TagPlaceholders", "sPersuadeTagPlaceholder", "Persuade");
+		intimidateProfile.tagPlaceholder = ini.GetValue("TagPlaceholders", "sIntimidateTagPlaceholder", "Intimidate");
+		bribeProfile.tagPlaceholder = ini.GetValue("TagPlaceholders", "sBribeTagPlaceholder", "gold");
+
+		// [TopicColors]
+		settings->applyTopicColors = ini.GetBoolValue("TopicColors", "bApplyTopicColors", true);
+		settings->batchTopicColors = ini.GetBoolValue("TopicColors", "bBatchTopicColors", false);
+		settings->successColor = ini.GetLongValue("TopicColors", "uSuccessColor", 0x00FF00);
+		settings->failureColorNew = ini.GetLongValue("TopicColors", "uFailureColorNew", 0xFF0000);
+		settings->failureColorOld = ini.GetLongValue("TopicColors", "uFailureColorOld", 0x600000);
+		settings->noCheckColorNew = ini.GetLongValue("TopicColors", "uNoCheckColorNew", 0xFFFF00);
+		settings->noCheckColorOld = ini.GetLongValue("TopicColors", "uNoCheckColorOld", 0x606000);
+		settings->regularColorNew = ini.GetLongValue("TopicColors", "uRegularColorNew", 0xFFFFFF);
+		settings->regularColorOld = ini.GetLongValue("TopicColors", "uRegularColorOld", 0x606060);
+
+		// [Prefetch]
+		settings->prefetchTopics = ini.GetBoolValue("Prefetch", "bPrefetchTopics", true);
+		settings->prefetchBudgetMicroseconds = ini.GetLongValue("Prefetch", "uPrefetchBudget", 500);
+
+		// [Profiling]
+		settings->enableProfiling = ini.GetBoolValue("Profiling", "bEnableProfiling", false);
+		settings->recordSessions = ini.GetBoolValue("Profiling", "bRecordSessions", false);
+
+		// [Requirements]
+		if (ini.GetBoolValue("Requirements", "bRequirePerk", false)) {
+			const auto requiredPerkFormID = static_cast<std::uint32_t>(ini.GetLongValue("Requirements", "uRequiredPerkFormID", 0x001090A2));
+			settings->requirements.emplace_back(Requirement::TYPE::kPerk, std::string(), requiredPerkFormID, std::string(), Dialogue::OPCODE::kEqualTo, 0.0F);
+		}
+		constexpr std::array<std::pair<const char*, Requirement::TYPE>, 4> requirementKeys{ {
+			{ "sRequiredPerks", Requirement::TYPE::kPerk },
+			{ "sRequiredActorValues", Requirement::TYPE::kActorValue },
+			{ "sRequiredGlobals", Requirement::TYPE::kGlobal },
+			{ "sRequiredQuestStages", Requirement::TYPE::kQuestStage },
+		} };
+		for (const auto& [key, type] : requirementKeys) {
+			try {
+				std::ranges::move(RequirementSet::Parse(type, ini.GetValue("Requirements", key, "")), std::back_inserter(settings->requirements));
+			} catch (const std::invalid_argument& e) {
+				settings->hasInvalidRequirements = true;
+				logger::error("Invalid requirement in {}: {}", key, e.what());
+			}
+		}
+
+		// [HotReload]
+		settings->reloadOnChange = ini.GetBoolValue("HotReload", "bReloadOnChange", true);
+
+		const auto showsPredictedResponse = [&](const FormatProgram Settings::CheckTypeProfile::* a_format) {
+			return std::ranges::any_of(settings->profiles, [&](const Settings::CheckTypeProfile& a_profile) { return (a_profile.*a_format).UsesArgument(4); });
+		};
+		settings->showsPredictedResponse = (settings->applyTopicFormatting && showsPredictedResponse(&Settings::CheckTypeProfile::topicFormat)) ||
+		                                   (settings->showSubtitles != Settings::SHOW_SUBTITLES::kNever && showsPredictedResponse(&Settings::CheckTypeProfile::subtitleFormat));
+
+		return settings;
+	}
+}
+
 void Settings::Load()
 {
-	CSimpleIniA ini;
-
-	ini.SetUnicode();
-	ini.SetQuotes();
-	ini.SetSpaces();
-	ini.LoadFile(R"(.\Data\SKSE\Plugins\PredictablePersuasion.ini)");
-
-	// [TopicFormats]
-	applyTopicFormatting = ini.GetBoolValue("TopicFormats", "bApplyTopicFormatting", true);
-	persuadeTopicFormat = ini.GetValue("TopicFormats", "sPersuadeTopicFormat", "{0} ({1} Level {3}");
-	intimidateTopicFormat = ini.GetValue("TopicFormats", "sIntimidateTopicFormat", "{0} ({1})");
-	bribeTopicFormat = ini.GetValue("TopicFormats", "sBribeTopicFormat", "{0} (Bribe with {1})");
-
-	// [Subtitles]
-	const auto showSubtitlesValue = ini.GetLongValue("Subtitles", "uShowSubtitles", static_cast<long>(SHOW_SUBTITLES::kForAllSpeechChecks));
-	switch (showSubtitlesValue) {
-	case 0:
-		showSubtitles = SHOW_SUBTITLES::kNever;
-		break;
-	case 1:
-		showSubtitles = SHOW_SUBTITLES::kOnlyForNoCheck;
-		break;
-	case 2:
-		showSubtitles = SHOW_SUBTITLES::kForAllSpeechChecks;
-		break;
-	default:
-		showSubtitles = SHOW_SUBTITLES::kForAllSpeechChecks;
-		logger::error("Invalid value for uShowSubtitles: {}", showSubtitlesValue);
+	// the game's INI settings are only loaded after the plugins, so the first Load before kDataLoaded uses English
+	const auto language = GetGameLanguage();
+	auto preset = TagPresets::Find(language);
+	if (!preset) {
+		if (!language.empty()) {
+			logger::warn("There are no built-in tags for sLanguage {}, using the English tags", language);
+		}
+		preset = &TagPresets::GetEnglish();
 	}
 
-	subtitleColor = ini.GetLongValue("Subtitles", "uSubtitleColor", 0xA3A3A3);
-	persuadeSubtitleFormat = ini.GetValue("Subtitles", "sPersuadeSubtitleFormat", "{4}");
-	intimidateSubtitleFormat = ini.GetValue("Subtitles", "sIntimidateSubtitleFormat", "{4}");
-	bribeSubtitleFormat = ini.GetValue("Subtitles", "sBribeSubtitleFormat", "{4}");
-
-	// [CheckResults]
-	checkSuccessText = ini.GetValue("CheckResults", "sSuccessText", "Success");
-	checkFailureText = ini.GetValue("CheckResults", "sFailureText", "Failure");
-	noCheckText = ini.GetValue("CheckResults", "sNoCheckText", "No Check");
-
-	// [TagRegex]
-	try {
-		persuadeTagRegex = ini.GetValue("TagRegex", "sPersuadeTagRegex", " (\\(Persuade\\))$");
-		intimidateTagRegex = ini.GetValue("TagRegex", "sIntimidateTagRegex", " (\\(Intimidate\\))$");
-		bribeTagRegex = ini.GetValue("TagRegex", "sBribeTagRegex", " (\\(\\d+ gold\\))$");
-	} catch (const std::regex_error& e) {
-		persuadeTagRegex = " (\\(Persuade\\))$";
-		intimidateTagRegex = " (\\(Intimidate\\))$";
-		bribeTagRegex = " (\\(\\d+ gold\\))$";
-		logger::error("Failed to compile regex: {}", e.what());
+	std::scoped_lock lock(loadMutex);
+	gamePreset = preset;
+	Publish(Read(*preset));
+}
+
+void Settings::StartWatching()
+{
+	std::scoped_lock lock(watcherMutex);
+	isWatching = true;
+	if (hasWatcher) {
+		return;
 	}
 
-	// [TagPlaceholders]
-	persuadeTagPlaceholder = ini.GetValue("TagPlaceholders", "sPersuadeTagPlaceholder", "Persuade");
-	intimidateTagPlaceholder = ini.GetValue("TagPlaceholders", "sIntimidateTagPlaceholder", "Intimidate");
-	bribeTagPlaceholder = ini.GetValue("TagPlaceholders", "sBribeTagPlaceholder", "gold");
-
-	// [TopicColors]
-	applyTopicColors = ini.GetBoolValue("TopicColors", "bApplyTopicColors", true);
-	successColor = ini.GetLongValue("TopicColors", "uSuccessColor", 0x00FF00);
-	failureColorNew = ini.GetLongValue("TopicColors", "uFailureColorNew", 0xFF0000);
-	failureColorOld = ini.GetLongValue("TopicColors", "uFailureColorOld", 0x600000);
-	noCheckColorNew = ini.GetLongValue("TopicColors", "uNoCheckColorNew", 0xFFFF00);
-	noCheckColorOld = ini.GetLongValue("TopicColors", "uNoCheckColorOld", 0x606000);
-	regularColorNew = ini.GetLongValue("TopicColors", "uRegularColorNew", 0xFFFFFF);
-	regularColorOld = ini.GetLongValue("TopicColors", "uRegularColorOld", 0x606060);
-
-	// [Requirements]
-	requirePerk = ini.GetBoolValue("Requirements", "bRequirePerk", false);
-	requiredPerkFormID = ini.GetLongValue("Requirements", "uRequiredPerkFormID", 0x001090A2);
+	// Polls instead of using ReadDirectoryChangesW, which would need a handle to the whole folder. The snapshot is read and published
+	// on this thread, Requirements looks up its forms on the main thread the first time it's used. The thread is detached, so nothing
+	// joins it while the plugin is unloaded, and the process terminates it on exit like the other threads of the game.
+	hasWatcher = true;
+	std::thread([] {
+		std::error_code error;
+		auto lastWriteTime = std::filesystem::last_write_time(kIniPath, error);
+		std::unique_lock lock(watcherMutex);
+		// StopWatching wakes it up, so it doesn't wait out the polling interval
+		while (!watcherWakeUp.wait_for(lock, 1s, [] { return !isWatching; })) {
+			const auto writeTime = std::filesystem::last_write_time(kIniPath, error);
+			if (error || writeTime == lastWriteTime) {
+				continue;
+			}
+
+			lastWriteTime = writeTime;
+			lock.unlock();
+			bool reloadOnChange;
+			{
+				std::scoped_lock loadLock(loadMutex);
+				const auto settings = Read(gamePreset ? *gamePreset : TagPresets::GetEnglish());
+				reloadOnChange = settings->reloadOnChange;
+				logger::info("Reloaded {} (generation {})", kIniPath, settings->generation);
+				Publish(settings);
+			}
+			lock.lock();
+			if (!reloadOnChange) {
+				isWatching = false;
+			}
+		}
+		hasWatcher = false;
+	}).detach();
+}
+
+void Settings::StopWatching()
+{
+	{
+		std::scoped_lock lock(watcherMutex);
+		isWatching = false;
+	}
+	watcherWakeUp.notify_all();
 }
\ No newline at end of file
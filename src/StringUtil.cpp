@@ -1,35 +0,0 @@
-/*
-Copyright (C) 2025 Jonathan Feenstra
-
-This program is free software: you can redistribute it and/or modify
-it under the terms of the GNU General Public License as published by
-the Free Software Foundation, either version 3 of the License, or
-(at your option) any later version.
-
-This program is distributed in the hope that it will be useful,
-but WITHOUT ANY WARRANTY; without even the implied warranty of
-MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-GNU General Public License for more details.
-
-You should have received a copy of the GNU General Public License
-along with this program.  If not, see <https://www.gnu.org/licenses/>.
-
-See EXCEPTIONS for additional permissions.
-*/
-
-#include "StringUtil.h"
-
-namespace StringUtil
-{
-	bool LowerCaseContains(const std::string_view a_hayStack, const std::string_view a_lowerCaseNeedle) noexcept
-	{
-		return std::search(
-				   a_hayStack.begin(),
-				   a_hayStack.end(),
-				   a_lowerCaseNeedle.begin(),
-				   a_lowerCaseNeedle.end(),
-				   [](char a, char b) {
-					   return std::tolower(a) == b;
-				   }) != a_hayStack.end();
-	}
-}
\ No newline at end of file
@@ -1,6 +0,0 @@
-#pragma once
-
-namespace StringUtil
-{
-	bool LowerCaseContains(const std::string_view a_hayStack, const std::string_view a_lowerCaseNeedle) noexcept;
-}
\ No newline at end of file
@@ -0,0 +1,104 @@
+/*
+Copyright (C) 2025 Jonathan Feenstra
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+See EXCEPTIONS for additional permissions.
+*/
+
+#include "TopicIndex.h"
+
+#include "CommonLibEngine.h"
+#include "HashUtil.h"
+
+namespace TopicIndex
+{
+	namespace
+	{
+		SpeechCheckIndex index;
+
+		// the plugins in load order with their sizes and modification times, so the index file is rebuilt when any of them changes
+		std::uint64_t GetLoadOrderHash() noexcept
+		{
+			std::uint64_t hash = 0;
+			for (const auto file : RE::TESDataHandler::GetSingleton()->files) {
+				if (!file)
+					continue;
+				const std::string_view fileName(file->fileName);
+				const auto path = std::filesystem::path(R"(.\Data)") / fileName;
+				std::error_code error;
+				const auto fileSize = std::filesystem::file_size(path, error);
+				const auto writeTime = std::filesystem::last_write_time(path, error).time_since_epoch().count();
+				hash = HashUtil::Hash(fileName, hash);
+				hash = HashUtil::Mix(hash ^ static_cast<std::uint64_t>(fileSize));
+				hash = HashUtil::Mix(hash ^ static_cast<std::uint64_t>(writeTime));
+			}
+			return hash;
+		}
+
+		std::optional<std::filesystem::path> GetIndexPath() noexcept
+		{
+			// next to the log, because the Data folder may not be writable
+			if (auto path = logger::log_directory()) {
+				*path /= "PredictablePersuasion.index";
+				return path;
+			}
+			return std::nullopt;
+		}
+
+		void Scan() noexcept
+		{
+			const auto& topics = RE::TESDataHandler::GetSingleton()->GetFormArray<RE::TESTopic>();
+			std::vector<SpeechCheckIndex::Entry> entries(topics.size());
+			// only reads static data, so the speaker isn't needed
+			const CommonLibEngine engine({});
+			const auto dialogueEngine = engine.GetEngine();
+
+			// the topics are only read and independent of each other, so large load orders are described on all cores
+			std::for_each(std::execution::par, entries.begin(), entries.end(), [&](SpeechCheckIndex::Entry& a_entry) {
+				if (const auto topic = topics[static_cast<std::uint32_t>(&a_entry - entries.data())]) {
+					a_entry.formID = topic->GetFormID();
+					a_entry.descriptor = TopicProcessor::DescribeTopic(dialogueEngine, CommonLibEngine::ToHandle(topic));
+				}
+			});
+			index.Build(entries);
+		}
+	}
+
+	void Build() noexcept
+	{
+		const auto start = std::chrono::steady_clock::now();
+		const auto loadOrderHash = GetLoadOrderHash();
+		const auto path = GetIndexPath();
+		const auto loaded = path && index.Load(*path, loadOrderHash);
+		if (!loaded) {
+			Scan();
+			if (path && !index.Save(*path, loadOrderHash)) {
+				logger::warn("Failed to save the speech check index to {}", path->string());
+			}
+		}
+
+		const std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+		logger::info(
+			"{} {} topics with speech checks or bribe costs in {:.1f} ms",
+			loaded ? "Mapped the index of" : "Indexed",
+			index.Size(),
+			duration.count());
+	}
+
+	const SpeechCheckIndex& Get() noexcept
+	{
+		return index;
+	}
+}
\ No newline at end of file
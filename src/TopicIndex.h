@@ -0,0 +1,11 @@
+#pragma once
+
+#include "SpeechCheckIndex.h"
+
+namespace TopicIndex
+{
+	// Describes the speech checks of all topics after the data is loaded.
+	void Build() noexcept;
+
+	const SpeechCheckIndex& Get() noexcept;
+}
\ No newline at end of file
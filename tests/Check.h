@@ -0,0 +1,37 @@
+#pragma once
+
+#include <iostream>
+
+// A minimal check harness for the tests of the core library, which keeps them free of dependencies besides the standard library.
+// Failed checks are printed and counted, so a test reports all of them, and main returns Check::Result().
+namespace Check
+{
+	inline std::uint32_t numFailures = 0;
+
+	inline void Fail(const char* a_expression, const char* a_file, const int a_line)
+	{
+		std::cerr << a_file << ':' << a_line << ": check failed: " << a_expression << '\n';
+		++numFailures;
+	}
+
+	template <class Actual, class Expected>
+	void Equal(const Actual& a_actual, const Expected& a_expected, const char* a_expression, const char* a_file, const int a_line)
+	{
+		if (!(a_actual == a_expected)) {
+			std::cerr << a_file << ':' << a_line << ": check failed: " << a_expression << " (" << a_actual << " != " << a_expected << ")\n";
+			++numFailures;
+		}
+	}
+
+	inline int Result()
+	{
+		if (numFailures > 0) {
+			std::cerr << numFailures << " checks failed\n";
+			return EXIT_FAILURE;
+		}
+		return EXIT_SUCCESS;
+	}
+}
+
+#define CHECK(a_condition) ((a_condition) ? static_cast<void>(0) : Check::Fail(#a_condition, __FILE__, __LINE__))
+#define CHECK_EQUAL(a_actual, a_expected) Check::Equal(a_actual, a_expected, #a_actual " == " #a_expected, __FILE__, __LINE__)
\ No newline at end of file
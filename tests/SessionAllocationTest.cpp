@@ -0,0 +1,194 @@
+/*
+Copyright (C) 2025 Jonathan Feenstra
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+See EXCEPTIONS for additional permissions.
+*/
+
+// Counts the calls of the global operator new during simulated dialogue menu sessions, to check that once the SessionArena
+// and the containers that outlive the sessions have grown to the size of a session, rebuilding the display table, colouring the
+// list and showing subtitles don't allocate. Only topics that are already cached are shown: processing a topic on a cache miss
+// allocates the strings of the cached result, which outlives the session, so it's counted but not checked.
+
+#include "Check.h"
+#include "MemoryEngine.h"
+#include "MemorySubtitleView.h"
+#include "MemoryTopicListView.h"
+#include "SessionArena.h"
+#include "Settings.h"
+#include "TagPresets.h"
+#include "TopicListColors.h"
+#include "TopicProcessor.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	std::atomic<std::uint64_t> numAllocations{ 0 };
+}
+
+void* operator new(const std::size_t a_size)
+{
+	++numAllocations;
+	if (const auto memory = std::malloc(a_size > 0 ? a_size : 1)) {
+		return memory;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new(const std::size_t a_size, const std::align_val_t a_alignment)
+{
+	++numAllocations;
+	const auto alignment = static_cast<std::size_t>(a_alignment);
+	if (const auto memory = std::aligned_alloc(alignment, (std::max<std::size_t>(a_size, 1) + alignment - 1) / alignment * alignment)) {
+		return memory;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* a_memory) noexcept { std::free(a_memory); }
+void operator delete(void* a_memory, std::size_t) noexcept { std::free(a_memory); }
+void operator delete(void* a_memory, std::align_val_t) noexcept { std::free(a_memory); }
+void operator delete(void* a_memory, std::size_t, std::align_val_t) noexcept { std::free(a_memory); }
+
+namespace
+{
+	using Scaleform::MemorySubtitleView;
+	using Scaleform::MemoryTopicListView;
+	using Scaleform::SubtitlePresenter;
+	using Scaleform::TopicDisplayTable;
+
+	constexpr std::uint32_t kNumTopics = 40;
+
+	std::shared_ptr<const Settings> MakeSettings()
+	{
+		const auto settings = std::make_shared<Settings>();
+		settings->generation = 1;
+		settings->applyTopicFormatting = true;
+		settings->applyTopicColors = true;
+		settings->showSubtitles = Settings::SHOW_SUBTITLES::kForAllSpeechChecks;
+		settings->showsPredictedResponse = true;
+		settings->tagPreset = &TagPresets::GetEnglish();
+		for (auto& profile : settings->profiles) {
+			profile = { FormatProgram("{0} [{2}]"), FormatProgram("{0}, said with a subtitle long enough for the heap: {4}"), "Persuade" };
+		}
+		settings->checkSuccessText = "Success";
+		settings->checkFailureText = "Failure";
+		settings->noCheckText = "No Check";
+		settings->speechCheckEvaluator = Settings::SPEECH_CHECK_EVALUATOR::kEngine;
+		return settings;
+	}
+
+	// a topic in the topic cache of the plugin, which keeps the text the topic was processed from for its deferred subtitle
+	struct CachedTopic final
+	{
+		std::string rawTopicText;
+		TopicProcessor::ProcessedTopic processedTopic;
+	};
+
+	// Persuasion checks whose results are cached before the sessions, as the topic cache of the plugin outlives them.
+	// Each one has a response that's longer than a small string, so resolving its subtitle would allocate if the table didn't keep it in the arena.
+	std::vector<CachedTopic> ProcessTopics(MemoryEngine& a_engine, const Settings& a_settings)
+	{
+		std::vector<std::pair<Dialogue::TopicHandle, std::string>> topics;
+		for (std::uint32_t i = 0; i < kNumTopics; ++i) {
+			Dialogue::ConditionData speechCheck{};
+			speechCheck.function = Dialogue::CONDITION_FUNCTION::kGetActorValue;
+			speechCheck.opCode = Dialogue::OPCODE::kGreaterThanOrEqualTo;
+			speechCheck.isSpeech = true;
+			speechCheck.comparisonValue = 50.0F;
+
+			MemoryEngine::TopicInfo check{ {}, false, "A response that's long enough to need the heap, number " + std::to_string(i) };
+			check.conditions.push_back({ speechCheck, i % 2 == 0, nullptr });
+			const auto topic = a_engine.AddTopic({ "Topic " + std::to_string(i), { check, MemoryEngine::TopicInfo{ {}, true, "The response if the check fails, number " + std::to_string(i) } } });
+			topics.emplace_back(topic, "I'm sure we can come to an agreement about number " + std::to_string(i) + " (Persuade)");
+		}
+
+		std::vector<CachedTopic> cachedTopics;
+		cachedTopics.reserve(topics.size());
+		const auto allocationsBefore = numAllocations.load();
+		for (auto& [topic, topicText] : topics) {
+			auto processedTopic = TopicProcessor::ProcessTopic(a_engine.GetEngine(), topic, nullptr, topicText, a_settings);
+			cachedTopics.push_back({ std::move(topicText), std::move(processedTopic) });
+		}
+		std::cout << "processing " << kNumTopics << " topics that aren't cached: " << numAllocations.load() - allocationsBefore << " global allocations\n";
+
+		for (const auto& cachedTopic : cachedTopics) {
+			CHECK(cachedTopic.processedTopic.displayData.has_value());
+		}
+		return cachedTopics;
+	}
+
+	struct Session final
+	{
+		SessionArena arena;
+		TopicDisplayTable table{ &arena };
+		MemoryTopicListView listView;
+		MemorySubtitleView subtitleView;
+		SubtitlePresenter presenter;
+	};
+
+	// a kShow and two kUpdates, each of which rebuilds the display data, colours the list and shows the subtitles of a third of it
+	void RunSession(Session& a_session, const std::vector<CachedTopic>& a_cachedTopics)
+	{
+		a_session.presenter.Reset();
+		for (std::uint32_t update = 0; update < 3; ++update) {
+			a_session.table.Clear();
+			for (const auto& [rawTopicText, processedTopic] : a_cachedTopics) {
+				a_session.table.Insert(processedTopic.topicText, *processedTopic.displayData, rawTopicText);
+			}
+			a_session.table.Build();
+
+			CHECK_EQUAL(Scaleform::ColorEntries(a_session.listView, a_session.table), kNumTopics);
+			for (std::uint32_t entryIndex = 0; entryIndex < kNumTopics; entryIndex += 3) {
+				a_session.presenter.Show(a_session.subtitleView, a_session.table, entryIndex);
+			}
+		}
+		a_session.table.Release();
+		a_session.arena.Reset();
+		a_session.presenter.Reset();
+	}
+}
+
+int main()
+{
+	const auto settings = MakeSettings();
+	MemoryEngine engine;
+	const auto cachedTopics = ProcessTopics(engine, *settings);
+
+	// the movie shows the processed topics
+	Session session;
+	session.subtitleView.responseTexts = &engine;
+	for (const auto& cachedTopic : cachedTopics) {
+		session.listView.clips.push_back({ cachedTopic.processedTopic.topicText, true, 0xFFFFFF });
+		session.subtitleView.entries.push_back(cachedTopic.processedTopic.topicText);
+	}
+
+	// The first session grows the arena and the containers of the views and the presenter. The sessions only rebuild the table
+	// from the processed topics, as the dialogue menu does for the topics it finds in the cache.
+	RunSession(session, cachedTopics);
+	CHECK(session.subtitleView.subtitle.ends_with("subtitle long enough for the heap: The response if the check fails, number 39"));
+
+	const auto allocationsBefore = numAllocations.load();
+	for (std::uint32_t i = 0; i < 100; ++i) {
+		RunSession(session, cachedTopics);
+	}
+	const auto allocations = numAllocations.load() - allocationsBefore;
+	std::cout << "100 sessions after the first one: " << allocations << " global allocations, arena of " << session.arena.GetNumBlocks() << " blocks and "
+			  << session.arena.GetCapacity() << " bytes\n";
+	CHECK_EQUAL(allocations, 0U);
+	return Check::Result();
+}
\ No newline at end of file
@@ -0,0 +1,158 @@
+/*
+Copyright (C) 2025 Jonathan Feenstra
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+See EXCEPTIONS for additional permissions.
+*/
+
+// Fuzzes the SIMD kernels of StringUtil::LowerCaseContains against the scalar one and the std::search it replaced,
+// and the last character filter of TagMatcher against matching without it.
+
+#include "Check.h"
+#include "StringUtil.h"
+#include "TagMatcher.h"
+
+#include <random>
+
+namespace
+{
+	using StringUtil::ISA;
+
+	// the search of the plugin before the kernels
+	bool SearchLowerCase(const std::string_view a_hayStack, const std::string_view a_lowerCaseNeedle)
+	{
+		return std::search(a_hayStack.begin(), a_hayStack.end(), a_lowerCaseNeedle.begin(), a_lowerCaseNeedle.end(), [](const char a, const char b) {
+			return static_cast<char>(std::tolower(static_cast<unsigned char>(a))) == b;
+		}) != a_hayStack.end();
+	}
+
+	std::vector<ISA> GetSupportedISAs()
+	{
+		std::vector<ISA> isas;
+		for (const auto isa : { ISA::kScalar, ISA::kSSE2, ISA::kAVX2 }) {
+			if (isa <= StringUtil::GetSupportedISA()) {
+				isas.push_back(isa);
+			}
+		}
+		return isas;
+	}
+
+	void CheckAllISAs(const std::string_view a_hayStack, const std::string_view a_lowerCaseNeedle)
+	{
+		const auto expected = SearchLowerCase(a_hayStack, a_lowerCaseNeedle);
+		for (const auto isa : GetSupportedISAs()) {
+			if (StringUtil::LowerCaseContains(a_hayStack, a_lowerCaseNeedle, isa) != expected) {
+				std::cerr << "ISA " << static_cast<int>(isa) << ": \"" << a_hayStack << "\" contains \"" << a_lowerCaseNeedle << "\" should be " << expected << '\n';
+				CHECK(!"the kernel differs from std::search");
+			}
+		}
+		CHECK_EQUAL(StringUtil::LowerCaseContains(a_hayStack, a_lowerCaseNeedle), expected);
+	}
+
+	// the needle at every offset around the block sizes of the kernels, where they switch to the padded copy of the last block
+	void TestBlockBoundaries()
+	{
+		constexpr std::string_view needle = "<bribecost>";
+		for (std::size_t length = needle.size(); length <= 100; ++length) {
+			for (std::size_t offset = 0; offset + needle.size() <= length; ++offset) {
+				std::string hayStack(length, 'x');
+				hayStack.replace(offset, needle.size(), "<BribeCost>");
+				CheckAllISAs(hayStack, needle);
+				// only the first and last character match
+				hayStack[offset + needle.size() / 2] = '#';
+				CheckAllISAs(hayStack, needle);
+			}
+		}
+	}
+
+	// Random texts over an alphabet of letters and the characters next to them in ASCII, which must not be folded,
+	// and bytes above 0x7F, which std::tolower doesn't fold in the "C" locale either.
+	void TestRandomTexts()
+	{
+		constexpr std::string_view alphabet = "aAbBzZ@[`{<> \x80\xC1\xE1\xFF";
+		std::mt19937 random(7);
+		const auto randomChar = [&] { return alphabet[random() % alphabet.size()]; };
+		for (std::uint32_t i = 0; i < 200'000; ++i) {
+			std::string hayStack(random() % 80, ' ');
+			std::ranges::generate(hayStack, randomChar);
+			std::string needle(random() % 12, ' ');
+			for (auto& c : needle) {
+				c = randomChar();
+				if (c >= 'A' && c <= 'Z') {
+					c |= 0x20;
+				}
+			}
+			// a third of the texts contain the needle, in mixed case
+			if (random() % 3 == 0 && needle.size() <= hayStack.size()) {
+				const auto offset = random() % (hayStack.size() - needle.size() + 1);
+				for (std::size_t j = 0; j < needle.size(); ++j) {
+					hayStack[offset + j] = random() % 2 && needle[j] >= 'a' && needle[j] <= 'z' ? static_cast<char>(needle[j] - 0x20) : needle[j];
+				}
+			}
+			CheckAllISAs(hayStack, needle);
+		}
+	}
+
+	void TestEdgeCases()
+	{
+		CheckAllISAs("", "");
+		CheckAllISAs("abc", "");
+		CheckAllISAs("", "a");
+		CheckAllISAs("ab", "abc");
+		CheckAllISAs("A", "a");
+		CheckAllISAs("a", "A");  // the needle must be lower case, so this never matches
+		CheckAllISAs(std::string_view("\0a\0", 3), std::string_view("a\0", 2));
+	}
+
+	// Every pattern ends with $ and can't match an empty text, so MatchAll rejects texts by their last character. A fourth pattern
+	// that matches an empty text turns the filter off without changing the matches of the others, which must be the same with and without it.
+	void TestTagMatcherFilter()
+	{
+		constexpr std::array<std::string_view, 3> patterns{ " (\\(Persuade\\))$", " (\\(Intimidate\\))$", " (\\(\\d+ gold\\))$" };
+		constexpr std::array<std::string_view, 4> unfilteredPatterns{ patterns[0], patterns[1], patterns[2], "x?$" };
+		TagMatcher filtered;
+		filtered.Compile(patterns);
+		TagMatcher unfiltered;
+		unfiltered.Compile(unfilteredPatterns);
+
+		constexpr std::array<std::string_view, 8> endings{ " (Persuade)", " (Intimidate)", " (100 gold)", " (Persuade", " (gold)", "(Persuade)", ")", "" };
+		constexpr std::string_view alphabet = "ab (PersuadeIntimdgol)0123456789\x80\xFF";
+		std::mt19937 random(11);
+		for (std::uint32_t i = 0; i < 100'000; ++i) {
+			std::string text(random() % 24, ' ');
+			std::ranges::generate(text, [&] { return alphabet[random() % alphabet.size()]; });
+			text += endings[random() % endings.size()];
+			const auto expected = unfiltered.MatchAll(text);
+			const auto actual = filtered.MatchAll(text);
+			for (std::size_t j = 0; j < patterns.size(); ++j) {
+				if (actual[j].matched != expected[j].matched || actual[j].start != expected[j].start || actual[j].groupStart != expected[j].groupStart ||
+					actual[j].groupEnd != expected[j].groupEnd) {
+					std::cerr << "Pattern " << j << " matches \"" << text << "\" differently with the filter\n";
+					CHECK(!"the filter changed a match");
+				}
+			}
+		}
+	}
+}
+
+int main()
+{
+	std::cout << "Supported ISA: " << static_cast<int>(StringUtil::GetSupportedISA()) << '\n';
+	TestEdgeCases();
+	TestBlockBoundaries();
+	TestRandomTexts();
+	TestTagMatcherFilter();
+	return Check::Result();
+}
\ No newline at end of file
@@ -0,0 +1,171 @@
+/*
+Copyright (C) 2025 Jonathan Feenstra
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+See EXCEPTIONS for additional permissions.
+*/
+
+// Counts the calls SubtitlePresenter makes into a movie while the player scrolls through a dialogue list,
+// to check that the subtitle strings are created in the movie once per entry instead of once per highlight.
+
+#include "Check.h"
+#include "MemoryEngine.h"
+#include "MemorySubtitleView.h"
+#include "SessionArena.h"
+
+namespace
+{
+	using Scaleform::MemorySubtitleView;
+	using Scaleform::SubtitlePresenter;
+	using Scaleform::TopicDisplayData;
+	using Scaleform::TopicDisplayTable;
+
+	constexpr std::uint32_t kNumEntries = 8;
+
+	std::string GetTopicText(const std::uint32_t a_index)
+	{
+		return "I'm sure we can come to an agreement about number " + std::to_string(a_index) + " (Persuade)";
+	}
+
+	// every entry of the list has a subtitle, except the last one
+	void FillTable(TopicDisplayTable& a_table)
+	{
+		a_table.Clear();
+		for (std::uint32_t i = 0; i < kNumEntries; ++i) {
+			a_table.Insert(GetTopicText(i), TopicDisplayData{ 0xFFFFFF, 0xA0A0A0, i + 1 < kNumEntries ? "Subtitle " + std::to_string(i) : "", std::nullopt });
+		}
+		a_table.Build();
+	}
+
+	// scrolls down and up through the list a_numPasses times, skipping the entry without a subtitle
+	std::uint32_t Scroll(SubtitlePresenter& a_presenter, MemorySubtitleView& a_view, const TopicDisplayTable& a_table, const std::uint32_t a_numPasses)
+	{
+		std::uint32_t numHighlights = 0;
+		for (std::uint32_t pass = 0; pass < a_numPasses; ++pass) {
+			for (std::uint32_t step = 0; step + 1 < kNumEntries; ++step) {
+				const auto entryIndex = pass % 2 == 0 ? step : kNumEntries - 2 - step;
+				a_presenter.Show(a_view, a_table, entryIndex);
+				CHECK_EQUAL(a_view.subtitle, "Subtitle " + std::to_string(entryIndex));
+				++numHighlights;
+			}
+		}
+		return numHighlights;
+	}
+
+	void TestScrolling()
+	{
+		SessionArena arena;
+		TopicDisplayTable table(&arena);
+		FillTable(table);
+		MemorySubtitleView view;
+		for (std::uint32_t i = 0; i < kNumEntries; ++i) {
+			view.entries.push_back(GetTopicText(i));
+		}
+
+		SubtitlePresenter presenter;
+		const auto numHighlights = Scroll(presenter, view, table, 10);
+		CHECK_EQUAL(numHighlights, 70U);
+		// every highlight shows its subtitle, but only the first highlight of an entry reads its text and creates its string
+		CHECK_EQUAL(view.callCounts.setText, numHighlights);
+		CHECK_EQUAL(view.callCounts.createString, kNumEntries - 1);
+		CHECK_EQUAL(view.callCounts.getEntryText, kNumEntries - 1);
+		CHECK_EQUAL(view.callCounts.setTextColor, 1U);
+		CHECK_EQUAL(view.callCounts.getSubtitleText, 0U);
+
+		// the entry without a subtitle doesn't hide the response of the game
+		view.ShowGameSubtitle(presenter, "What do you want?");
+		view.callCounts = {};
+		presenter.Show(view, table, kNumEntries - 1);
+		CHECK_EQUAL(view.subtitle, "What do you want?");
+		CHECK_EQUAL(view.callCounts.getSubtitleText, 1U);
+		CHECK_EQUAL(view.callCounts.getEntryText, 1U);
+		presenter.Show(view, table, 0);
+		CHECK_EQUAL(view.subtitle, "Subtitle 0");
+		CHECK_EQUAL(view.callCounts.getEntryText, 1U);
+		CHECK_EQUAL(view.callCounts.createString, 0U);
+		CHECK_EQUAL(view.callCounts.setTextColor, 1U);  // the game restored its colour
+
+		// a kUpdate rebuilds the table, whose entries may have new subtitles
+		FillTable(table);
+		view.callCounts = {};
+		Scroll(presenter, view, table, 2);
+		CHECK_EQUAL(view.callCounts.createString, kNumEntries - 1);
+		CHECK_EQUAL(view.callCounts.getEntryText, kNumEntries - 1);
+	}
+
+	// A kUpdate that only reorders the list rebuilds the table too, so the entries are looked up again at their new positions.
+	void TestReorderedList()
+	{
+		SessionArena arena;
+		TopicDisplayTable table(&arena);
+		FillTable(table);
+		MemorySubtitleView view;
+		for (std::uint32_t i = 0; i < kNumEntries; ++i) {
+			view.entries.push_back(GetTopicText(i));
+		}
+		SubtitlePresenter presenter;
+		Scroll(presenter, view, table, 1);
+
+		std::ranges::reverse(view.entries);
+		FillTable(table);
+		view.callCounts = {};
+		for (std::uint32_t entryIndex = 1; entryIndex < kNumEntries; ++entryIndex) {
+			presenter.Show(view, table, entryIndex);
+			CHECK_EQUAL(view.subtitle, "Subtitle " + std::to_string(kNumEntries - 1 - entryIndex));
+		}
+		CHECK_EQUAL(view.callCounts.getEntryText, kNumEntries - 1);
+	}
+
+	// the predicted response is only looked up for the topics the player highlights, once for each of them
+	void TestDeferredSubtitles()
+	{
+		MemoryEngine engine;
+		const auto topic = engine.AddTopic({ "Topic", { MemoryEngine::TopicInfo{ {}, true, "Fine, I'll tell you." } } });
+		const auto responseInfo = engine.GetInfo(topic, 0);
+		const auto format = std::make_shared<const FormatProgram>("{0}: {4}");
+
+		SessionArena arena;
+		TopicDisplayTable table(&arena);
+		MemorySubtitleView view;
+		view.responseTexts = &engine;
+		for (std::uint32_t i = 0; i < kNumEntries; ++i) {
+			// the main text and the tag of "Topic i (Persuade)"
+			const auto sourceText = "Topic " + std::to_string(i) + " (Persuade)";
+			const auto mainTextLength = static_cast<std::uint32_t>(sourceText.size() - " (Persuade)"sv.size());
+			view.entries.push_back(GetTopicText(i));
+			table.Insert(view.entries.back(), TopicDisplayData{ 0xFFFFFF, 0xA0A0A0, "", Scaleform::DeferredSubtitle{ format, responseInfo, mainTextLength, mainTextLength + 2, 8, std::nullopt, "Success", 0.0F, 15.0F } }, sourceText);
+		}
+		table.Build();
+
+		SubtitlePresenter presenter;
+		for (std::uint32_t pass = 0; pass < 5; ++pass) {
+			presenter.Show(view, table, 2);
+			CHECK_EQUAL(view.subtitle, "Topic 2: Fine, I'll tell you.");
+			presenter.Show(view, table, 3);
+			CHECK_EQUAL(view.subtitle, "Topic 3: Fine, I'll tell you.");
+		}
+		CHECK_EQUAL(view.callCounts.getResponseText, 2U);
+		CHECK_EQUAL(view.callCounts.createString, 2U);
+		CHECK_EQUAL(view.callCounts.setText, 10U);
+	}
+}
+
+int main()
+{
+	TestScrolling();
+	TestReorderedList();
+	TestDeferredSubtitles();
+	return Check::Result();
+}
\ No newline at end of file
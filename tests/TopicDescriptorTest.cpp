@@ -0,0 +1,75 @@
+/*
+Copyright (C) 2025 Jonathan Feenstra
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+See EXCEPTIONS for additional permissions.
+*/
+
+// Checks which Speech conditions DescribeTopic takes for persuasion checks: only the ones that run on the player,
+// depending on the object the condition runs on and whether it swaps the subject and the target.
+
+#include "Check.h"
+#include "MemoryEngine.h"
+#include "TopicDescriptor.h"
+
+namespace
+{
+	using Dialogue::CONDITION_OBJECT;
+	using TopicProcessor::SPEECH_CHECK_TYPE;
+
+	TopicProcessor::TopicDescriptor DescribeSpeechCheck(const CONDITION_OBJECT a_object, const bool a_swapsSubjectAndTarget)
+	{
+		Dialogue::ConditionData speechCheck{};
+		speechCheck.function = Dialogue::CONDITION_FUNCTION::kGetActorValue;
+		speechCheck.opCode = Dialogue::OPCODE::kGreaterThanOrEqualTo;
+		speechCheck.isSpeech = true;
+		speechCheck.object = a_object;
+		speechCheck.swapsSubjectAndTarget = a_swapsSubjectAndTarget;
+		speechCheck.comparisonValue = 50.0F;
+
+		MemoryEngine engine;
+		MemoryEngine::TopicInfo check{ {}, false, "Fine, I'll tell you." };
+		check.conditions.push_back({ speechCheck, false, nullptr });
+		const auto topic = engine.AddTopic({ "Topic", { check, MemoryEngine::TopicInfo{ {}, true, "No." } } });
+		return TopicProcessor::DescribeTopic(engine.GetEngine(), topic);
+	}
+
+	void TestSpeechConditionOnPlayer()
+	{
+		for (const auto& [object, swapsSubjectAndTarget] : { std::pair{ CONDITION_OBJECT::kTarget, false }, std::pair{ CONDITION_OBJECT::kSubject, true }, std::pair{ CONDITION_OBJECT::kPlayer, false } }) {
+			const auto descriptor = DescribeSpeechCheck(object, swapsSubjectAndTarget);
+			CHECK(descriptor.checkType == SPEECH_CHECK_TYPE::kPersuade);
+			CHECK_EQUAL(descriptor.checkInfoIndex, 0U);
+			CHECK_EQUAL(descriptor.fallbackInfoIndex, 1U);
+			CHECK_EQUAL(descriptor.requiredSpeechLevel, 50.0F);
+		}
+	}
+
+	// e.g. a response that only plays if the speaker is eloquent enough, which doesn't depend on the player's speech level
+	void TestSpeechConditionOnSpeaker()
+	{
+		for (const auto& [object, swapsSubjectAndTarget] : { std::pair{ CONDITION_OBJECT::kSubject, false }, std::pair{ CONDITION_OBJECT::kTarget, true }, std::pair{ CONDITION_OBJECT::kOther, false } }) {
+			const auto descriptor = DescribeSpeechCheck(object, swapsSubjectAndTarget);
+			CHECK(descriptor.checkType == SPEECH_CHECK_TYPE::kNone);
+		}
+	}
+}
+
+int main()
+{
+	TestSpeechConditionOnPlayer();
+	TestSpeechConditionOnSpeaker();
+	return Check::Result();
+}
\ No newline at end of file
@@ -0,0 +1,209 @@
+/*
+Copyright (C) 2025 Jonathan Feenstra
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+See EXCEPTIONS for additional permissions.
+*/
+
+// Counts the crossings between the movie and native code of both ways to colour the topic list: calling into the plugin from
+// SetEntryText for every entry the list draws, and colouring the list from the plugin after UpdateList and doSetSelectedIndex.
+// Every call of a function handler crosses twice, into the handler and back into the movie for the original function,
+// and every call through ITopicListView once.
+
+#include "Check.h"
+#include "MemoryTopicListView.h"
+#include "SessionArena.h"
+
+namespace
+{
+	using Scaleform::MemoryTopicListView;
+	using Scaleform::TopicDisplayData;
+	using Scaleform::TopicDisplayTable;
+
+	constexpr std::uint32_t kNumEntries = 20;
+	constexpr std::uint32_t kNumClips = 8;
+	constexpr std::uint32_t kGameColorNew = 0xFFFFFF;
+	constexpr std::uint32_t kGameColorOld = 0x777777;
+
+	std::string GetTopicText(const std::uint32_t a_index)
+	{
+		return "Topic " + std::to_string(a_index);
+	}
+
+	bool IsNew(const std::uint32_t a_index)
+	{
+		return a_index % 2 == 0;
+	}
+
+	TopicDisplayData GetDisplayData(const std::uint32_t a_index)
+	{
+		return { 0x100000 + a_index, 0x200000 + a_index, "", std::nullopt };
+	}
+
+	// BSScrollingList of the dialogue menu, which draws its entries with the colours of the game and calls the hooked functions
+	class TopicList final
+	{
+	public:
+		explicit TopicList(const bool a_batchTopicColors) :
+			batchTopicColors(a_batchTopicColors)
+		{
+			for (std::uint32_t i = 0; i < kNumEntries; ++i) {
+				table.Insert(GetTopicText(i), GetDisplayData(i));
+			}
+			table.Build();
+			view.clips.resize(kNumClips);
+		}
+
+		// the crossings since the last call
+		std::uint32_t TakeCrossings() noexcept
+		{
+			const auto crossings = numHandlerCalls * 2 + view.numCalls;
+			numHandlerCalls = 0;
+			view.numCalls = 0;
+			return crossings;
+		}
+
+		// a kShow or kUpdate fills the list, which calls UpdateList
+		void UpdateList()
+		{
+			if (batchTopicColors) {
+				++numHandlerCalls;
+			}
+			for (std::uint32_t clipIndex = 0; clipIndex < kNumClips; ++clipIndex) {
+				DrawEntry(view.scrollPosition + clipIndex);
+			}
+			if (batchTopicColors) {
+				Scaleform::ColorEntries(view, table);
+			}
+		}
+
+		// doSetSelectedIndex with a controller, which scrolls the list if the new selection is out of view
+		void SetSelectedIndex(const std::int32_t a_index)
+		{
+			std::int32_t previousIndex = -1;
+			if (batchTopicColors) {
+				++numHandlerCalls;
+				previousIndex = view.GetSelectedIndex();
+			}
+
+			auto hasScrolled = false;
+			if (view.selectedIndex != -1) {
+				DrawEntry(static_cast<std::uint32_t>(view.selectedIndex));
+			}
+			view.selectedIndex = a_index;
+			const auto index = static_cast<std::uint32_t>(a_index);
+			if (index < view.scrollPosition || index >= view.scrollPosition + kNumClips) {
+				view.scrollPosition = index < view.scrollPosition ? index : index - kNumClips + 1;
+				UpdateList();
+				hasScrolled = true;
+			} else {
+				DrawEntry(index);
+			}
+
+			if (batchTopicColors && !hasScrolled) {
+				Scaleform::ColorSelection(view, table, previousIndex);
+			}
+		}
+
+		// every visible entry has the colour of the plugin
+		bool HasColors() const
+		{
+			for (std::uint32_t clipIndex = 0; clipIndex < kNumClips; ++clipIndex) {
+				const auto index = view.scrollPosition + clipIndex;
+				const auto displayData = GetDisplayData(index);
+				if (view.clips[clipIndex].color != (IsNew(index) ? displayData.newColor : displayData.oldColor)) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+	private:
+		// SetEntry, which resets the colour to the one of the game
+		void DrawEntry(const std::uint32_t a_index)
+		{
+			if (a_index < view.scrollPosition || a_index >= view.scrollPosition + kNumClips)
+				return;
+
+			const auto clipIndex = a_index - view.scrollPosition;
+			view.clips[clipIndex] = { GetTopicText(a_index), IsNew(a_index), IsNew(a_index) ? kGameColorNew : kGameColorOld };
+			if (!batchTopicColors) {
+				++numHandlerCalls;
+				Scaleform::ColorEntry(view, table, clipIndex);
+			}
+		}
+
+		SessionArena arena;
+		TopicDisplayTable table{ &arena };
+		MemoryTopicListView view;
+		bool batchTopicColors;
+		std::uint32_t numHandlerCalls = 0;
+	};
+
+	struct Crossings final
+	{
+		std::uint32_t redraw;
+		std::uint32_t selectionChange;
+		std::uint32_t scrollingSelectionChange;
+	};
+
+	Crossings CountCrossings(const bool a_batchTopicColors)
+	{
+		TopicList list(a_batchTopicColors);
+		Crossings crossings{};
+
+		list.UpdateList();
+		CHECK(list.HasColors());
+		crossings.redraw = list.TakeCrossings();
+
+		list.SetSelectedIndex(0);
+		list.TakeCrossings();
+		list.SetSelectedIndex(1);
+		CHECK(list.HasColors());
+		crossings.selectionChange = list.TakeCrossings();
+
+		list.SetSelectedIndex(kNumClips);
+		CHECK(list.HasColors());
+		crossings.scrollingSelectionChange = list.TakeCrossings();
+		return crossings;
+	}
+
+	void TestPerEntryColors()
+	{
+		const auto crossings = CountCrossings(false);
+		// SetEntryText for every clip, which reads the text and whether the entry is new, and sets the colour
+		CHECK_EQUAL(crossings.redraw, kNumClips * 5);
+		CHECK_EQUAL(crossings.selectionChange, 2U * 5);
+		// the previous selection is drawn before the list scrolls
+		CHECK_EQUAL(crossings.scrollingSelectionChange, (1 + kNumClips) * 5);
+	}
+
+	void TestBatchedColors()
+	{
+		const auto crossings = CountCrossings(true);
+		// UpdateList, the number of clips, and the text, age and colour of every clip
+		CHECK_EQUAL(crossings.redraw, 2 + 1 + kNumClips * 3);
+		// doSetSelectedIndex, the selected index before and after, and the clip, text, age and colour of both entries
+		CHECK_EQUAL(crossings.selectionChange, 2U + 2 + 2 * 4);
+		CHECK_EQUAL(crossings.scrollingSelectionChange, 2 + 1 + (2 + 1 + kNumClips * 3));
+	}
+}
+
+int main()
+{
+	TestPerEntryColors();
+	TestBatchedColors();
+	return Check::Result();
+}
\ No newline at end of file
@@ -0,0 +1,276 @@
+/*
+Copyright (C) 2025 Jonathan Feenstra
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+See EXCEPTIONS for additional permissions.
+*/
+
+// Replays the dialogue sessions recorded with bRecordSessions through the core library, without the game:
+//
+//   PredictablePersuasionReplay [--iterations <n>] [--chrome-trace <path>] <trace>...
+//
+// Every dialogue list is processed from scratch, as on the first dialogue with the speaker, because the topic cache belongs to
+// the plugin. The settings are the defaults of PredictablePersuasion.ini, so the processed texts only match the recorded ones
+// for sessions that were recorded with the default INI file.
+
+#include "MemoryEngine.h"
+#include "MemoryTopicListView.h"
+#include "Profiler.h"
+#include "SessionArena.h"
+#include "SessionTrace.h"
+#include "Settings.h"
+#include "TopicListColors.h"
+#include "TopicProcessor.h"
+
+#include <iostream>
+
+namespace
+{
+	struct Options final
+	{
+		std::vector<std::filesystem::path> tracePaths;
+		std::uint32_t iterations = 10;
+		std::filesystem::path chromeTracePath;
+	};
+
+	// exact percentiles of the samples, which are few enough to be sorted
+	class Samples final
+	{
+	public:
+		void Add(const std::chrono::steady_clock::duration a_duration) { nanoseconds.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(a_duration).count()); }
+
+		void Print(std::ostream& a_stream, const std::string_view a_name)
+		{
+			if (nanoseconds.empty()) {
+				return;
+			}
+
+			std::ranges::sort(nanoseconds);
+			const auto percentile = [&](const std::size_t a_percent) { return nanoseconds[(nanoseconds.size() - 1) * a_percent / 100] / 1000.0; };
+			a_stream << "  " << a_name << ": " << nanoseconds.size() << " samples, p50 " << percentile(50) << " us, p99 " << percentile(99)
+					 << " us, max " << nanoseconds.back() / 1000.0 << " us\n";
+		}
+
+	private:
+		std::vector<std::int64_t> nanoseconds;
+	};
+
+	std::shared_ptr<const Settings> MakeDefaultSettings()
+	{
+		const auto settings = std::make_shared<Settings>();
+		settings->generation = 1;
+		settings->applyTopicFormatting = true;
+		settings->applyTopicColors = true;
+		settings->batchTopicColors = false;
+		settings->showSubtitles = Settings::SHOW_SUBTITLES::kForAllSpeechChecks;
+		settings->showsPredictedResponse = true;
+		settings->subtitleColor = 0xA3A3A3;
+		settings->successColor = 0x00FF00;
+		settings->failureColorNew = 0xFF0000;
+		settings->failureColorOld = 0x600000;
+		settings->noCheckColorNew = 0xFFFF00;
+		settings->noCheckColorOld = 0x606000;
+		settings->regularColorNew = 0xFFFFFF;
+		settings->regularColorOld = 0x606060;
+		settings->tagPreset = &TagPresets::GetEnglish();
+		settings->profiles[static_cast<std::size_t>(TopicProcessor::SPEECH_CHECK_TYPE::kPersuade)] = { FormatProgram(Settings::kDefaultTopicFormats[static_cast<std::size_t>(TopicProcessor::SPEECH_CHECK_TYPE::kPersuade)]), FormatProgram(Settings::kDefaultSubtitleFormat), "Persuade" };
+		settings->profiles[static_cast<std::size_t>(TopicProcessor::SPEECH_CHECK_TYPE::kIntimidate)] = { FormatProgram(Settings::kDefaultTopicFormats[static_cast<std::size_t>(TopicProcessor::SPEECH_CHECK_TYPE::kIntimidate)]), FormatProgram(Settings::kDefaultSubtitleFormat), "Intimidate" };
+		settings->profiles[static_cast<std::size_t>(TopicProcessor::SPEECH_CHECK_TYPE::kBribe)] = { FormatProgram(Settings::kDefaultTopicFormats[static_cast<std::size_t>(TopicProcessor::SPEECH_CHECK_TYPE::kBribe)]), FormatProgram(Settings::kDefaultSubtitleFormat), "gold" };
+		settings->checkSuccessText = "Success";
+		settings->checkFailureText = "Failure";
+		settings->noCheckText = "No Check";
+		settings->speechCheckEvaluator = Settings::SPEECH_CHECK_EVALUATOR::kEngine;  // the recorded condition results
+		return settings;
+	}
+
+	// the topics of a trace in a MemoryEngine, described up front like the plugin's TopicIndex does after loading
+	class Replayer final
+	{
+	public:
+		Replayer(const SessionTrace::Trace& a_trace, std::shared_ptr<const Settings> a_settings) :
+			settings(std::move(a_settings))
+		{
+			for (const auto& topic : a_trace.topics) {
+				const auto handle = SessionTrace::AddToEngine(memoryEngine, topic);
+				topics.push_back(handle);
+				descriptors.push_back(TopicProcessor::DescribeTopic(memoryEngine.GetEngine(), handle));
+			}
+		}
+
+		// the texts that differ from the recorded ones are only counted if a_checkTexts is set
+		void ReplaySession(const SessionTrace::Session& a_session, const bool a_checkTexts)
+		{
+			const auto engine = memoryEngine.GetEngine();
+			for (const auto& list : a_session.lists) {
+				// the entry clips are filled before the timer starts, in the game the movie already has them
+				listView.clips.clear();
+				for (const auto& entry : list.entries) {
+					listView.clips.push_back({ entry.shownText, list.message == SessionTrace::MESSAGE::kShow, 0xFFFFFF });
+				}
+
+				const auto listStart = std::chrono::steady_clock::now();
+				memoryEngine.SetPlayerSpeechLevel(list.playerSpeechLevel);
+				topicDisplayData.Clear();
+				for (const auto& entry : list.entries) {
+					auto processedTopic = TopicProcessor::ProcessTopic(engine, topics[entry.topicIndex], &descriptors[entry.topicIndex], entry.topicText, *settings);
+					if (processedTopic.displayData) {
+						topicDisplayData.Insert(processedTopic.topicText, *processedTopic.displayData, entry.topicText);
+					}
+					if (a_checkTexts && processedTopic.topicText != entry.shownText) {
+						if (numMismatches++ < 10) {
+							std::cout << "  \"" << entry.topicText << "\" was shown as \"" << entry.shownText << "\", but replayed as \"" << processedTopic.topicText << "\"\n";
+						}
+					}
+				}
+				topicDisplayData.Build();
+				if (settings->applyTopicColors && settings->batchTopicColors) {
+					Scaleform::ColorEntries(listView, topicDisplayData);
+				} else if (settings->applyTopicColors) {
+					// like SetEntryText, which the list calls for every clip it draws
+					for (std::uint32_t clipIndex = 0; clipIndex < listView.clips.size(); ++clipIndex) {
+						Scaleform::ColorEntry(listView, topicDisplayData, clipIndex);
+					}
+				}
+				listSamples.Add(std::chrono::steady_clock::now() - listStart);
+				numEntries += list.entries.size();
+
+				for (const auto& selection : list.selections) {
+					const auto selectionStart = std::chrono::steady_clock::now();
+					if (const auto displayData = topicDisplayData.Find(selection)) {
+						if (const auto responseInfo = topicDisplayData.GetUnresolvedResponseInfo(*displayData)) {
+							topicDisplayData.ResolveSubtitle(*displayData, engine.responseTexts.GetResponseText(responseInfo));
+						}
+						static_cast<void>(topicDisplayData.GetSubtitle(*displayData));
+					}
+					selectionSamples.Add(std::chrono::steady_clock::now() - selectionStart);
+				}
+			}
+
+			topicDisplayData.Release();
+			sessionArena.Reset();
+		}
+
+		void Print(std::ostream& a_stream)
+		{
+			a_stream << "  " << numEntries << " entries processed";
+			if (numMismatches > 0) {
+				a_stream << ", " << numMismatches << " of them differ from the recorded text (expected if the INI file wasn't the default)";
+			}
+			a_stream << '\n';
+			listSamples.Print(a_stream, "dialogue lists");
+			selectionSamples.Print(a_stream, "selections");
+		}
+
+	private:
+		std::shared_ptr<const Settings> settings;
+		MemoryEngine memoryEngine;
+		std::vector<Dialogue::TopicHandle> topics;
+		std::vector<TopicProcessor::TopicDescriptor> descriptors;
+
+		SessionArena sessionArena;
+		Scaleform::TopicDisplayTable topicDisplayData{ &sessionArena };
+		Scaleform::MemoryTopicListView listView;
+
+		Samples listSamples;
+		Samples selectionSamples;
+		std::uint64_t numEntries = 0;
+		std::uint64_t numMismatches = 0;
+	};
+
+	bool ParseOptions(const int a_argc, char* a_argv[], Options& a_options)
+	{
+		for (int i = 1; i < a_argc; ++i) {
+			const std::string_view argument(a_argv[i]);
+			if (argument == "--iterations" && i + 1 < a_argc) {
+				const std::string_view value(a_argv[++i]);
+				if (std::from_chars(value.data(), value.data() + value.size(), a_options.iterations).ec != std::errc{} || a_options.iterations == 0) {
+					return false;
+				}
+			} else if (argument == "--chrome-trace" && i + 1 < a_argc) {
+				a_options.chromeTracePath = a_argv[++i];
+			} else if (argument.starts_with("--")) {
+				return false;
+			} else {
+				a_options.tracePaths.emplace_back(argument);
+			}
+		}
+		return !a_options.tracePaths.empty();
+	}
+
+	void PrintProfile()
+	{
+#ifdef PP_ENABLE_PROFILING
+		for (std::size_t stage = 0; stage < static_cast<std::size_t>(Profiler::STAGE::kTotal); ++stage) {
+			const auto percentiles = Profiler::GetSessionPercentiles(static_cast<Profiler::STAGE>(stage));
+			if (percentiles.count > 0) {
+				std::cout << "  " << Profiler::GetStageName(static_cast<Profiler::STAGE>(stage)) << ": " << percentiles.count << " calls, p50 "
+						  << percentiles.p50Nanoseconds / 1000.0 << " us, p99 " << percentiles.p99Nanoseconds / 1000.0 << " us, max "
+						  << percentiles.maxNanoseconds / 1000.0 << " us\n";
+			}
+		}
+		Profiler::ResetSession();
+#endif
+	}
+}
+
+int main(int a_argc, char* a_argv[])
+{
+	Options options;
+	if (!ParseOptions(a_argc, a_argv, options)) {
+		std::cerr << "Usage: " << (a_argc > 0 ? a_argv[0] : "PredictablePersuasionReplay") << " [--iterations <n>] [--chrome-trace <path>] <trace>...\n";
+		return 2;
+	}
+
+	if (!options.chromeTracePath.empty()) {
+#ifdef PP_ENABLE_PROFILING
+		if (!Profiler::Start(options.chromeTracePath)) {
+			std::cerr << "Failed to open " << options.chromeTracePath.string() << '\n';
+			return 1;
+		}
+#else
+		std::cerr << "--chrome-trace needs a build with the ENABLE_PROFILING CMake option\n";
+		return 2;
+#endif
+	}
+
+	const auto settings = MakeDefaultSettings();
+	auto result = 0;
+	for (const auto& tracePath : options.tracePaths) {
+		SessionTrace::Trace trace;
+		if (!trace.Load(tracePath)) {
+			std::cerr << tracePath.string() << " is not a session trace of this version\n";
+			result = 1;
+			continue;
+		}
+
+		std::cout << tracePath.string() << ": " << trace.sessions.size() << " sessions with " << trace.topics.size() << " distinct topics";
+		if (trace.isTruncated) {
+			std::cout << " (the end of the file is cut off)";
+		}
+		std::cout << '\n';
+
+		Replayer replayer(trace, settings);
+		for (std::uint32_t iteration = 0; iteration < options.iterations; ++iteration) {
+			for (const auto& session : trace.sessions) {
+				replayer.ReplaySession(session, iteration == 0);
+			}
+		}
+		replayer.Print(std::cout);
+		PrintProfile();
+	}
+
+	Profiler::Stop();
+	return result;
+}
\ No newline at end of file